@@ -5,15 +5,17 @@
 #include <fstream>
 #include <functional>
 #include <iterator>
+#include <mutex>
 #include <nlohmann/json.hpp>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "audio/audio.h"
 #include "constants/codes.h"
 #include "spdlog/spdlog.h"
+#include "utils/logger.h"
 #include "utils/utils.h"
 
-#define LOGGER "logger"
 
 
 std::atomic<bool> pause_audio(false);
@@ -31,7 +33,7 @@ AudioData& Audio::analysed_data() {
   return analysed_data_;
 }
 
-std::map<std::string, std::vector<std::string>> Audio::keys() {
+const std::map<std::string, std::vector<std::string>>& Audio::keys() {
   return keys_;
 }
 
@@ -41,7 +43,7 @@ void Audio::set_source_path(std::string source_path) {
 }
 
 void Audio::Analyze() {
-  spdlog::get(LOGGER)->debug("Audio::Analyze: starting analyses. Starting audi-data extraction");
+  LOG_DEBUG(LOG_AUDIO, "Audio::Analyze: starting analyses. Starting audi-data extraction");
 
   // Load or analyse data.
   std::string out_path = GetOutPath(source_path_);
@@ -51,7 +53,7 @@ void Audio::Analyze() {
     analysed_data_ = AnalyzeFile(source_path_);
   }
 
-  spdlog::get(LOGGER)->info("Analyzing max peak");
+  LOG_INFO(LOG_AUDIO, "Analyzing max peak");
   int max = 0;
   for (const auto& it : analysed_data_.data_per_beat_) {
     int new_max = it.level_- analysed_data_.average_level_;
@@ -59,7 +61,7 @@ void Audio::Analyze() {
       max = new_max;
   }
   analysed_data_.max_peak_ = max;
-  spdlog::get(LOGGER)->info("Done");
+  LOG_INFO(LOG_AUDIO, "Done");
 
   // Create analysed_data.
   // Add information on keys
@@ -67,7 +69,7 @@ void Audio::Analyze() {
 }
 
 AudioData Audio::AnalyzeFile(std::string source_path) {
-  spdlog::get(LOGGER)->debug("Audio::AnalyzeFile: starting analyses of {}", source_path); 
+  LOG_DEBUG(LOG_AUDIO, "Audio::AnalyzeFile: starting analyses of {}", source_path); 
   std::list<AudioDataTimePoint> data_per_beat;
   uint_t samplerate = 0;
   uint_t win_size = 1024; // window size
@@ -78,7 +80,7 @@ AudioData Audio::AnalyzeFile(std::string source_path) {
   aubio_source_t * source = new_aubio_source(source_path.c_str(), samplerate, hop_size);
   if (!source) { 
     aubio_cleanup();
-    throw "Could not load audio-source";
+    throw std::runtime_error("Could not load audio-source: " + source_path);
   }
   // Update samplerate.
   samplerate = aubio_source_get_samplerate(source);
@@ -134,7 +136,7 @@ AudioData Audio::AnalyzeFile(std::string source_path) {
   del_aubio_source(source);
   aubio_cleanup();
 
-  spdlog::get(LOGGER)->debug("Audio::Analyze: got all data. Analyzing extracted data.");
+  LOG_DEBUG(LOG_AUDIO, "Audio::Analyze: got all data. Analyzing extracted data.");
 
   average_bpm /= data_per_beat.size();
   average_level /= data_per_beat.size();
@@ -173,13 +175,13 @@ AudioData Audio::Load(std::string source_path) {
 }
 
 void Audio::play() {
-  spdlog::get(LOGGER)->debug("Audio::play");
+  LOG_DEBUG(LOG_AUDIO, "Audio::play");
   ma_result result;
   ma_device_config deviceConfig;
 
   result = ma_decoder_init_file(source_path_.c_str(), NULL, &decoder_);
   if (result != MA_SUCCESS) {
-    spdlog::get(LOGGER)->debug("Audio::play: Failed to load audio");
+    LOG_DEBUG(LOG_AUDIO, "Audio::play: Failed to load audio");
     return;
   }
 
@@ -191,13 +193,13 @@ void Audio::play() {
   deviceConfig.pUserData         = &decoder_;
 
   if (ma_device_init(NULL, &deviceConfig, &device_) != MA_SUCCESS) {
-    spdlog::get(LOGGER)->debug("Audio::play: Failed to open playback device.");
+    LOG_DEBUG(LOG_AUDIO, "Audio::play: Failed to open playback device.");
     ma_decoder_uninit(&decoder_);
     return;
   }
 
   if (ma_device_start(&device_) != MA_SUCCESS) {
-    spdlog::get(LOGGER)->debug("Audio::play: Failed to start playback device.");
+    LOG_DEBUG(LOG_AUDIO, "Audio::play: Failed to start playback device.");
     ma_device_uninit(&device_);
     ma_decoder_uninit(&decoder_);
     return;
@@ -238,7 +240,13 @@ Note Audio::ConvertMidiToNote(int midi_note) {
 }
 
 void Audio::Initialize() {
-  spdlog::get(LOGGER)->debug("Audio::CreateKeys");
+  // Keys are only written once, afterwards all threads may read them without locking.
+  static std::once_flag initialized;
+  std::call_once(initialized, CreateKeys);
+}
+
+void Audio::CreateKeys() {
+  LOG_DEBUG(LOG_AUDIO, "Audio::CreateKeys");
   std::map<std::string, std::vector<std::string>> keys;
   for (size_t i=0; i<note_names_.size(); i++) {
     // Construct minor keys:
@@ -256,7 +264,7 @@ void Audio::Initialize() {
 }
 
 void Audio::CreateLevels(int intervals) {
-  spdlog::get(LOGGER)->debug("Audio::CreateLevels");
+  LOG_DEBUG(LOG_AUDIO, "Audio::CreateLevels");
   // 1. Sort notes by frequency:
   std::map<std::string, int> notes_by_frequency;
   long unsigned int counter = 0;
@@ -282,7 +290,7 @@ void Audio::CreateLevels(int intervals) {
 }
 
 void Audio::CalcLevel(size_t interval, std::map<std::string, int> notes_by_frequency, size_t darkness) {
-  spdlog::get(LOGGER)->debug("Audio::CalcLevel");
+  LOG_DEBUG(LOG_AUDIO, "Audio::CalcLevel");
   std::list<std::pair<int, std::string>> sorted_notes_by_frequency;
   // Transfor to ordered list
   for (const auto& it : notes_by_frequency)
@@ -320,7 +328,7 @@ void Audio::CalcLevel(size_t interval, std::map<std::string, int> notes_by_frequ
       Signitue::UNSIGNED, key.find("Major") != std::string::npos, notes_in_key, 
       sorted_notes_by_frequency.size()-notes_in_key, darkness}
     );
-  spdlog::get(LOGGER)->debug("Created level with darkness: {}, now: {}", darkness, 
+  LOG_DEBUG(LOG_AUDIO, "Created level with darkness: {}, now: {}", darkness, 
       analysed_data_.intervals_[interval].darkness_);
   if (key.find("#") != std::string::npos)
     analysed_data_.intervals_[interval].signature_ = Signitue::SHARP;
@@ -329,17 +337,17 @@ void Audio::CalcLevel(size_t interval, std::map<std::string, int> notes_by_frequ
 }
 
 bool Audio::MoreOffNotes(const AudioDataTimePoint &data_at_beat, bool off) const {
-  spdlog::get(LOGGER)->debug("Audio::MoreOffNotes");
+  LOG_DEBUG(LOG_AUDIO, "Audio::MoreOffNotes");
   if (analysed_data_.intervals_.count(data_at_beat.interval_) == 0) {
-    spdlog::get(LOGGER)->error("Audio::MoreOffNotes: interval not in intervals! {}", data_at_beat.interval_);
+    LOG_ERROR(LOG_AUDIO, "Audio::MoreOffNotes: interval not in intervals! {}", data_at_beat.interval_);
     return false;
   }
   std::string cur_key = analysed_data_.intervals_.at(data_at_beat.interval_).key_;
   if (keys_.count(cur_key) == 0) {
-    spdlog::get(LOGGER)->error("Audio::MoreOffNotes: key not in keys! {}", cur_key);
+    LOG_ERROR(LOG_AUDIO, "Audio::MoreOffNotes: key not in keys! {}", cur_key);
     return false;
   }
-  auto notes_in_cur_key = keys_.at(cur_key);
+  const auto& notes_in_cur_key = keys_.at(cur_key);
   size_t off_notes_counter = 0;
   for (const auto& note : data_at_beat.notes_) {
     if (off) {
@@ -351,12 +359,12 @@ bool Audio::MoreOffNotes(const AudioDataTimePoint &data_at_beat, bool off) const
         off_notes_counter++;
     }
   }
-  spdlog::get(LOGGER)->info("Audio::MoreOffNotes: done");
+  LOG_INFO(LOG_AUDIO, "Audio::MoreOffNotes: done");
   return off_notes_counter == data_at_beat.notes_.size() && off_notes_counter > 0;
 }
 
 size_t Audio::NextOfNotesIn(double cur_time) const {
-  spdlog::get(LOGGER)->debug("Audio::NextOfNotesIn");
+  LOG_DEBUG(LOG_AUDIO, "Audio::NextOfNotesIn");
   size_t counter = 1;
   for (const auto& it : analysed_data_.data_per_beat_) {
     if (it.time_ <= cur_time) 
@@ -365,7 +373,7 @@ size_t Audio::NextOfNotesIn(double cur_time) const {
       break;
     counter++;
   }
-  spdlog::get(LOGGER)->info("Audio::NextOfNotesIn: done");
+  LOG_INFO(LOG_AUDIO, "Audio::NextOfNotesIn: done");
   return counter;
 }
 
@@ -374,7 +382,7 @@ std::string Audio::GetOutPath(std::filesystem::path source_path) {
   std::hash<std::string> hasher;
   size_t hash = hasher(source_path);
   std::string out_path = base_path_ + "/data/analysis/" + std::to_string(hash) + source_path.filename().string();
-  spdlog::get(LOGGER)->info("Audio::GetOutPath: got out_path: {}", out_path);
+  LOG_INFO(LOG_AUDIO, "Audio::GetOutPath: got out_path: {}", out_path);
   return out_path;
 }
 
@@ -56,7 +56,7 @@ class Audio {
     
     // getter
     AudioData& analysed_data();
-    static std::map<std::string, std::vector<std::string>> keys();
+    static const std::map<std::string, std::vector<std::string>>& keys();
 
     
     // setter 
@@ -75,6 +75,9 @@ class Audio {
 
     static std::vector<unsigned short> GetInterval(std::vector<Note> notes);
 
+    /**
+     * Creates keys (thread-safe, only first call has an effect).
+     */
     static void Initialize();
 
 
@@ -91,6 +94,7 @@ class Audio {
     // methods:
     static void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount);
     static Note ConvertMidiToNote(int midi_note);
+    static void CreateKeys();
 
     void CreateLevels(int intervals);
     void CalcLevel(size_t quater, std::map<std::string, int> notes_by_frequency, size_t darkness);
@@ -9,6 +9,10 @@
 #define SYMBOL_DEF "\u03A6"  // greek uppercase 'phi'
 #define SYMBOL_BARACK "\u039E" // greek uppercase 'xi'
 
+#define NUM_UNITS_TECH 17  ///< number of entries in UnitsTech (activated neuron..nucleus range).
+#define NUM_NEURON_TYPES 4  ///< number of neurons in UnitsTech (activated neuron..resource-neuron).
+#define NUM_RESOURCES 7  ///< number of entries in Resources (iron..serotonin).
+
 #define SYMBOL_IRON "\u03B6" // greek lowercase 'zeta' (from chemical symbol [F]e)
 #define SYMBOL_OXYGEN "\u03BF" // greek lowercase 'omicron'
 #define SYMBOL_POTASSIUM "\u03BA" // greek lowercase 'kappa' 
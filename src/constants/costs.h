@@ -1,170 +1,90 @@
 #ifndef SRC_COSTS_H
 #define SRC_COSTS_H
 
-#include <map>
+#include <array>
+#include <stdexcept>
+#include <string>
 #include "codes.h"
 
 namespace costs {
-  typedef const std::map<int, double> Costs;
+  typedef std::array<double, NUM_RESOURCES> Costs;  ///< costs indexed by Resources.
 
-  const std::map<int, Costs> units_costs_ = {
-    {UnitsTech::NUCLEUS, {
-        {Resources::IRON, 1},
-        {Resources::OXYGEN, 30},
-        {Resources::POTASSIUM, 30}, 
-        {Resources::CHLORIDE, 30}, 
-        {Resources::GLUTAMATE, 30}, 
-        {Resources::DOPAMINE, 30}, 
-        {Resources::SEROTONIN, 30}
-      }
-    },
-    {UnitsTech::ACTIVATEDNEURON, {
-        {Resources::OXYGEN, 8.9}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 19.1}, 
-        {Resources::DOPAMINE, 0}, 
-        {Resources::SEROTONIN, 0}
-      }
-    },
-    {UnitsTech::SYNAPSE, {
-        {Resources::OXYGEN, 13.4}, 
-        {Resources::POTASSIUM, 6.6}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 0}, 
-        {Resources::SEROTONIN, 0}
-      }
-    },
-    {UnitsTech::EPSP, {
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 4.4}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 0}, 
-        {Resources::SEROTONIN, 0}
-      }
-    },
-    {UnitsTech::IPSP, {
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 3.4}, 
-        {Resources::CHLORIDE, 6.8}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 0}, 
-        {Resources::SEROTONIN, 0}
-      }
-    },
-    {UnitsTech::WAY, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 17.7}, 
-        {Resources::SEROTONIN, 0}
-      }
-    },
-    {UnitsTech::SWARM, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 19.9}, 
-        {Resources::SEROTONIN, 0}
-      }
-    },
-    {UnitsTech::TARGET, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 16.5}, 
-        {Resources::SEROTONIN, 0}
-      }
-    },
-    {UnitsTech::TOTAL_RESOURCE, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 18.5}, 
-        {Resources::SEROTONIN, 17.9}
-      }
-    },
-    {UnitsTech::CURVE, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 21.0}, 
-        {Resources::SEROTONIN, 21.2}
-      }
-    },
-    {UnitsTech::ATK_POTENIAL, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 10}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 16.0}, 
-        {Resources::SEROTONIN, 11.2}
-      }
-    },
-    {UnitsTech::ATK_SPEED, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 10}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 19.0}, 
-        {Resources::SEROTONIN, 13.2}
-      }
-    },
-    {UnitsTech::ATK_DURATION, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 10}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 17.5}, 
-        {Resources::SEROTONIN, 12.2}
-      }
-    },
-    {UnitsTech::DEF_SPEED, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 15.8}, 
-        {Resources::DOPAMINE, 16.5}, 
-        {Resources::SEROTONIN, 6.6}
-      }
-    },
-    {UnitsTech::DEF_POTENTIAL, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 0}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 15.9}, 
-        {Resources::DOPAMINE, 14.5}, 
-        {Resources::SEROTONIN, 17.6}
-      }
-    },
-    {UnitsTech::NUCLEUS_RANGE, {
-        {Resources::IRON, 1}, 
-        {Resources::OXYGEN, 10}, 
-        {Resources::POTASSIUM, 0}, 
-        {Resources::CHLORIDE, 0}, 
-        {Resources::GLUTAMATE, 0}, 
-        {Resources::DOPAMINE, 13.5}, 
-        {Resources::SEROTONIN, 17.9}
-      }
-    }
-  };
+  /**
+   * Costs of all units and technologies (indexed by UnitsTech, then by
+   * Resources). Technologies cost these amounts multiplied by the level to
+   * reach.
+   */
+  constexpr std::array<Costs, NUM_UNITS_TECH> units_costs_ = {{
+    //  iron  oxygen potassium chloride glutamate dopamine serotonin
+    {{  0,    8.9,   0,        0,       19.1,     0,       0    }},  // ACTIVATEDNEURON
+    {{  0,    13.4,  6.6,      0,       0,        0,       0    }},  // SYNAPSE
+    {{  1,    30,    30,       30,      30,       30,      30   }},  // NUCLEUS
+    {{  0,    0,     0,        0,       0,        0,       0    }},  // RESOURCENEURON (free)
+    {{  0,    0,     4.4,      0,       0,        0,       0    }},  // EPSP
+    {{  0,    0,     3.4,      6.8,     0,        0,       0    }},  // IPSP
+    {{  1,    0,     0,        0,       0,        17.7,    0    }},  // WAY
+    {{  1,    0,     0,        0,       0,        19.9,    0    }},  // SWARM
+    {{  1,    0,     0,        0,       0,        16.5,    0    }},  // TARGET
+    {{  1,    0,     0,        0,       0,        18.5,    17.9 }},  // TOTAL_RESOURCE
+    {{  1,    0,     0,        0,       0,        21.0,    21.2 }},  // CURVE
+    {{  1,    0,     10,       0,       0,        16.0,    11.2 }},  // ATK_POTENIAL
+    {{  1,    0,     10,       0,       0,        19.0,    13.2 }},  // ATK_SPEED
+    {{  1,    0,     10,       0,       0,        17.5,    12.2 }},  // ATK_DURATION
+    {{  1,    0,     0,        0,       15.9,     14.5,    17.6 }},  // DEF_POTENTIAL
+    {{  1,    0,     0,        0,       15.8,     16.5,    6.6  }},  // DEF_SPEED
+    {{  1,    10,    0,        0,       0,        13.5,    17.9 }},  // NUCLEUS_RANGE
+  }};
+
+  /**
+   * Gets costs of unit or technology known at compile time.
+   * @tparam unit
+   * @return costs indexed by Resources.
+   */
+  template<int unit>
+  constexpr const Costs& CostsOf() {
+    static_assert(unit >= 0 && unit < NUM_UNITS_TECH, "not a unit or technology");
+    return units_costs_[unit];
+  }
+
+  /**
+   * Gets costs of one resource for unit or technology known at compile time.
+   * @tparam unit
+   * @tparam resource
+   * @return costs.
+   */
+  template<int unit, int resource>
+  constexpr double Cost() {
+    static_assert(resource >= 0 && resource < NUM_RESOURCES, "not a resource");
+    return CostsOf<unit>()[resource];
+  }
+
+  /**
+   * Gets costs of unit or technology.
+   * @param[in] unit
+   * @return costs indexed by Resources.
+   * @throws std::out_of_range if not a unit or technology.
+   */
+  inline const Costs& CostsOf(int unit) {
+    if (unit < 0 || unit >= NUM_UNITS_TECH)
+      throw std::out_of_range("costs::CostsOf: not a unit or technology: " + std::to_string(unit));
+    return units_costs_[unit];
+  }
+
+  /**
+   * Checks whether unit or technology is free (costs nothing or has no costs).
+   * @param[in] unit
+   */
+  constexpr bool IsFree(int unit) {
+    if (unit < 0 || unit >= NUM_UNITS_TECH)
+      return true;
+    for (double cost : units_costs_[unit])
+      if (cost != 0)
+        return false;
+    return true;
+  }
+
+  static_assert(IsFree(UnitsTech::RESOURCENEURON), "resource-neurons are free");
+  static_assert(Cost<UnitsTech::IPSP, Resources::CHLORIDE>() == 6.8, "costs indexed by unit, then resource");
 }
 
 #endif
@@ -1,14 +1,15 @@
+#include <algorithm>
 #include <cctype>
 #include <cmath>
 #include <cstddef>
 #include <cstdlib>
-#include <curses.h>
 #include <exception>
 #include <iostream>
 #include <locale>
 #include <mutex>
 #include <shared_mutex>
 #include <stdexcept>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -18,6 +19,7 @@
 #include "player/player.h"
 #include "random/random.h"
 #include "spdlog/spdlog.h"
+#include "utils/logger.h"
 #include "utils/utils.h"
 #include "constants/codes.h"
 
@@ -29,19 +31,24 @@
 #define COLOR_HIGHLIGHT 6 
 
 #define SECTIONS 8
+#define PATH_CACHE_SIZE 512
+#define MAX_FLOW_FIELDS 16
+#define MIN_CELLS_HIERARCHICAL_PATHFINDING 40000
+#define MAX_CLUSTER_SIZE 32
 
 
-Field::Field(int lines, int cols, RandomGenerator* ran_gen, int left_border) {
-  lines_ = lines;
-  cols_ = cols;
-  ran_gen_ = ran_gen;
-  left_border_ = left_border;
+Field::Field(int lines, int cols, RandomGenerator* ran_gen, int left_border) 
+  : left_border_(left_border), lines_(lines), cols_(cols), ran_gen_(ran_gen), graph_(lines, cols), pathfinder_(&graph_), path_cache_(PATH_CACHE_SIZE), 
+  map_version_(0), flow_fields_version_(0), graph_built_(false), 
+  free_cells_(CreateFreeCells()), components_(lines*cols), components_valid_(false) {
 
   // initialize empty field.
   for (int l=0; l<=lines_; l++) {
     field_.push_back({});
-    for (int c=0; c<=cols_; c++)
+    for (int c=0; c<=cols_; c++) {
       field_[l].push_back(SYMBOL_FREE);
+      free_cells_.Add({l, c});
+    }
   }
 
   highlight_ = {};
@@ -58,6 +65,9 @@ int Field::cols() {
 std::vector<position_t> Field::highlight() {
   return highlight_;
 }
+const PathCache& Field::path_cache() const {
+  return path_cache_;
+}
 
 // setter:
 void Field::set_highlight(std::vector<position_t> positions) {
@@ -79,133 +89,226 @@ void Field::AddBlink(position_t blink_pos) {
 }
 
 position_t Field::AddNucleus(int section) {
-  spdlog::get(LOGGER)->debug("Field::AddNucleus");
-  auto positions_in_section = GetAllPositionsOfSection(section);
-  position_t pos = positions_in_section[ran_gen_->RandomInt(0, positions_in_section.size())];
-  field_[pos.first][pos.second] = SYMBOL_DEN;
+  LOG_DEBUG(LOG_FIELD, "Field::AddNucleus");
+  position_t pos = free_cells_.RandomInSection(section, ran_gen_);
+  // If section has no free position, use any position of section.
+  if (pos.first == -1) {
+    int l = (section-1)%(SECTIONS/2)*(cols_/4);
+    int c = (section < (SECTIONS/2)+1) ? 0 : lines_/2;
+    int i = ran_gen_->RandomInt(0, std::max(cols_/4*(lines_/2)-1, 0));
+    pos = {c + i%std::max(lines_/2, 1), l + i/std::max(lines_/2, 1)};
+    // Keep off map border, so nucleus is surrounded by free positions.
+    pos = {std::clamp(pos.first, 1, std::max(lines_-2, 1)), std::clamp(pos.second, 1, std::max(cols_-2, 1))};
+  }
+  SetSymbol(pos, SYMBOL_DEN);
   // Mark positions surrounding nucleus as free:
-  for (const auto& it : GetAllInRange(pos, 1.5, 1))
-    field_[it.first][it.second] = SYMBOL_FREE;
-  spdlog::get(LOGGER)->debug("Field::AddNucleus: done");
+  ForEachInRange(pos, 1.5, 1, false, [&](position_t it) { SetSymbol(it, SYMBOL_FREE); });
+  LOG_DEBUG(LOG_FIELD, "Field::AddNucleus: done");
   return pos;
 }
 
+std::pair<position_t, position_t> Field::AddNuclei(int section_1, int section_2) {
+  LOG_DEBUG(LOG_FIELD, "Field::AddNuclei: sections {} and {}", section_1, section_2);
+  if (!components_valid_)
+    BuildComponents();
+  // Get components with free positions in second section.
+  std::set<uint32_t> components_2;
+  free_cells_.ForEachInSection(section_2, [&](position_t pos) { 
+      if (Passable(pos))
+        components_2.insert(components_.Find(graph_.Index(pos)));
+    });
+  // Select random position of first section in one of these components.
+  std::vector<position_t> candidates;
+  free_cells_.ForEachInSection(section_1, [&](position_t pos) {
+      if (Passable(pos) && components_2.count(components_.Find(graph_.Index(pos))) > 0)
+        candidates.push_back(pos);
+    });
+  if (candidates.size() == 0) {
+    LOG_INFO(LOG_FIELD, "Field::AddNuclei: sections not connected, clearing way.");
+    position_t pos_1 = AddNucleus(section_1);
+    position_t pos_2 = AddNucleus(section_2);
+    ClearWay(pos_1, pos_2);
+    return {pos_1, pos_2};
+  }
+  position_t pos_1 = candidates[ran_gen_->RandomInt(0, candidates.size()-1)];
+  SetSymbol(pos_1, SYMBOL_DEN);
+  ForEachInRange(pos_1, 1.5, 1, false, [&](position_t it) { SetSymbol(it, SYMBOL_FREE); });
+  // Select random position of second section in same component.
+  candidates.clear();
+  free_cells_.ForEachInSection(section_2, [&](position_t pos) {
+      if (Connected(pos, pos_1))
+        candidates.push_back(pos);
+    });
+  position_t pos_2 = {-1, -1};
+  if (candidates.size() > 0) {
+    pos_2 = candidates[ran_gen_->RandomInt(0, candidates.size()-1)];
+    SetSymbol(pos_2, SYMBOL_DEN);
+    ForEachInRange(pos_2, 1.5, 1, false, [&](position_t it) { SetSymbol(it, SYMBOL_FREE); });
+  }
+  else {
+    pos_2 = AddNucleus(section_2);
+    ClearWay(pos_1, pos_2);
+  }
+  LOG_DEBUG(LOG_FIELD, "Field::AddNuclei: done");
+  return {pos_1, pos_2};
+}
+
 std::map<int, position_t> Field::AddResources(position_t start_pos) {
-  spdlog::get(LOGGER)->debug("Field::AddResources");
+  LOG_DEBUG(LOG_FIELD, "Field::AddResources");
   std::map<int, position_t> resource_positions;
   for (const auto& it : resources_symbol_mapping) {
-    spdlog::get(LOGGER)->debug("Field::AddResources: resource {} first try getting positions", it.first);
-    std::vector<position_t> positions = GetAllInRange(start_pos, 4, 2, true);
-    if (positions.size() == 0) {
-      spdlog::get(LOGGER)->debug("Field::AddResources: resource {} 2. try getting positions", it.first);
-      positions = GetAllInRange(start_pos, 5, 3, true);
+    LOG_DEBUG(LOG_FIELD, "Field::AddResources: resource {} first try getting positions", it.first);
+    position_t pos = (graph_built_) ? free_cells_.RandomInRange(start_pos, 2, 4, ran_gen_) : position_t{-1, -1};
+    if (pos.first == -1 && graph_built_) {
+      LOG_DEBUG(LOG_FIELD, "Field::AddResources: resource {} 2. try getting positions", it.first);
+      pos = free_cells_.RandomInRange(start_pos, 3, 5, ran_gen_);
+    }
+    if (pos.first == -1) {
+      LOG_ERROR(LOG_FIELD, "Field::AddResources: no free position for resource {}", it.first);
+      continue;
     }
-    position_t pos = positions[ran_gen_->RandomInt(0, positions.size()-1)];
-    spdlog::get(LOGGER)->debug("Field::AddResources: got position {}", utils::PositionToString(pos));
-    field_[pos.first][pos.second] = it.first;
+    LOG_DEBUG(LOG_FIELD, "Field::AddResources: got position {}", utils::PositionToString(pos));
+    SetSymbol(pos, it.first);
     resource_positions[it.second] = pos;
   }
-  spdlog::get(LOGGER)->debug("Field::AddResources: done");
+  LOG_DEBUG(LOG_FIELD, "Field::AddResources: done");
   return resource_positions;
 }
 
 void Field::BuildGraph(position_t player_den, position_t enemy_den) {
-  // Add all nodes.
+  if (!Connected(player_den, enemy_den))
+    throw std::logic_error("Invalid world.");
+  // Add all nodes connected to player den (edges to all neighbors are implicit).
+  uint32_t component = components_.Find(graph_.Index(player_den));
   for (int l=0; l<lines_; l++) {
     for (int c=0; c<cols_; c++) {
-      if (field_[l][c] != SYMBOL_HILL)
+      if (Passable({l, c}) && components_.Find(graph_.Index({l, c})) == component)
         graph_.AddNode(l, c);
     }
   }
 
-  // For each node, add edges.
-  for (auto node : graph_.nodes()) {
-    std::vector<position_t> neighbors = GetAllInRange({node.second->line_, node.second->col_}, 1.5, 1);
-    for (const auto& pos : neighbors) {
-      if (InField(pos) && field_[pos.first][pos.second] != SYMBOL_HILL && graph_.InGraph(pos))
-      graph_.AddEdge(node.second, graph_.nodes().at(pos));
-    }
-  }
-
-  // Remove all nodes not in main circle
-  graph_.RemoveInvalid(player_den);
-  if (graph_.nodes().count(enemy_den) == 0)
-    throw std::logic_error("Invalid world.");
+  if (lines_*cols_ >= MIN_CELLS_HIERARCHICAL_PATHFINDING)
+    hierarchical_pathfinder_ = std::make_unique<HierarchicalPathfinder>(&graph_, 
+        HierarchicalPathfinder::Borders(lines_, 2, MAX_CLUSTER_SIZE), 
+        HierarchicalPathfinder::Borders(cols_, SECTIONS/2, MAX_CLUSTER_SIZE));
+  map_version_++;
+  // From now on, only positions in graph are free.
+  graph_built_ = true;
+  for (int l=0; l<=lines_; l++)
+    for (int c=0; c<=cols_; c++)
+      if (!graph_.InGraph({l, c}))
+        free_cells_.Remove({l, c});
 }
 
 void Field::AddHills(RandomGenerator* gen_1, RandomGenerator* gen_2, unsigned short denceness) {
-  spdlog::get(LOGGER)->debug("Field::AddHills: denceness={}", denceness);
+  LOG_DEBUG(LOG_FIELD, "Field::AddHills: denceness={}", denceness);
 
   for (int l=0; l<lines_; l++) {
     for (int c=0; c<cols_; c++) {
       if (gen_1->RandomInt(0, 1) == 1) {
-        spdlog::get(LOGGER)->info("Creating muntain");
-        field_[l][c] = SYMBOL_HILL;
+        SetSymbol({l, c}, SYMBOL_HILL);
         int level = gen_2->RandomInt(0, 5)-999;
         if (level < 1)
           continue;
-        spdlog::get(LOGGER)->info("Creating {} hills", level);
-        auto positions = GetAllInRange({l, c}, level - denceness, 1);
-        for (const auto& pos : positions)
-          field_[pos.first][pos.second] = SYMBOL_HILL;
+        ForEachInRange({l, c}, level - denceness, 1, false, [&](position_t pos) { SetSymbol(pos, SYMBOL_HILL); });
       }
     }
   }
-  spdlog::get(LOGGER)->debug("Field::AddHills: done");
+  BuildComponents();
+  LOG_DEBUG(LOG_FIELD, "Field::AddHills: done");
 }
 
-std::list<position_t> Field::GetWayForSoldier(position_t start_pos, std::vector<position_t> way_points) {
-  spdlog::get(LOGGER)->info("Field::GetWayForSoldier: pos={}", utils::PositionToString(start_pos));
+path_t Field::GetWayForSoldier(position_t start_pos, const std::vector<position_t>& way_points) {
+  LOG_INFO(LOG_FIELD, "Field::GetWayForSoldier: pos={}", utils::PositionToString(start_pos));
+  if (auto cached_way = path_cache_.Get(start_pos, way_points, map_version_))
+    return cached_way;
   position_t target_pos = way_points.back();
-  way_points.pop_back();
-  std::list<position_t> way = {start_pos};
+  std::vector<position_t> way = {start_pos};
   // If there are way_points left, sort way-points by distance, then create way.
-  if (way_points.size() > 0) {
+  if (way_points.size() > 1) {
     std::map<int, position_t> sorted_way;
-    for (const auto& it : way_points) 
-      sorted_way[lines_+cols_-utils::Dist(it, target_pos)] = it;
+    for (auto it = way_points.begin(); it != way_points.end()-1; it++) 
+      sorted_way[lines_+cols_-utils::Dist(*it, target_pos)] = *it;
     for (const auto& it : sorted_way) {
       try {
-        auto new_part = graph_.find_way(way.back(), it.second);
+        auto new_part = FindWay(way.back(), it.second);
         way.pop_back();
         way.insert(way.end(), new_part.begin(), new_part.end());
       }
       catch (std::exception& e) {
-        spdlog::get(LOGGER)->error("Field::GetWayForSoldier: Serious error: no way found: {}", e.what());
+        LOG_ERROR(LOG_FIELD, "Field::GetWayForSoldier: Serious error: no way found: {}", e.what());
       }
     }
   }
   // Create way from last position to target.
   try {
-    auto new_part = graph_.find_way(way.back(), target_pos);
+    auto new_part = FindWay(way.back(), target_pos);
     way.pop_back();
     way.insert(way.end(), new_part.begin(), new_part.end());
   }
   catch (std::exception& e) {
-    spdlog::get(LOGGER)->error("Field::GetWayForSoldier: Serious error: no way found: {}", e.what());
+    LOG_ERROR(LOG_FIELD, "Field::GetWayForSoldier: Serious error: no way found: {}", e.what());
   }
-  return way;
+  auto path = std::make_shared<const std::vector<position_t>>(std::move(way));
+  path_cache_.Put(start_pos, way_points, map_version_, path);
+  return path;
+}
+
+std::shared_ptr<const FlowField> Field::GetFlowField(position_t target) {
+  if (!graph_.InGraph(target))
+    return nullptr;
+  std::unique_lock ul(mutex_flow_fields_);
+  if (flow_fields_version_ != map_version_) {
+    flow_fields_.clear();
+    flow_fields_index_.clear();
+    flow_fields_version_ = map_version_;
+  }
+  auto it = flow_fields_index_.find(target);
+  if (it != flow_fields_index_.end()) {
+    // Mark as most recently used.
+    flow_fields_.splice(flow_fields_.begin(), flow_fields_, it->second);
+    return it->second->second;
+  }
+  // Bound memory: drop least recently used flow-field if maximum number is reached.
+  if (flow_fields_.size() >= MAX_FLOW_FIELDS) {
+    flow_fields_index_.erase(flow_fields_.back().first);
+    flow_fields_.pop_back();
+  }
+  auto flow_field = std::make_shared<FlowField>(&graph_);
+  flow_field->AddSource(target);
+  flow_fields_.push_front({target, flow_field});
+  flow_fields_index_[target] = flow_fields_.begin();
+  return flow_field;
+}
+
+void Field::RemoveFlowField(position_t target) {
+  std::unique_lock ul(mutex_flow_fields_);
+  auto it = flow_fields_index_.find(target);
+  if (it == flow_fields_index_.end())
+    return;
+  flow_fields_.erase(it->second);
+  flow_fields_index_.erase(it);
 }
 
 void Field::AddNewUnitToPos(position_t pos, int unit) {
   std::unique_lock ul_field(mutex_field_);
   if (unit == UnitsTech::ACTIVATEDNEURON)
-    field_[pos.first][pos.second] = SYMBOL_DEF;
+    SetSymbol(pos, SYMBOL_DEF);
   else if (unit == UnitsTech::SYNAPSE)
-    field_[pos.first][pos.second] = SYMBOL_BARACK;
+    SetSymbol(pos, SYMBOL_BARACK);
   else if (unit == UnitsTech::NUCLEUS)
-    field_[pos.first][pos.second] = SYMBOL_DEN;
+    SetSymbol(pos, SYMBOL_DEN);
 }
 
-void Field::UpdateField(Player *player, std::vector<std::vector<std::string>>& field) {
+void Field::UpdateField(const PlayerSnapshot& player, std::vector<std::vector<std::string>>& field) {
   // Accumulate all ipsps and epsps at their current positions.
   // Accumulate epsps with start symbol '0' and ipsps with start symbol 'a'.
   std::map<position_t, std::map<char, int>> potentials_at_position;
-  for (const auto& it : player->potential()) {
-    if (it.second.type_ == UnitsTech::EPSP) 
-      potentials_at_position[it.second.pos_]['0']++;
-    else if (it.second.type_ == UnitsTech::IPSP)
-      potentials_at_position[it.second.pos_]['a']++;
+  for (const auto& it : player.potential_) {
+    if (it.type_ == UnitsTech::EPSP) 
+      potentials_at_position[it.pos_]['0'] += it.count_;
+    else if (it.type_ == UnitsTech::IPSP)
+      potentials_at_position[it.pos_]['a'] += it.count_;
   }
 
   // Add ipsps with increasing letter-count (add ipsps first to prioritise epsps).
@@ -224,80 +327,65 @@ void Field::UpdateField(Player *player, std::vector<std::vector<std::string>>& f
   }
 }
 
-bool Field::CheckCollidingPotentials(position_t pos, Player* player_one, Player* player_two) {
-  std::string id_one = player_one->GetPotentialIdIfPotential(pos);
-  std::string id_two = player_two->GetPotentialIdIfPotential(pos);
-  // Not colliding potentials as at at least one position there is no potential.
-  if (id_one == "" || id_two == "")
-    return false;
-
-  if (id_one.find("epsp") != std::string::npos && id_two.find("ipsp") != std::string::npos) {
-    spdlog::get(LOGGER)->debug("Field::CheckCollidingPotentials: calling neutralize potential 1");
-    player_one->NeutralizePotential(id_one, 1);
-    spdlog::get(LOGGER)->debug("Field::CheckCollidingPotentials: calling neutralize potential 2");
-    player_two->NeutralizePotential(id_two, -1); // -1 increase potential.
-  }
-  else if (id_one.find("ipsp") != std::string::npos && id_two.find("epsp") != std::string::npos) {
-    spdlog::get(LOGGER)->debug("Field::CheckCollidingPotentials: calling neutralize potential 1");
-    player_one->NeutralizePotential(id_one, -1);
-    spdlog::get(LOGGER)->debug("Field::CheckCollidingPotentials: calling neutralize potential 2");
-    player_two->NeutralizePotential(id_two, 1); // -1 increase potential.
-  }
-  return true;
-}
-
-void Field::PrintField(Player* player, Player* enemy) {
-  std::shared_lock sl_field(mutex_field_);
+void Field::PrintField(const PlayerSnapshot& player, const PlayerSnapshot& enemy, Renderer* renderer) {
+  std::unique_lock ul_field(mutex_field_);
   auto field = field_;
-  sl_field.unlock();
+  auto blinks = blinks_;
+  blinks_.clear();
+  ul_field.unlock();
 
   UpdateField(player, field);
   UpdateField(enemy, field);
+  std::set<position_t> potentials_player;
+  for (const auto& it : player.potential_)
+    potentials_player.insert(it.pos_);
+  std::set<position_t> potentials_enemy;
+  for (const auto& it : enemy.potential_)
+    potentials_enemy.insert(it.pos_);
 
   for (int l=0; l<lines_; l++) {
     for (int c=0; c<cols_; c++) {
       position_t cur = {l, c};
       // highlight -> magenta
       if (std::find(highlight_.begin(), highlight_.end(), cur) != highlight_.end())
-        attron(COLOR_PAIR(COLOR_HIGHLIGHT));
-      else if (std::find(blinks_.begin(), blinks_.end(), cur) != blinks_.end())
-        attron(COLOR_PAIR(COLOR_HIGHLIGHT));
+        renderer->SetColor(COLOR_HIGHLIGHT);
+      else if (std::find(blinks.begin(), blinks.end(), cur) != blinks.end())
+        renderer->SetColor(COLOR_HIGHLIGHT);
       // IPSP is on enemy neuron -> cyan.
-      else if (player->IsNeuronBlocked(cur) || enemy->IsNeuronBlocked(cur))
-          attron(COLOR_PAIR(COLOR_RESOURCES));
+      else if (player.IsNeuronBlocked(cur) || enemy.IsNeuronBlocked(cur))
+          renderer->SetColor(COLOR_RESOURCES);
       // both players -> cyan
-      else if (CheckCollidingPotentials(cur, player, enemy))
-        attron(COLOR_PAIR(COLOR_RESOURCES));
+      else if (potentials_player.count(cur) > 0 && potentials_enemy.count(cur) > 0)
+        renderer->SetColor(COLOR_RESOURCES);
       // Resource
-      else if (enemy->GetNeuronTypeAtPosition(cur) == RESOURCENEURON 
-          || player->GetNeuronTypeAtPosition(cur) == RESOURCENEURON)
-        attron(COLOR_PAIR(COLOR_RESOURCES));
+      else if (enemy.GetNeuronTypeAtPosition(cur) == RESOURCENEURON 
+          || player.GetNeuronTypeAtPosition(cur) == RESOURCENEURON)
+        renderer->SetColor(COLOR_RESOURCES);
       // player 2 -> red
-      else if (enemy->GetNeuronTypeAtPosition(cur) != -1 || enemy->GetPotentialIdIfPotential(cur) != "")
-        attron(COLOR_PAIR(COLOR_PLAYER));
+      else if (enemy.GetNeuronTypeAtPosition(cur) != -1 || potentials_enemy.count(cur) > 0)
+        renderer->SetColor(COLOR_PLAYER);
       // player 1 -> blue 
-      else if (player->GetNeuronTypeAtPosition(cur) != -1 || player->GetPotentialIdIfPotential(cur) != "")
-        attron(COLOR_PAIR(COLOR_KI));
+      else if (player.GetNeuronTypeAtPosition(cur) != -1 || potentials_player.count(cur) > 0)
+        renderer->SetColor(COLOR_KI);
       // range -> green
       else if (InRange(cur, range_, range_center_) 
-          && player->GetNeuronTypeAtPosition(cur) != UnitsTech::NUCLEUS)
-        attron(COLOR_PAIR(COLOR_OK));
+          && player.GetNeuronTypeAtPosition(cur) != UnitsTech::NUCLEUS)
+        renderer->SetColor(COLOR_OK);
       // Replace certain elements.
       if (replacements_.count(cur) > 0)
-        mvaddch(15+l, left_border_ + 2*c, replacements_.at(cur));
+        renderer->AddCh(15+l, left_border_ + 2*c, replacements_.at(cur));
       else
-        mvaddstr(15+l, left_border_ + 2*c, field[l][c].c_str());
-      mvaddch(15+l, left_border_ + 2*c+1, ' ' );
-      attron(COLOR_PAIR(COLOR_DEFAULT));
+        renderer->AddStr(15+l, left_border_ + 2*c, field[l][c]);
+      renderer->AddCh(15+l, left_border_ + 2*c+1, ' ' );
+      renderer->SetColor(COLOR_DEFAULT);
     }
   }
-  blinks_.clear();
 }
 
 bool Field::InRange(position_t pos, int range, position_t start) {
   if (range == ViewRange::GRAPH)
     return graph_.InGraph(pos);
-  return utils::Dist(pos, start) <= range;
+  return geometry::DistSq(pos, start) <= range*range;
 }
 
 bool Field::InField(position_t pos) {
@@ -306,10 +394,9 @@ bool Field::InField(position_t pos) {
 
 position_t Field::FindFree(position_t pos, int min, int max) {
   std::shared_lock sl_field(mutex_field_);
-  auto positions = GetAllInRange(pos, max, min, true);
-  if (positions.size() == 0)
+  if (!graph_built_ || !InField(pos))
     return {-1, -1};
-  return positions[ran_gen_->RandomInt(0, positions.size()-1)];
+  return free_cells_.RandomInRange(pos, min, max, ran_gen_);
 }
 
 std::string Field::GetSymbolAtPos(position_t pos) const {
@@ -334,23 +421,95 @@ int Field::random_coordinate_shift(int x, int min, int max) {
 
 std::vector<position_t> Field::GetAllInRange(position_t start, double max_dist, double min_dist, bool free) {
   std::vector<position_t> positions_in_range;
-  if (!InField(start))
-    return positions_in_range;
-  position_t upper_corner = {start.first-max_dist, start.second-max_dist};
-  for (int i=0; i<=max_dist*2; i++) {
-    for (int j=0; j<=max_dist*2; j++) {
-      position_t pos = {upper_corner.first+i, upper_corner.second+j};
-      if (InField(pos) && utils::InRange(start, pos, min_dist, max_dist)
-          && (!free || field_[pos.first][pos.second] == SYMBOL_FREE)
-          && (!free || graph_.InGraph(pos)))
-        positions_in_range.push_back(pos);
+  ForEachInRange(start, max_dist, min_dist, free, [&](position_t pos) { positions_in_range.push_back(pos); });
+  return positions_in_range;
+}
+
+void Field::SetSymbol(position_t pos, std::string symbol) {
+  bool was_passable = Passable(pos);
+  field_[pos.first][pos.second] = symbol;
+  // Hills split components, so they are rebuild on next use; new passable
+  // positions are simply merged with their neighbors.
+  if (symbol == SYMBOL_HILL) {
+    components_valid_ = false;
+  }
+  else if (!was_passable && components_valid_ && Passable(pos)) {
+    ForEachInRange(pos, 1.5, 1, false, [&](position_t neighbor) {
+        if (Passable(neighbor))
+          components_.Union(graph_.Index(pos), graph_.Index(neighbor));
+      });
+  }
+  if (symbol == SYMBOL_FREE && (!graph_built_ || graph_.InGraph(pos)))
+    free_cells_.Add(pos);
+  else
+    free_cells_.Remove(pos);
+}
+
+bool Field::Passable(position_t pos) const {
+  return pos.first >= 0 && pos.first < lines_ && pos.second >= 0 && pos.second < cols_
+    && field_[pos.first][pos.second] != SYMBOL_HILL;
+}
+
+void Field::BuildComponents() {
+  components_ = UnionFind(lines_*cols_);
+  // Merge each passable position with its passable neighbors above and left.
+  for (int l=0; l<lines_; l++) {
+    for (int c=0; c<cols_; c++) {
+      if (!Passable({l, c}))
+        continue;
+      for (const auto& neighbor : {position_t{l-1, c-1}, {l-1, c}, {l-1, c+1}, {l, c-1}}) {
+        if (Passable(neighbor))
+          components_.Union(graph_.Index({l, c}), graph_.Index(neighbor));
+      }
     }
   }
-  std::string pos_str = "";
-  for (const auto& position : positions_in_range) 
-    pos_str += utils::PositionToString(position) + ", ";
-  spdlog::get(LOGGER)->info("Field::GetAllInRange: {}", pos_str);
-  return positions_in_range;
+  components_valid_ = true;
+}
+
+bool Field::Connected(position_t pos_1, position_t pos_2) {
+  if (!Passable(pos_1) || !Passable(pos_2))
+    return false;
+  if (!components_valid_)
+    BuildComponents();
+  return components_.Connected(graph_.Index(pos_1), graph_.Index(pos_2));
+}
+
+void Field::ClearWay(position_t pos_1, position_t pos_2) {
+  position_t cur = pos_1;
+  while (cur != pos_2) {
+    cur.first += (pos_2.first > cur.first) - (pos_2.first < cur.first);
+    cur.second += (pos_2.second > cur.second) - (pos_2.second < cur.second);
+    if (field_[cur.first][cur.second] == SYMBOL_HILL)
+      SetSymbol(cur, SYMBOL_FREE);
+  }
+}
+
+std::vector<position_t> Field::FindWay(position_t start, position_t target) {
+  if (hierarchical_pathfinder_)
+    return hierarchical_pathfinder_->FindWay(start, target);
+  return pathfinder_.FindWay(start, target);
+}
+
+bool Field::IsFree(position_t pos) const {
+  return graph_built_ && free_cells_.Contains(pos);
+}
+
+int Field::GetSection(position_t pos) const {
+  if (cols_ < SECTIONS/2 || lines_ < 2)
+    return 0;
+  int section_col = pos.second/(cols_/4);
+  int section_line = pos.first/(lines_/2);
+  if (section_col >= SECTIONS/2 || section_line >= 2)
+    return 0;
+  return section_line*(SECTIONS/2) + section_col + 1;
+}
+
+FreeCells Field::CreateFreeCells() const {
+  std::vector<unsigned char> sections;
+  for (int l=0; l<=lines_; l++)
+    for (int c=0; c<=cols_; c++)
+      sections.push_back(GetSection({l, c}));
+  return FreeCells(lines_+1, cols_+1, sections, SECTIONS);
 }
 
 std::vector<position_t> Field::GetAllCenterPositionsOfSections() {
@@ -1,21 +1,30 @@
 #ifndef SRC_FIELD_H_
 #define SRC_FIELD_H_
 
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <shared_mutex>
 #include <utility>
 #include <vector>
-#include <curses.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
+#include "game/free_cells.h"
+#include "game/path_cache.h"
 #include "player/player.h"
+#include "utils/geometry.h"
+#include "utils/flow_field.h"
 #include "utils/graph.h"
+#include "utils/hierarchical_pathfinder.h"
+#include "utils/pathfinder.h"
+#include "utils/union_find.h"
 #include "objects/units.h"
 #include "random/random.h"
+#include "render/renderer.h"
 
 class Field {
   public:
@@ -29,6 +38,7 @@ class Field {
     int lines();
     int cols();
     std::vector<position_t> highlight();
+    const PathCache& path_cache() const;
 
     // setter:
     void set_highlight(std::vector<position_t> positions);
@@ -52,21 +62,47 @@ class Field {
     std::map<int, position_t> AddResources(position_t start_pos);
 
     /**
-     * Adds position for player nucleus.
+     * Adds position for player nucleus (at a random free position of section if
+     * section has free positions).
      * @param[in] section
      * @return position of player nucleus.
      */
     position_t AddNucleus(int section);
 
+    /**
+     * Adds nuclei for both players at random free positions of given sections,
+     * which are connected to each other. If sections share no connected
+     * component, a way between both nuclei is cleared.
+     * @param[in] section_1
+     * @param[in] section_2
+     * @return positions of both nuclei.
+     */
+    std::pair<position_t, position_t> AddNuclei(int section_1, int section_2);
+
     /**
      * Builds graph to calculate ways.
-     * Function should be called after field is initialized. Function checks all
-     * fields reachable from player-den (this could be the den of any player).
+     * Function should be called after field is initialized. Graph consists of
+     * all fields connected to player-den (this could be the den of any player).
      * @param[in] player_den position of player's den.
      * @param[in] enemy_den position of enemy's den.
      */
     void BuildGraph(position_t player_den, position_t enemy_den);
 
+    /**
+     * Gets flow-field towards given target (calculated once per target and
+     * graph, least recently used flow-field is dropped, if too many targets).
+     * @param[in] target
+     * @return flow-field or nullptr if target is not in graph.
+     */
+    std::shared_ptr<const FlowField> GetFlowField(position_t target);
+
+    /**
+     * Drops flow-field towards given target (f.e. when target is destroyed).
+     * Potentials already following the flow-field keep their copy.
+     * @param[in] target
+     */
+    void RemoveFlowField(position_t target);
+
     /**
      * Finds a free position for a defence tower and adds tower to player/ ki
      * units.
@@ -78,20 +114,20 @@ class Field {
     /** 
      * Prints current field. 
      * Updates the field stacking soldiers.
-     * @param player pointer to the player.
-     * @param ki pointer to the ki
-     * @param show_in_graph if set to true, highlights all free positions in the
-     * way between player 1 and player 2 den.
+     * @param player snapshot of the player.
+     * @param ki snapshot of the ki
+     * @param renderer to print field to.
      */
-    void PrintField(Player* player, Player* ki);
+    void PrintField(const PlayerSnapshot& player, const PlayerSnapshot& ki, Renderer* renderer);
 
     /**
-     * Gets way to a soldiers target.
+     * Gets way to a soldiers target (cached until graph changes).
      * @param start_pos starting position.
-     * @param target_pos target position.
-     * @return list of positions.
+     * @param way_points way-points, last way-point is the target position.
+     * @return positions of way (start to target), shared with all callers
+     * requesting the same way.
      */ 
-    std::list<position_t> GetWayForSoldier(position_t start_pos, std::vector<position_t> way_points);
+    path_t GetWayForSoldier(position_t start_pos, const std::vector<position_t>& way_points);
 
     /** 
      * Finds the next free position near a given position with min and max
@@ -131,6 +167,26 @@ class Field {
     std::vector<position_t> GetAllInRange(position_t start, double max_dist, 
         double min_dist, bool free=false);
 
+    /**
+     * Calls given function for all positions with a certain distance (min, max)
+     * to a given start-point (same positions and order as GetAllInRange, but
+     * without allocating a vector).
+     * @param[in] start position
+     * @param[in] max_dist 
+     * @param[in] min_dist
+     * @param[in] free (only free positions)
+     * @param[in] func called with each position in range.
+     */
+    template<typename Func>
+    void ForEachInRange(position_t start, double max_dist, double min_dist, bool free, Func func) {
+      if (!InField(start))
+        return;
+      geometry::ForEachInRange(start, max_dist, min_dist, [&](position_t pos) {
+          if (InField(pos) && (!free || IsFree(pos)))
+            func(pos);
+        });
+    }
+
     /**
      * Gets the positions of the center of each section.
      * @return positions of the center of each section.
@@ -151,7 +207,20 @@ class Field {
     int cols_;
     RandomGenerator* ran_gen_;
     Graph graph_;
+    Pathfinder pathfinder_;
+    std::unique_ptr<HierarchicalPathfinder> hierarchical_pathfinder_;  ///< only set for big maps.
+    PathCache path_cache_;
+    unsigned int map_version_;  ///< increased whenever graph changes.
+    typedef std::list<std::pair<position_t, std::shared_ptr<const FlowField>>> flow_fields_t;
+    flow_fields_t flow_fields_;  ///< most recently used first.
+    std::map<position_t, flow_fields_t::iterator> flow_fields_index_;
+    unsigned int flow_fields_version_;
+    std::mutex mutex_flow_fields_;
+    bool graph_built_;
     std::vector<std::vector<std::string>> field_;
+    FreeCells free_cells_;  ///< free positions (in graph, once graph is build).
+    UnionFind components_;  ///< connected components of all positions without hills.
+    bool components_valid_;
     std::shared_mutex mutex_field_;
 
     std::vector<position_t> highlight_;
@@ -167,12 +236,10 @@ class Field {
      * player. 
      * Usually this function is called for each player just before printing the
      * field. This function only modifies a temporary copy of the field.
-     * @param[in] player player of which to add soldiers.
+     * @param[in] player snapshot of player of which to add soldiers.
      * @param[out] field reference to copy of field.
      */
-    void UpdateField(Player* player, std::vector<std::vector<std::string>>& field);
-
-    bool CheckCollidingPotentials(position_t pos, Player* player_one, Player* player_two);
+    void UpdateField(const PlayerSnapshot& player, std::vector<std::vector<std::string>>& field);
 
     /**
      * Gets x in range, returning 0 if x<min, max ist x > max, and x otherwise.
@@ -192,6 +259,71 @@ class Field {
 
     int random_coordinate_shift(int x, int min, int max);
 
+    /**
+     * Sets symbol at given position and updates index of free positions.
+     * @param[in] pos
+     * @param[in] symbol
+     */
+    void SetSymbol(position_t pos, std::string symbol);
+
+    /**
+     * Checks whether position is inside graph-area and not a hill.
+     * @param[in] pos
+     * @return whether position is passable.
+     */
+    bool Passable(position_t pos) const;
+
+    /**
+     * Rebuilds connected components of passable positions (called once hills
+     * are added; afterwards positions becoming passable are merged with their
+     * neighbors).
+     */
+    void BuildComponents();
+
+    /**
+     * Checks whether two positions are passable and connected.
+     * @param[in] pos_1
+     * @param[in] pos_2
+     * @return whether positions are connected.
+     */
+    bool Connected(position_t pos_1, position_t pos_2);
+
+    /**
+     * Clears all hills on a straight (8-connected) line between two positions.
+     * @param[in] pos_1
+     * @param[in] pos_2
+     */
+    void ClearWay(position_t pos_1, position_t pos_2);
+
+    /**
+     * Finds way between two positions (hierarchical on big maps, if start and
+     * target are in different sections).
+     * @param[in] start
+     * @param[in] target
+     * @return way including start and target.
+     * @throws std::logic_error if no way exists.
+     */
+    std::vector<position_t> FindWay(position_t start, position_t target);
+
+    /**
+     * Checks whether position is free and in graph.
+     * @param[in] pos
+     * @return whether position is free and in graph.
+     */
+    bool IsFree(position_t pos) const;
+
+    /**
+     * Gets section of position.
+     * @param[in] pos
+     * @return section (1..8) or 0 if position is not part of any section.
+     */
+    int GetSection(position_t pos) const;
+
+    /**
+     * Creates index of free positions for empty field.
+     */
+    FreeCells CreateFreeCells() const;
+
 };
 
 
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <vector>
+
+#include "game/free_cells.h"
+#include "utils/geometry.h"
+
+#define RANDOM_TRIES 16
+
+FreeCells::FreeCells(int lines, int cols, std::vector<unsigned char> sections, int num_sections)
+  : lines_(lines), cols_(cols), buckets_cols_((cols+FREE_CELLS_BUCKET_SIZE-1)/FREE_CELLS_BUCKET_SIZE),
+  sections_(sections), size_(0) {
+  int buckets_lines = (lines+FREE_CELLS_BUCKET_SIZE-1)/FREE_CELLS_BUCKET_SIZE;
+  buckets_.resize(buckets_lines*buckets_cols_);
+  section_cells_.resize(num_sections+1);
+  index_in_bucket_.assign(lines*cols, -1);
+  index_in_section_.assign(lines*cols, -1);
+}
+
+size_t FreeCells::size() const {
+  return size_;
+}
+
+void FreeCells::Add(position_t pos) {
+  if (pos.first < 0 || pos.first >= lines_ || pos.second < 0 || pos.second >= cols_)
+    return;
+  uint32_t cell = pos.first*cols_ + pos.second;
+  if (index_in_bucket_[cell] != -1)
+    return;
+  auto& bucket = buckets_[Bucket(cell)];
+  index_in_bucket_[cell] = bucket.size();
+  bucket.push_back(cell);
+  auto& section = section_cells_[sections_[cell]];
+  index_in_section_[cell] = section.size();
+  section.push_back(cell);
+  size_++;
+}
+
+void FreeCells::Remove(position_t pos) {
+  if (!Contains(pos))
+    return;
+  uint32_t cell = pos.first*cols_ + pos.second;
+  SwapRemove(buckets_[Bucket(cell)], index_in_bucket_, index_in_bucket_[cell]);
+  SwapRemove(section_cells_[sections_[cell]], index_in_section_, index_in_section_[cell]);
+  size_--;
+}
+
+bool FreeCells::Contains(position_t pos) const {
+  if (pos.first < 0 || pos.first >= lines_ || pos.second < 0 || pos.second >= cols_)
+    return false;
+  return index_in_bucket_[pos.first*cols_ + pos.second] != -1;
+}
+
+size_t FreeCells::SizeOfSection(int section) const {
+  if (section < 1 || section >= (int)section_cells_.size())
+    return 0;
+  return section_cells_[section].size();
+}
+
+position_t FreeCells::RandomInSection(int section, RandomGenerator* ran_gen) const {
+  if (SizeOfSection(section) == 0)
+    return {-1, -1};
+  const auto& cells = section_cells_[section];
+  return ToPosition(cells[ran_gen->RandomInt(0, cells.size()-1)]);
+}
+
+position_t FreeCells::RandomInRange(position_t center, double min_dist, double max_dist,
+    RandomGenerator* ran_gen) const {
+  if (max_dist < 0 || size_ == 0)
+    return {-1, -1};
+  // Get buckets overlapping the square around center.
+  int reach = max_dist;
+  int first_line = std::max(0, center.first-reach) / FREE_CELLS_BUCKET_SIZE;
+  int last_line = std::min(lines_-1, center.first+reach) / FREE_CELLS_BUCKET_SIZE;
+  int first_col = std::max(0, center.second-reach) / FREE_CELLS_BUCKET_SIZE;
+  int last_col = std::min(cols_-1, center.second+reach) / FREE_CELLS_BUCKET_SIZE;
+  size_t total = 0;
+  for (int l=first_line; l<=last_line; l++)
+    for (int c=first_col; c<=last_col; c++)
+      total += buckets_[l*buckets_cols_ + c].size();
+  if (total == 0)
+    return {-1, -1};
+
+  // Draw random free cells of these buckets until one is in range.
+  for (int i=0; i<RANDOM_TRIES; i++) {
+    size_t r = ran_gen->RandomInt(0, total-1);
+    for (int l=first_line; l<=last_line; l++) {
+      for (int c=first_col; c<=last_col; c++) {
+        const auto& bucket = buckets_[l*buckets_cols_ + c];
+        if (r < bucket.size()) {
+          position_t pos = ToPosition(bucket[r]);
+          if (geometry::InRange(center, pos, min_dist, max_dist))
+            return pos;
+          l = last_line;
+          break;
+        }
+        r -= bucket.size();
+      }
+    }
+  }
+
+  // Most free cells near center are out of range: count all free cells in range and pick one.
+  size_t num = 0;
+  geometry::ForEachInRange(center, max_dist, min_dist, [&](position_t pos) { if (Contains(pos)) num++; });
+  if (num == 0)
+    return {-1, -1};
+  size_t r = ran_gen->RandomInt(0, num-1);
+  position_t result = {-1, -1};
+  geometry::ForEachInRange(center, max_dist, min_dist, [&](position_t pos) {
+      if (Contains(pos) && r-- == 0)
+        result = pos;
+    });
+  return result;
+}
+
+uint32_t FreeCells::Bucket(uint32_t cell) const {
+  return (cell/cols_)/FREE_CELLS_BUCKET_SIZE*buckets_cols_ + (cell%cols_)/FREE_CELLS_BUCKET_SIZE;
+}
+
+position_t FreeCells::ToPosition(uint32_t cell) const {
+  return {static_cast<int>(cell/cols_), static_cast<int>(cell%cols_)};
+}
+
+void FreeCells::SwapRemove(std::vector<uint32_t>& cells, std::vector<int32_t>& index, int32_t i) {
+  uint32_t removed = cells[i];
+  cells[i] = cells.back();
+  index[cells[i]] = i;
+  cells.pop_back();
+  index[removed] = -1;
+}
@@ -0,0 +1,101 @@
+#ifndef SRC_GAME_FREE_CELLS_H_
+#define SRC_GAME_FREE_CELLS_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "random/random.h"
+
+#define FREE_CELLS_BUCKET_SIZE 8
+
+typedef std::pair<int, int> position_t;
+
+/**
+ * Index of all free cells of the field.
+ * Free cells are kept in dense arrays per section and per spatial bucket
+ * (FREE_CELLS_BUCKET_SIZE x FREE_CELLS_BUCKET_SIZE cells). Each cell knows its
+ * index in these arrays, so adding and removing cells (swap with last) and
+ * drawing a random free cell are constant time.
+ */
+class FreeCells {
+  public:
+    /**
+     * Constructor creating empty index.
+     * @param[in] lines
+     * @param[in] cols
+     * @param[in] sections section of each cell (line by line, 0: no section).
+     * @param[in] num_sections
+     */
+    FreeCells(int lines, int cols, std::vector<unsigned char> sections, int num_sections);
+
+    // getter:
+    size_t size() const;
+
+    // methods:
+    void Add(position_t pos);
+    void Remove(position_t pos);
+    bool Contains(position_t pos) const;
+
+    /**
+     * Gets number of free cells in given section.
+     * @param[in] section
+     * @return number of free cells in given section.
+     */
+    size_t SizeOfSection(int section) const;
+
+    /**
+     * Gets random free cell of given section.
+     * @param[in] section
+     * @param[in] ran_gen
+     * @return random free cell of given section or {-1, -1} if section is full.
+     */
+    position_t RandomInSection(int section, RandomGenerator* ran_gen) const;
+
+    /**
+     * Gets random free cell with min_dist <= distance <= max_dist to center.
+     * Draws random cells from the surrounding buckets until one is in range;
+     * only if that fails repeatedly, all cells in range are checked.
+     * @param[in] center
+     * @param[in] min_dist
+     * @param[in] max_dist
+     * @param[in] ran_gen
+     * @return random free cell in range or {-1, -1} if no cell is free.
+     */
+    position_t RandomInRange(position_t center, double min_dist, double max_dist,
+        RandomGenerator* ran_gen) const;
+
+    /**
+     * Calls given function for each free cell of given section.
+     * @param[in] section
+     * @param[in] func called with each free position of section.
+     */
+    template<typename Func>
+    void ForEachInSection(int section, Func func) const {
+      if (SizeOfSection(section) == 0)
+        return;
+      for (const auto& cell : section_cells_[section])
+        func(ToPosition(cell));
+    }
+
+  private:
+    const int lines_;
+    const int cols_;
+    const int buckets_cols_;
+    std::vector<unsigned char> sections_;
+    std::vector<std::vector<uint32_t>> buckets_;
+    std::vector<std::vector<uint32_t>> section_cells_;
+    std::vector<int32_t> index_in_bucket_;  ///< -1 if cell not free.
+    std::vector<int32_t> index_in_section_;
+    size_t size_;
+
+    uint32_t Bucket(uint32_t cell) const;
+    position_t ToPosition(uint32_t cell) const;
+
+    /**
+     * Removes element at index from dense array and updates index of moved cell.
+     */
+    static void SwapRemove(std::vector<uint32_t>& cells, std::vector<int32_t>& index, int32_t i);
+};
+
+#endif
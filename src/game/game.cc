@@ -4,11 +4,11 @@
 #include <chrono>
 #include <cstddef>
 #include<cstdlib>
-#include <curses.h>
 #include <exception>
 #include <filesystem>
 #include <map>
 #include <mutex>
+#include <random>
 #include <shared_mutex>
 #include <stdexcept>
 #include <string>
@@ -17,11 +17,14 @@
 #include <vector>
 
 #include "constants/codes.h"
+#include "game/match.h"
+#include "game/replay.h"
 #include "nlohmann/json.hpp"
 #include "objects/units.h"
 #include "player/player.h"
 #include "random/random.h"
 #include "spdlog/spdlog.h"
+#include "utils/logger.h"
 #include "utils/utils.h"
 
 #define LINE_HELP 13 
@@ -32,22 +35,29 @@
 #define KI_NEW_SOLDIER 1250
 #define KI_NEW_SOLDIER 1250
 
-std::string CheckMissingResources(Costs missing_costs) {
+std::string CheckMissingResources(const PlayerSnapshot& snapshot, int unit, int boast=1) {
   std::string res = "";
-  if (missing_costs.size() == 0)
+  resource_mask_t missing = snapshot.GetMissingResources(unit, boast);
+  if (missing == 0)
     return res;
-  for (const auto& it : missing_costs)
-    res += "Missing " + std::to_string(it.second) + " " + resources_name_mapping.at(it.first) + "! ";
+  const Costs& costs = CostsOf(unit);
+  for (int i=0; i<NUM_RESOURCES; i++) {
+    if (missing & (1u << i)) {
+      double amount = costs[i] - snapshot.resources_.at(i).cur();
+      res += "Missing " + std::to_string(amount) + " " + resources_name_mapping.at(i) + "! ";
+    }
+  }
   return res;
 }
 
-Game::Game(int lines, int cols, int left_border, std::string base_path) 
-  : game_over_(false), pause_(false), resigned_(false), audio_(base_path), base_path_(base_path), 
-  lines_(lines), cols_(cols), left_border_(left_border) {
+Game::Game(int lines, int cols, int left_border, std::string base_path, Renderer* renderer) 
+  : renderer_(renderer), simulation_(NULL), game_over_(false), resigned_(false), replay_(false), speed_(1), 
+  audio_(base_path), 
+  base_path_(base_path), lines_(lines), cols_(cols), left_border_(left_border) {
 
-  spdlog::get(LOGGER)->info("Loading music paths at {}", base_path + "/settings/music_paths.json");
+  LOG_INFO(LOG_GAME, "Loading music paths at {}", base_path + "/settings/music_paths.json");
   std::vector<std::string> paths = utils::LoadJsonFromDisc(base_path + "/settings/music_paths.json");
-  spdlog::get(LOGGER)->info("Got music paths: {}", paths.size());
+  LOG_INFO(LOG_GAME, "Got music paths: {}", paths.size());
 
   for (const auto& it : paths) {
     if (it.find("$(HOME)") != std::string::npos)
@@ -60,19 +70,19 @@ Game::Game(int lines, int cols, int left_border, std::string base_path)
 }
 
 void Game::play() {
-  spdlog::get(LOGGER)->info("Started game with {}, {}, {}, {}", lines_, cols_, LINES, COLS);
+  LOG_INFO(LOG_GAME, "Started game with {}, {}, {}, {}", lines_, cols_, renderer_->lines(), renderer_->cols());
 
-  if (LINES < lines_+20 || COLS < (cols_*2)+40) { 
+  if (renderer_->lines() < lines_+20 || renderer_->cols() < (cols_*2)+40) { 
     texts::paragraphs_t paragraphs = {{
         {"Your terminal size is to small to play the game properly."},
-        {"Expected width: " + std::to_string(cols_*2+50) + ", actual: " + std::to_string(COLS)},
-        {"Expected hight: " + std::to_string(lines_+20) + ", actual: " + std::to_string(LINES)},
+        {"Expected width: " + std::to_string(cols_*2+50) + ", actual: " + std::to_string(renderer_->cols())},
+        {"Expected hight: " + std::to_string(lines_+20) + ", actual: " + std::to_string(renderer_->lines())},
     }};
     PrintCentered(paragraphs);
-    clear();
-    PrintCentered(LINES/2, "Can you increase? (Enter play anyway, q to quit)");
-    char c = getch();
-    if (c == 'q')
+    renderer_->Clear();
+    PrintCentered(renderer_->lines()/2, "Can you increase? (Enter play anyway, q to quit)");
+    int c = renderer_->GetCh();
+    if (c == 'q' || c == INPUT_END)
       return;
   }
 
@@ -84,217 +94,122 @@ void Game::play() {
 
   // select song. 
   std::string source_path = SelectAudio();
-  spdlog::get(LOGGER)->info("Selected path: {}", source_path);
+  if (source_path == "")
+    return;
+  LOG_INFO(LOG_GAME, "Selected path: {}", source_path);
   audio_.set_source_path(source_path);
   audio_.Analyze();
 
-  // Build field.
-  RandomGenerator* ran_gen = new RandomGenerator(audio_.analysed_data(), &RandomGenerator::ran_note);
-  RandomGenerator* map_1 = new RandomGenerator(audio_.analysed_data(), &RandomGenerator::ran_boolean_minor_interval);
-  RandomGenerator* map_2 = new RandomGenerator(audio_.analysed_data(), &RandomGenerator::ran_level_peaks);
-  position_t nucleus_pos_1;
-  position_t nucleus_pos_2;
-  std::map<int, position_t> resource_positions_1;
-  std::map<int, position_t> resource_positions_2;
-  int denceness = 0;
-  bool setup = false;
-  spdlog::get(LOGGER)->info("Game::Play: creating map {} {} ", setup, denceness);
-  while (!setup && denceness < 5) {
-    spdlog::get(LOGGER)->info("Game::Play: creating map try: {}", denceness);
-
-    field_ = new Field(lines_, cols_, ran_gen, left_border_);
-    field_->AddHills(map_1, map_2, denceness++);
-    int player_one_section = (int)audio_.analysed_data().average_bpm_%8+1;
-    int player_two_section = (int)audio_.analysed_data().average_level_%8+1;
-    if (player_one_section == player_two_section)
-      player_two_section = (player_two_section+1)%8;
-    nucleus_pos_1 = field_->AddNucleus(player_one_section);
-    nucleus_pos_2 = field_->AddNucleus(player_two_section);
-    try {
-      field_->BuildGraph(nucleus_pos_1, nucleus_pos_2);
-      setup = true;
-    } catch (std::logic_error& e) {
-      spdlog::get(LOGGER)->warn("Game::play: graph could not be build: {}", e.what());
-      field_ = NULL;
-      continue;
-    }
-    resource_positions_1 = field_->AddResources(nucleus_pos_1);
-    resource_positions_2 = field_->AddResources(nucleus_pos_2);
-  }
-  if (!setup) {
-    PrintCentered({{"Game cannot be played with this song, as map is unplayable. "
-        "It might work with a higher resolution. (dissonance -r)"}});
-    return;
-  }
-  PrintCentered({{"Lowered denceness of map by " + std::to_string(denceness) + " to make map playable"}});
-
-  // Setup players.
-  player_one_ = new Player(nucleus_pos_1, field_, ran_gen, resource_positions_1);
-  player_two_ = new AudioKi(nucleus_pos_2, field_, &audio_, ran_gen, resource_positions_2);
-  player_one_->set_enemy(player_two_);
-  player_two_->set_enemy(player_one_);
-  player_two_->SetUpTactics(true); 
+  // Build field and setup players.
+  unsigned int seed = std::random_device()();
+  Match match = CreateMatch(&audio_, lines_, cols_, left_border_, seed);
+  field_ = match.field_;
+  player_one_ = match.player_one_;
+  player_two_ = match.player_two_;
+  simulation_ = match.simulation_;
 
   // Let player one distribute initial iron.
   DistributeIron();
-  // Let player two distribute initial iron.
-  player_two_->DistributeIron(Resources::OXYGEN);
-  player_two_->DistributeIron(Resources::OXYGEN);
-  player_two_->HandleIron(audio_.analysed_data().data_per_beat_.front());
 
   // Start game
+  scheduler_.Start();
   audio_.play();
   std::thread thread_actions([this]() { RenderField(); });
   std::thread thread_choices([this]() { (GetPlayerChoice()); });
-  std::thread thread_ki([this]() { (HandleActions()); });
   thread_actions.join();
   thread_choices.join();
-  thread_ki.join();
-}
-
-void Game::RenderField() {
-  spdlog::get(LOGGER)->debug("Game::RenderField: started");
-  auto audio_start_time = std::chrono::steady_clock::now();
-  auto analysed_data = audio_.analysed_data();
-  std::list<AudioDataTimePoint> data_per_beat = analysed_data.data_per_beat_;
 
-  auto last_update = std::chrono::steady_clock::now();
-  auto last_resource_player_one = std::chrono::steady_clock::now();
-  auto last_resource_player_two = std::chrono::steady_clock::now();
-
-  double ki_resource_update_frequency = data_per_beat.front().bpm_;
-  double player_resource_update_freqeuncy = data_per_beat.front().bpm_;
-  double render_frequency = 40;
+  // Store replay of match.
+  Replay replay = {source_path, Replay::HashAnalysis(audio_.analysed_data()), seed, lines_, cols_, 
+    simulation_->commands()};
+  replay.Save(base_path_ + "/replays/" + utils::GetFormatedDatetime() + ".json");
+}
 
-  auto pause_start_time = std::chrono::steady_clock::now();
-  double time_in_pause = 0;
-  bool pause_started = false;
+void Game::PlayReplay(const Replay& replay, double speed) {
+  LOG_INFO(LOG_GAME, "Game::PlayReplay: {} at speed {}", replay.song_, speed);
+  audio_.set_source_path(replay.song_);
+  audio_.Analyze();
+  if (Replay::HashAnalysis(audio_.analysed_data()) != replay.analysis_hash_)
+    throw std::logic_error("Game::PlayReplay: analysis of song changed since replay was recorded.");
+
+  Match match = CreateMatch(&audio_, replay.lines_, replay.cols_, left_border_, replay.seed_);
+  field_ = match.field_;
+  player_one_ = match.player_one_;
+  player_two_ = match.player_two_;
+  simulation_ = match.simulation_;
+  simulation_->ScheduleCommands(replay.commands_);
+  replay_ = true;
+  speed_ = speed;
+
+  // Start game (music only fits at original speed).
+  scheduler_.Start();
+  if (speed_ == 1)
+    audio_.play();
+  std::thread thread_actions([this]() { RenderField(); });
+  std::thread thread_choices([this]() { (GetPlayerChoice()); });
+  thread_actions.join();
+  thread_choices.join();
+}
 
-  bool off_notes = false;
+void Game::RenderField() {
+  LOG_DEBUG(LOG_GAME, "Game::RenderField: started");
+  scheduler_.Schedule(Timers::RENDER, simulation_->render_frequency());
  
   while (!game_over_) {
-    auto cur_time = std::chrono::steady_clock::now();
-
-    if (pause_) {
-      if (!pause_started) {
-        pause_start_time = std::chrono::steady_clock::now();
-        pause_started = true;
-      }
-      continue;
-    }
-    else if (pause_started) {
-      time_in_pause += utils::GetElapsed(pause_start_time, cur_time);
-      pause_started = false;
-    }
-
-
-    // Analyze audio data.
-    auto elapsed = utils::GetElapsed(audio_start_time, cur_time)-time_in_pause;
-    auto data_at_beat = data_per_beat.front();
-    if (elapsed >= data_at_beat.time_) {
-      render_frequency = 60000.0/(data_at_beat.bpm_*16);
-      ki_resource_update_frequency = (60000.0/data_at_beat.bpm_); //*(data_at_beat.level_/50.0);
-      player_resource_update_freqeuncy = 60000.0/(static_cast<double>(data_at_beat.bpm_)/2);
-    
-      off_notes = audio_.MoreOffNotes(data_at_beat);
-      data_per_beat.pop_front();
-      played_levels_.push_back(audio_.analysed_data().average_level_-data_at_beat.level_);
-    }
-
-    if (player_two_->HasLost() || player_one_->HasLost() || data_per_beat.size() == 0) {
-      SetGameOver((player_two_->HasLost()) ? "YOU WON" : "YOU LOST");
-      audio_.Stop();
-      break;
-    }
-    if (resigned_) {
-      SetGameOver("YOU RESIGNED");
+    // Sleep until next render update is due (or resign/ pause wake us up).
+    scheduler_.WaitForDue({Timers::RENDER});
+    double game_time = scheduler_.GameTime();
+
+    // Catch up with game-time: simulation advances in fixed ticks only.
+    while (simulation_->GameTime() <= game_time*speed_ && !simulation_->Finished())
+      simulation_->Tick();
+
+    // Resign is recorded as command, so that replays end at the same tick.
+    if (resigned_ && !simulation_->Finished())
+      simulation_->Execute(Command(RESIGN));
+    if (simulation_->Finished()) {
+      if (simulation_->resigned())
+        SetGameOver("YOU RESIGNED");
+      else
+        SetGameOver((player_two_->HasLost()) ? "YOU WON" : "YOU LOST");
       audio_.Stop();
       break;
     }
-   
-    // Increase resources.
-    if (utils::GetElapsed(last_resource_player_one, cur_time) > player_resource_update_freqeuncy) {
-      player_one_->IncreaseResources(off_notes);
-      last_resource_player_one = cur_time;
-    }
-    if (utils::GetElapsed(last_resource_player_two, cur_time) > ki_resource_update_frequency) {
-      player_two_->IncreaseResources(off_notes);
-      last_resource_player_two = cur_time;
-    }
-
-    if (utils::GetElapsed(last_update, cur_time) > render_frequency) {
-      // Move player soldiers and check if enemy den's lp is down to 0.
-      player_one_->MovePotential(player_two_);
-      player_two_->MovePotential(player_one_);
 
-      // Remove enemy soldiers in renage of defence towers.
-      player_one_->HandleDef(player_two_);
-      player_two_->HandleDef(player_one_);
-
-      // Refresh page
-      PrintFieldAndStatus();
-      last_update = cur_time;
-    }
+    // Refresh page
+    PrintFieldAndStatus();
+    scheduler_.Schedule(Timers::RENDER, game_time + simulation_->render_frequency());
   } 
 }
 
-void Game::HandleActions() {
-  spdlog::get(LOGGER)->debug("Game::HandleActions: started");
-  auto audio_start_time = std::chrono::steady_clock::now();
-  auto analysed_data = audio_.analysed_data();
-  std::list<AudioDataTimePoint> data_per_beat = analysed_data.data_per_beat_;
-
-  auto pause_start_time = std::chrono::steady_clock::now();
-  double time_in_pause = 0;
-  bool pause_started = false;
-
-  // Handle building neurons and potentials.
-  while(!game_over_) {
-    auto cur_time = std::chrono::steady_clock::now(); 
-
-    if (pause_) {
-      if (!pause_started) {
-        pause_start_time = std::chrono::steady_clock::now();
-        pause_started = true;
-      }
-      continue;
-    }
-    else if (pause_started) {
-      time_in_pause += utils::GetElapsed(pause_start_time, cur_time);
-      pause_started = false;
-    }
-
-    // Analyze audio data.
-    auto elapsed = utils::GetElapsed(audio_start_time, cur_time)-time_in_pause;
-    if (data_per_beat.size() == 0)
-      continue;
-    auto data_at_beat = data_per_beat.front();
-    if (elapsed >= data_at_beat.time_) {
-      player_two_->DoAction(data_at_beat);
-      player_two_->set_last_time_point(data_at_beat);
-      data_per_beat.pop_front();
-    }
-  }
-}
-
 void Game::GetPlayerChoice() {
-  spdlog::get(LOGGER)->debug("Game::GetPlayerChoice: started");
+  LOG_DEBUG(LOG_GAME, "Game::GetPlayerChoice: started");
   int choice;
   int num = 1;
   PrintFieldAndStatus();
   while (true) {
 
-    choice = getch();
+    choice = renderer_->GetCh();
     PrintMessage("", false);  // clear message line after each input.
+    // No more input: player leaves (replays run on without input).
+    if (choice == INPUT_END) {
+      scheduler_.set_pause(false);
+      if (!replay_) {
+        resigned_ = true;
+        scheduler_.Notify();
+      }
+      break;
+    }
     // q: quit game
     if (choice == 'q') {
-      pause_ = true;
+      scheduler_.set_pause(true);
       ClearField();
-      PrintCentered(LINES/2, "Are you sure you want to exist? y/n");
-      char c = getch();
-      pause_ = false;
-      if (c == 'y') {
+      PrintCentered(renderer_->lines()/2, "Are you sure you want to exist? y/n");
+      int c = renderer_->GetCh();
+      scheduler_.set_pause(false);
+      if (c == 'y' || c == INPUT_END) {
         resigned_ = true;
+        scheduler_.Notify();
         break;
       }
     }
@@ -311,7 +226,7 @@ void Game::GetPlayerChoice() {
 
     // SPACE: pause/ unpause game
     else if (choice == ' ') {
-      if (pause_) {
+      if (scheduler_.paused()) {
         audio_.Unpause();
         PrintMessage("Un-Paused game.", false);
       }
@@ -319,27 +234,31 @@ void Game::GetPlayerChoice() {
         audio_.Pause();
         PrintMessage("Paused game.", false);
       }
-      pause_ = !pause_;
+      scheduler_.set_pause(!scheduler_.paused());
     }
 
-    else if (pause_) {
+    else if (scheduler_.paused()) {
+      continue;
+    }
+
+    // Replays take no input but quit and pause.
+    else if (replay_) {
       continue;
     }
 
     else if (choice == 'h') {
-      pause_ = true;
+      scheduler_.set_pause(true);
       PrintCentered(texts::help);
-      pause_ = false;
+      scheduler_.set_pause(false);
     }
 
     else if (choice == 'c') {
-      for (int i=0; i<10; i++)
-        player_one_->IncreaseResources(true);
+      simulation_->Submit(Command(INCREASE_RESOURCES, {-1, -1}, 10));
     }
 
     // e: add epsp
     else if (choice == 'e') {
-      std::string res = CheckMissingResources(player_one_->GetMissingResources(UnitsTech::EPSP));
+      std::string res = CheckMissingResources(*player_one_->snapshot(), UnitsTech::EPSP);
       if (res != "")
         PrintMessage(res, true);
       else {
@@ -349,9 +268,8 @@ void Game::GetPlayerChoice() {
         else {
           PrintMessage("Added epsp @synapse " + utils::PositionToString(pos), false);
           for (int i=0; i<num; i++) {
-            player_one_->AddPotential(pos, UnitsTech::EPSP);
-            auto cur_time = std::chrono::steady_clock::now();
-            while (utils::GetElapsed(cur_time, std::chrono::steady_clock::now()) < 110) {}
+            simulation_->Submit(Command(ADD_POTENTIAL, pos, UnitsTech::EPSP));
+            scheduler_.SleepFor(110);
           }
           num = 1;
         }
@@ -359,7 +277,7 @@ void Game::GetPlayerChoice() {
     }
     // i: add ipsp 
     else if (choice == 'i') {
-      std::string res = CheckMissingResources(player_one_->GetMissingResources(UnitsTech::IPSP));
+      std::string res = CheckMissingResources(*player_one_->snapshot(), UnitsTech::IPSP);
       if (res != "")
         PrintMessage(res, true);
       else {
@@ -369,9 +287,8 @@ void Game::GetPlayerChoice() {
         else {
           PrintMessage("created ipsp @synapse: " + utils::PositionToString(pos), false);
           for (int i=0; i<num; i++) {
-            player_one_->AddPotential(pos, UnitsTech::IPSP);
-            auto cur_time = std::chrono::steady_clock::now();
-            while (utils::GetElapsed(cur_time, std::chrono::steady_clock::now()) < 110) {}
+            simulation_->Submit(Command(ADD_POTENTIAL, pos, UnitsTech::IPSP));
+            scheduler_.SleepFor(110);
           }
           num = 1;
 
@@ -381,7 +298,7 @@ void Game::GetPlayerChoice() {
 
     // S: Synapse
     else if (choice == 'S') {
-      std::string res = CheckMissingResources(player_one_->GetMissingResources(UnitsTech::SYNAPSE));
+      std::string res = CheckMissingResources(*player_one_->snapshot(), UnitsTech::SYNAPSE);
       if (res != "") 
         PrintMessage(res, true);
       else {
@@ -390,13 +307,9 @@ void Game::GetPlayerChoice() {
           PrintMessage("Invalid choice!", true);
         else {
           PrintMessage("User the arrow keys to select a position. Press Enter to select.", false);
-          position_t pos = SelectPosition(nucleus_pos, player_one_->cur_range());
-          if (pos.first != -1) {
-            position_t epsp_target = player_two_->GetOneNucleus();
-            position_t ipsp_target = player_two_->GetRandomNeuron(); // random tower.
-            player_one_->AddNeuron(pos, UnitsTech::SYNAPSE, epsp_target, ipsp_target);
-            field_->AddNewUnitToPos(pos, UnitsTech::SYNAPSE);
-          }
+          position_t pos = SelectPosition(nucleus_pos, player_one_->snapshot()->cur_range_);
+          if (pos.first != -1)
+            simulation_->Submit(Command(ADD_NEURON, pos, UnitsTech::SYNAPSE));
           PrintMessage(res, res!="");
         }
       }
@@ -404,7 +317,7 @@ void Game::GetPlayerChoice() {
 
     // D: place defence-tower
     else if (choice == 'A') {
-      std::string res = CheckMissingResources(player_one_->GetMissingResources(UnitsTech::ACTIVATEDNEURON));
+      std::string res = CheckMissingResources(*player_one_->snapshot(), UnitsTech::ACTIVATEDNEURON);
       if (res != "") 
         PrintMessage(res, true);
       else {
@@ -413,11 +326,9 @@ void Game::GetPlayerChoice() {
           PrintMessage("Invalid choice!", true);
         else {
           PrintMessage("User the arrow keys to select a position. Press Enter to select.", false);
-          position_t pos = SelectPosition(nucleus_pos, player_one_->cur_range());
-          if (pos.first != -1) {
-            player_one_->AddNeuron(pos, UnitsTech::ACTIVATEDNEURON);
-            field_->AddNewUnitToPos(pos, UnitsTech::ACTIVATEDNEURON);
-          }
+          position_t pos = SelectPosition(nucleus_pos, player_one_->snapshot()->cur_range_);
+          if (pos.first != -1)
+            simulation_->Submit(Command(ADD_NEURON, pos, UnitsTech::ACTIVATEDNEURON));
           PrintMessage(res, res!="");
         }
       }
@@ -425,12 +336,11 @@ void Game::GetPlayerChoice() {
 
     // N: new nucleus
     else if (choice == 'N') {
-      spdlog::get(LOGGER)->debug("Game::AddNucleus");
-      auto num_nucleus = player_one_->GetAllPositionsOfNeurons(UnitsTech::NUCLEUS).size();
-      spdlog::get(LOGGER)->debug("Game::AddNucleus: current num of nucleus: {}", num_nucleus);
-      std::string res = CheckMissingResources(
-          player_one_->GetMissingResources(UnitsTech::NUCLEUS, num_nucleus));
-      spdlog::get(LOGGER)->debug("Game::AddNucleus: missing resources: {}", res);
+      LOG_DEBUG(LOG_GAME, "Game::AddNucleus");
+      auto num_nucleus = player_one_->snapshot()->GetAllPositionsOfNeurons(UnitsTech::NUCLEUS).size();
+      LOG_DEBUG(LOG_GAME, "Game::AddNucleus: current num of nucleus: {}", num_nucleus);
+      std::string res = CheckMissingResources(*player_one_->snapshot(), UnitsTech::NUCLEUS, num_nucleus);
+      LOG_DEBUG(LOG_GAME, "Game::AddNucleus: missing resources: {}", res);
       if (res != "") 
         PrintMessage(res, true);
       else {
@@ -438,10 +348,8 @@ void Game::GetPlayerChoice() {
         auto start_position = SelectFieldPositionByAlpha(field_->GetAllCenterPositionsOfSections(), "Select start");
         if (start_position.first != -1 && start_position.second != -1) {
           position_t pos = SelectPosition(start_position, ViewRange::GRAPH);
-          if (pos.first != -1) {
-            player_one_->AddNeuron(pos, UnitsTech::NUCLEUS);
-            field_->AddNewUnitToPos(pos, UnitsTech::NUCLEUS);
-          }
+          if (pos.first != -1)
+            simulation_->Submit(Command(ADD_NEURON, pos, UnitsTech::NUCLEUS));
         }
         PrintMessage(res, res!="");
       }
@@ -449,11 +357,12 @@ void Game::GetPlayerChoice() {
 
     // T: Technology
     else if (choice == 't') {
-      pause_ = true;
+      scheduler_.set_pause(true);
       choice_mapping_t mapping;
-      for (const auto& it : player_one_->technologies()) {
+      auto snapshot = player_one_->snapshot();
+      for (const auto& it : *snapshot->technologies_) {
         size_t color = COLOR_DEFAULT;
-        size_t missing_costs = player_one_->GetMissingResources(it.first, it.second.first+1).size();
+        resource_mask_t missing_costs = snapshot->GetMissingResources(it.first, it.second.first+1);
         if (it.second.first < it.second.second && missing_costs == 0)
           color = COLOR_AVAILIBLE;
         mapping[it.first-UnitsTech::WAY] = {units_tech_mapping.at(it.first) 
@@ -461,15 +370,20 @@ void Game::GetPlayerChoice() {
       }
       int technology = SelectInteger("Select technology", true, mapping, {3, 5, 8, 10, 11})
         +UnitsTech::WAY;
-      if (player_one_->AddTechnology(technology))
+      // Checked on snapshot, as command is only applied with the next tick.
+      if (snapshot->technologies_->count(technology) > 0 
+          && snapshot->technologies_->at(technology).first < snapshot->technologies_->at(technology).second
+          && snapshot->GetMissingResources(technology, snapshot->technologies_->at(technology).first+1) == 0) {
+        simulation_->Submit(Command(ADD_TECHNOLOGY, {-1, -1}, technology));
         PrintMessage("selected: " + units_tech_mapping.at(technology), false);
+      }
       else if (technology != -1)
         PrintMessage("Not enough resources or inavlid selection", true);
-      pause_ = false;
+      scheduler_.set_pause(false);
     }
 
     else if (choice == 's') {
-      auto all_synapse_position = player_one_->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE);
+      auto all_synapse_position = player_one_->snapshot()->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE);
       if (all_synapse_position.size() == 0) {
         PrintMessage("You do not have any synapses yet. Use [S] to create one!", true);
         continue;
@@ -481,14 +395,14 @@ void Game::GetPlayerChoice() {
         PrintMessage("Invalid choice!", true);
       else {
         // Create options and get player-choice.
-        auto mapping = player_one_->GetOptionsForSynapes(pos);
+        auto mapping = player_one_->snapshot()->GetOptionsForSynapes(pos);
         int choice = SelectInteger("What to do?", true, mapping, {mapping.size()});
 
         // Do action after getting choice.
         if (mapping.count(choice) > 0) {
           // if func=swarm, simply turn on/ off.
           if (choice == 4)
-            player_one_->SwitchSwarmAttack(pos);
+            simulation_->Submit(Command(SWITCH_SWARM, pos));
           // Otherwise: way-selection (full map)
           else if (choice == 0 || choice == 1) {
             auto start_position = SelectFieldPositionByAlpha(
@@ -497,19 +411,19 @@ void Game::GetPlayerChoice() {
               auto new_pos = SelectPosition(start_position, ViewRange::GRAPH);
               if (new_pos.first != -1) {
                 if (choice == 0)
-                  player_one_->ResetWayForSynapse(pos, new_pos);
+                  simulation_->Submit(Command(RESET_WAY, pos, -1, new_pos));
                 else if (choice == 1)
-                  player_one_->AddWayPosForSynapse(pos, new_pos);
+                  simulation_->Submit(Command(ADD_WAY_POS, pos, -1, new_pos));
               }
             }
           }
           // Otherwise: target-selection (enemy-nucleus)
           else {
-            auto new_pos = SelectPosition(player_two_->GetOneNucleus(), ViewRange::GRAPH);
+            auto new_pos = SelectPosition(player_two_->snapshot()->GetOneNucleus(), ViewRange::GRAPH);
             if (new_pos.first != -1 && choice== 2)
-              player_one_->ChangeIpspTargetForSynapse(pos, new_pos);
+              simulation_->Submit(Command(CHANGE_IPSP_TARGET, pos, -1, new_pos));
             else if (new_pos.first != -1 && choice == 3)
-              player_one_->ChangeEpspTargetForSynapse(pos, new_pos);
+              simulation_->Submit(Command(CHANGE_EPSP_TARGET, pos, -1, new_pos));
           }
         }
         else
@@ -525,7 +439,7 @@ void Game::GetPlayerChoice() {
 }
 
 position_t Game::SelectPosition(position_t start, int range) {
-  spdlog::get(LOGGER)->info("Game::SelectPosition");
+  LOG_INFO(LOG_GAME, "Game::SelectPosition");
   bool end = false;
   position_t new_pos = {-1, -1};
   // Make sure than position exists.
@@ -536,7 +450,7 @@ position_t Game::SelectPosition(position_t start, int range) {
   field_->set_range_center(start);
   
   while(!game_over_ && !end) {
-    int choice = getch();
+    int choice = renderer_->GetCh();
     new_pos = field_->highlight().front();
 
     if (std::to_string(choice) == "10") {
@@ -545,7 +459,7 @@ position_t Game::SelectPosition(position_t start, int range) {
       else 
         PrintMessage("Invalid position (not free)!", false); 
     }
-    else if (choice == 'q') {
+    else if (choice == 'q' || choice == INPUT_END) {
       end = true;
       new_pos = {-1, -1};
     }
@@ -582,7 +496,7 @@ position_t Game::SelectPosition(position_t start, int range) {
 
 position_t Game::SelectNeuron(Player* p, int type) {
   std::string msg = "Choose " + units_tech_mapping.at(type) + ": ";
-  return SelectFieldPositionByAlpha(p->GetAllPositionsOfNeurons(type), msg);
+  return SelectFieldPositionByAlpha(p->snapshot()->GetAllPositionsOfNeurons(type), msg);
 }
 
 position_t Game::SelectFieldPositionByAlpha(std::vector<position_t> positions, std::string msg) {
@@ -595,7 +509,7 @@ position_t Game::SelectFieldPositionByAlpha(std::vector<position_t> positions, s
 
   PrintFieldAndStatus();
   PrintMessage(msg.c_str(), false);
-  char choice = getch();
+  char choice = renderer_->GetCh();
   field_->set_replace({});
   field_->set_highlight({});
   
@@ -608,15 +522,15 @@ position_t Game::SelectFieldPositionByAlpha(std::vector<position_t> positions, s
 }
 
 void Game::DistributeIron() {
-  spdlog::get(LOGGER)->info("Game::DistributeIron.");
-  pause_ = true;
+  LOG_INFO(LOG_GAME, "Game::DistributeIron.");
+  scheduler_.set_pause(true);
   ClearField();
   bool end = false;
   // Get iron and print options.
-  PrintCentered(LINES/2-1, "(use 'q' to quit, +/- to add/remove iron and h/l or ←/→ to circle through resources)");
+  PrintCentered(renderer_->lines()/2-1, "(use 'q' to quit, +/- to add/remove iron and h/l or ←/→ to circle through resources)");
   std::vector<std::string> symbols = {SYMBOL_OXYGEN, SYMBOL_POTASSIUM, SYMBOL_SEROTONIN, SYMBOL_GLUTAMATE, 
     SYMBOL_DOPAMINE, SYMBOL_CHLORIDE};
-  position_t c = {LINES/2, COLS/2};
+  position_t c = {renderer_->lines()/2, renderer_->cols()/2};
   std::vector<position_t> positions = { {c.first-10, c.second}, {c.first-6, c.second+15}, {c.first+6, c.second+15}, 
     {c.first+10, c.second}, {c.first+6, c.second-15}, {c.first-6, c.second-15}, };
 
@@ -625,6 +539,10 @@ void Game::DistributeIron() {
   std::string error = "";
   std::string success = "";
 
+  // Game is paused, so no command is applied until dialog is left: keep track
+  // of submitted (re-)distributions on a copy of the resources.
+  auto resources = player_one_->snapshot()->resources_;
+
   unsigned int current = 0;
   while(!end) {
     // Get current resource and symbol.
@@ -632,38 +550,38 @@ void Game::DistributeIron() {
     int resource = resources_symbol_mapping.at(current_symbol);
 
     // Print texts (help, current resource info)
-    help = "Iron (FE): " + player_one_->resources().at(IRON).Print() + "";;
-    PrintCentered(LINES/2-2, help);
+    help = "Iron (FE): " + resources.at(IRON).Print() + "";;
+    PrintCentered(renderer_->lines()/2-2, help);
     info = resources_name_mapping.at(resource) + ": FE" 
-      + std::to_string(player_one_->resources().at(resource).distributed_iron())
-      + ((player_one_->resources().at(resource).Active()) ? " (active)" : " (inactive)");
-    PrintCentered(LINES/2+1, info);
+      + std::to_string(resources.at(resource).distributed_iron())
+      + ((resources.at(resource).Active()) ? " (active)" : " (inactive)");
+    PrintCentered(renderer_->lines()/2+1, info);
 
     if (error != "") {
-      attron(COLOR_ERROR);
-      PrintCentered(LINES/2+2, error);
+      renderer_->SetColor(COLOR_ERROR);
+      PrintCentered(renderer_->lines()/2+2, error);
     }
     else if (success != "") {
-      attron(COLOR_SUCCESS);
-      PrintCentered(LINES/2+2, success);
+      renderer_->SetColor(COLOR_SUCCESS);
+      PrintCentered(renderer_->lines()/2+2, success);
     }
-    attron(COLOR_DEFAULT);
+    renderer_->SetColor(COLOR_DEFAULT);
     success = "";
     error = "";
 
     // Print resource circle.
     for (unsigned int i=0; i<symbols.size(); i++) {
-      if (player_one_->resources().at(resources_symbol_mapping.at(symbols[i])).Active())
-        attron(COLOR_PAIR(COLOR_SUCCESS));
+      if (resources.at(resources_symbol_mapping.at(symbols[i])).Active())
+        renderer_->SetColor(COLOR_SUCCESS);
       if (i == current)
-        attron(COLOR_PAIR(COLOR_MARKED));
-      mvaddstr(positions[i].first, positions[i].second, symbols[i].c_str());
-      attron(COLOR_PAIR(COLOR_DEFAULT));
-      refresh();
+        renderer_->SetColor(COLOR_MARKED);
+      renderer_->AddStr(positions[i].first, positions[i].second, symbols[i]);
+      renderer_->SetColor(COLOR_DEFAULT);
+      renderer_->Refresh();
     }
 
     // Get players choice.
-    char choice = getch();
+    int choice = renderer_->GetCh();
 
     if (utils::IsDown(choice))
       current = utils::Mod(current+1, symbols.size());
@@ -672,24 +590,36 @@ void Game::DistributeIron() {
     else if (choice == '+' || choice == '-') {
       int resource = (resources_symbol_mapping.count(current_symbol) > 0) 
         ? resources_symbol_mapping.at(current_symbol) : Resources::OXYGEN;
-      bool res = (choice == '+') ? player_one_->DistributeIron(resource) 
-        : player_one_->RemoveIron(resource);
-      if (res)
+      Resource iron = resources.at(IRON);
+      Resource selected = resources.at(resource);
+      if (choice == '+' && iron.cur() >= 1) {
+        simulation_->Submit(Command(DISTRIBUTE_IRON, {-1, -1}, resource));
+        selected.set_distribited_iron(selected.distributed_iron()+1);
+        iron.set_cur(iron.cur()-1);
+        iron.set_bound(iron.bound()+1);
         success = "Selected!";
+      }
+      else if (choice == '-' && selected.distributed_iron() > 0) {
+        simulation_->Submit(Command(REMOVE_IRON, {-1, -1}, resource));
+        selected.set_distribited_iron(selected.distributed_iron()-1);
+        iron.set_cur(iron.cur()+1);
+        iron.set_bound(iron.bound()-1);
+        success = "Selected!";
+      }
       else
         error = "Not enough iron.";
     }
-    else if (choice == 'q')
+    else if (choice == 'q' || choice == INPUT_END)
       end = true;
 
   }
   ClearField();
-  pause_ = false;
+  scheduler_.set_pause(false);
 }
 
 int Game::SelectInteger(std::string msg, bool omit, choice_mapping_t& mapping, std::vector<size_t> splits) {
-  spdlog::get(LOGGER)->debug("Game::SelectInteger: {}, size: {}", msg, mapping.size());
-  pause_ = true;
+  LOG_DEBUG(LOG_GAME, "Game::SelectInteger: {}, size: {}", msg, mapping.size());
+  scheduler_.set_pause(true);
   ClearField();
   bool end = false;
 
@@ -701,130 +631,133 @@ int Game::SelectInteger(std::string msg, bool omit, choice_mapping_t& mapping, s
     txt += ": " + option.second.first + "    ";
     options.push_back({txt, option.second.second});
   }
-  spdlog::get(LOGGER)->debug("Game::SelectInteger: created options {}", options.size());
+  LOG_DEBUG(LOG_GAME, "Game::SelectInteger: created options {}", options.size());
   
   // Print matching the splits.
-  spdlog::get(LOGGER)->debug("Game::SelectInteger: printing in splits {}", splits.size());
+  LOG_DEBUG(LOG_GAME, "Game::SelectInteger: printing in splits {}", splits.size());
   int counter = 0;
   int last_split = 0;
   for (const auto& split : splits) {
-    spdlog::get(LOGGER)->debug("Game::SelectInteger: printing upto split {}", split);
+    LOG_DEBUG(LOG_GAME, "Game::SelectInteger: printing upto split {}", split);
     std::vector<std::pair<std::string, int>> option_part; 
     for (unsigned int i=last_split; i<split && i<options.size(); i++)
       option_part.push_back(options[i]);
-    spdlog::get(LOGGER)->debug("Game::SelectInteger: printing {} parts", option_part.size());
-    PrintCenteredColored(LINES/2+(counter+=2), option_part);
+    LOG_DEBUG(LOG_GAME, "Game::SelectInteger: printing {} parts", option_part.size());
+    PrintCenteredColored(renderer_->lines()/2+(counter+=2), option_part);
     last_split = split;
   }
-  PrintCentered(LINES/2-1, msg);
-  PrintCentered(LINES/2+counter+3, "> enter number...");
+  PrintCentered(renderer_->lines()/2-1, msg);
+  PrintCentered(renderer_->lines()/2+counter+3, "> enter number...");
 
   while (!end) {
     // Get choice.
-    char choice = getch();
+    int choice = renderer_->GetCh();
     int int_choice = choice-'a';
-    if (choice == 'q' && omit)
+    if ((choice == 'q' && omit) || choice == INPUT_END)
       end = true;
     else if (mapping.count(int_choice) > 0 && (mapping.at(int_choice).second == COLOR_AVAILIBLE 
           || !omit)) {
-      pause_ = false;
-      spdlog::get(LOGGER)->debug("Game::SelectInteger: done, retuning: {}", int_choice);
+      scheduler_.set_pause(false);
+      LOG_DEBUG(LOG_GAME, "Game::SelectInteger: done, retuning: {}", int_choice);
       return int_choice;
     }
     else if (mapping.count(int_choice) > 0 && mapping.at(int_choice).second != COLOR_AVAILIBLE 
         && omit)
-      PrintCentered(LINES/2+counter+5, "Selection not available (not enough resources?): " 
+      PrintCentered(renderer_->lines()/2+counter+5, "Selection not available (not enough resources?): " 
           + std::to_string(int_choice));
     else 
-      PrintCentered(LINES/2+counter+5, "Wrong selection: " + std::to_string(int_choice));
+      PrintCentered(renderer_->lines()/2+counter+5, "Wrong selection: " + std::to_string(int_choice));
   }
-  pause_ = false;
+  scheduler_.set_pause(false);
   return -1;
 }
 
 void Game::PrintMessage(std::string msg, bool error) {
   if (error)
-    attron(COLOR_PAIR(COLOR_ERROR));
+    renderer_->SetColor(COLOR_ERROR);
   else
-    attron(COLOR_PAIR(COLOR_MSG));
+    renderer_->SetColor(COLOR_MSG);
   std::unique_lock ul(mutex_print_field_);
-  std::string clear_string(COLS, ' ');
-  mvaddstr(lines_+16, 0, clear_string.c_str());
-  mvaddstr(lines_+16, left_border_, msg.c_str());
-  attron(COLOR_PAIR(COLOR_DEFAULT));
-  refresh();
+  std::string clear_string(renderer_->cols(), ' ');
+  renderer_->AddStr(lines_+16, 0, clear_string);
+  renderer_->AddStr(lines_+16, left_border_, msg);
+  renderer_->SetColor(COLOR_DEFAULT);
+  renderer_->Refresh();
 }
 
 void Game::PrintFieldAndStatus() {
   std::unique_lock ul(mutex_print_field_);
   // mvaddstr(LINE_HELP, 10, HELP);
   PrintHelpLine();
-  field_->PrintField(player_one_, player_two_);
+  auto snapshot_one = player_one_->snapshot();
+  auto snapshot_two = player_two_->snapshot();
+  field_->PrintField(*snapshot_one, *snapshot_two, renderer_);
   
-  auto lines = player_one_->GetCurrentStatusLine();
+  auto lines = snapshot_one->GetCurrentStatusLine();
   for (unsigned int i=0; i<lines.size(); i++) {
-    mvaddstr(15+i, left_border_ + cols_*2 + 1, lines[i].c_str());
+    renderer_->AddStr(15+i, left_border_ + cols_*2 + 1, lines[i]);
   }
 
   PrintCentered(1, "DISSONANCE");
-  std::string msg = "Enemy potential: (" + player_two_->GetNucleusLive() + ")";
+  std::string msg = "Enemy potential: (" + snapshot_two->GetNucleusLive() + ")";
   PrintCentered(2, msg.c_str());
 
   // Clear music bar.
-  std::string clear_string(COLS, ' ');
+  std::string clear_string(renderer_->cols(), ' ');
   for (int i=4; i<13; i++)
-    mvaddstr(i, 0, clear_string.c_str());
+    renderer_->AddStr(i, 0, clear_string);
   // Print music bar.
-  auto played_levels = played_levels_;
+  auto played_levels = (simulation_) ? simulation_->played_levels() : std::vector<int>();
   int played_levels_len = played_levels.size();
   if (played_levels_len > cols_)
     played_levels = utils::SliceVector(played_levels, played_levels_len-cols_, cols_);
   double percent_played = static_cast<double>(played_levels_len*100)/audio_.analysed_data().data_per_beat_.size();
   if (percent_played < 50)
-    attron(COLOR_PAIR(COLOR_MSG));
+    renderer_->SetColor(COLOR_MSG);
   else if (percent_played < 80)
-    attron(COLOR_PAIR(COLOR_AVAILIBLE));
+    renderer_->SetColor(COLOR_AVAILIBLE);
   else
-    attron(COLOR_PAIR(COLOR_ERROR));
+    renderer_->SetColor(COLOR_ERROR);
   for (unsigned int i=0; i<played_levels.size(); i++) {
     int level = (played_levels[i]*4)/audio_.analysed_data().max_peak_;
     if (level > 4) level = 4;
     if (level < -4) level = -4;
-    mvaddstr(8+level, left_border_+cols_/2+i, "-");
+    renderer_->AddStr(8+level, left_border_+cols_/2+i, "-");
   }
-  attron(COLOR_DEFAULT);
+  renderer_->SetColor(COLOR_DEFAULT);
   
-  refresh();
+  renderer_->Refresh();
 }
 
 void Game::SetGameOver(std::string msg) {
   std::unique_lock ul(mutex_print_field_);
-  clear();
-  PrintCentered(LINES/2, msg);
-  refresh();
+  renderer_->Clear();
+  PrintCentered(renderer_->lines()/2, msg);
+  renderer_->Refresh();
   game_over_ = true;
+  scheduler_.Stop();
 }
 
 void Game::PrintCentered(texts::paragraphs_t paragraphs) {
   std::unique_lock ul(mutex_print_field_);
   for (const auto& paragraph : paragraphs) {
-    refresh();
-    clear();
+    renderer_->Refresh();
+    renderer_->Clear();
     int size = paragraph.size()/2;
     int counter = 0;
     for (const auto& line : paragraph) {
-      PrintCentered(LINES/2-size+(counter++), line);
+      PrintCentered(renderer_->lines()/2-size+(counter++), line);
     }
-    PrintCentered(LINES/2+size+2, "[Press any key to continue]");
-    char c = getch();
+    PrintCentered(renderer_->lines()/2+size+2, "[Press any key to continue]");
+    char c = renderer_->GetCh();
     c++;
   }
 }
 
 void Game::PrintCentered(int line, std::string txt) {
-  std::string clear_string(COLS, ' ');
-  mvaddstr(line, 0, clear_string.c_str());
-  mvaddstr(line, COLS/2-txt.length()/2, txt.c_str());
+  std::string clear_string(renderer_->cols(), ' ');
+  renderer_->AddStr(line, 0, clear_string);
+  renderer_->AddStr(line, renderer_->cols()/2-txt.length()/2, txt);
 }
 
 void Game::PrintCenteredColored(int line, std::vector<std::pair<std::string, int>> txt_with_color) {
@@ -834,39 +767,40 @@ void Game::PrintCenteredColored(int line, std::vector<std::pair<std::string, int
     total_length += it.first.length();
 
   // Print parts one by one and update color for each part.
-  unsigned int position = COLS/2-total_length/2;
+  unsigned int position = renderer_->cols()/2-total_length/2;
   for (const auto& it : txt_with_color) {
-    attron(COLOR_PAIR(it.second));
-    mvaddstr(line, position, it.first.c_str());
+    renderer_->SetColor(it.second);
+    renderer_->AddStr(line, position, it.first);
     position += it.first.length();
-    attron(COLOR_PAIR(COLOR_DEFAULT));
+    renderer_->SetColor(COLOR_DEFAULT);
   }
 }
 
 void Game::PrintHelpLine() {
 
+  auto snapshot = player_one_->snapshot();
   bool technology_availible = false;
-  for (const auto& it : player_one_->technologies()) {
-    if (player_one_->GetMissingResources(it.first).size() == 0 && it.second.first < it.second.second) {
+  for (const auto& it : *snapshot->technologies_) {
+    if (snapshot->GetMissingResources(it.first) == 0 && it.second.first < it.second.second) {
       technology_availible = true;
       break;
     }
   }
 
   std::vector<std::pair<std::string, bool>> parts;
-  parts.push_back({"[e]psp", player_one_->GetMissingResources(UnitsTech::EPSP).size() == 0 
-      && player_one_->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size() > 0});
+  parts.push_back({"[e]psp", snapshot->GetMissingResources<UnitsTech::EPSP>() == 0 
+      && snapshot->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size() > 0});
   parts.push_back({", ", false});
-  parts.push_back({"[i]psp", player_one_->GetMissingResources(UnitsTech::IPSP).size() == 0 
-      && player_one_->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size() > 0});
+  parts.push_back({"[i]psp", snapshot->GetMissingResources<UnitsTech::IPSP>() == 0 
+      && snapshot->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size() > 0});
   parts.push_back({" | ", false});
-  parts.push_back({"[A]ctivated neuron", player_one_->GetMissingResources(UnitsTech::ACTIVATEDNEURON).size() == 0});
+  parts.push_back({"[A]ctivated neuron", snapshot->GetMissingResources<UnitsTech::ACTIVATEDNEURON>() == 0});
   parts.push_back({", ", false});
-  parts.push_back({"[S]ynapse", player_one_->GetMissingResources(UnitsTech::SYNAPSE).size() == 0});
+  parts.push_back({"[S]ynapse", snapshot->GetMissingResources<UnitsTech::SYNAPSE>() == 0});
   parts.push_back({" | ", false});
-  parts.push_back({"[d]istribute iron", player_one_->resources().at(Resources::IRON).cur() > 0});
+  parts.push_back({"[d]istribute iron", snapshot->resources_.at(Resources::IRON).cur() > 0});
   parts.push_back({", ", false});
-  parts.push_back({"[s]elect synapse", player_one_->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size() > 0});
+  parts.push_back({"[s]elect synapse", snapshot->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size() > 0});
   parts.push_back({", ", false});
   parts.push_back({"[t]echnology", technology_availible});
   parts.push_back({" | [h]elp, pause [space], [q]uit", false});
@@ -879,8 +813,8 @@ void Game::PrintHelpLine() {
 
 void Game::ClearField() {
   std::unique_lock ul(mutex_print_field_);
-  clear();
-  refresh();
+  renderer_->Clear();
+  renderer_->Refresh();
 }
 
 std::string Game::SelectAudio() {
@@ -893,7 +827,7 @@ std::string Game::SelectAudio() {
   unsigned int selected = 0;
   int level = 0;
   unsigned int print_start = 0;
-  unsigned int max = LINES/2;
+  unsigned int max = renderer_->lines()/2;
   std::vector<std::pair<std::string, std::string>> visible_options;
 
   while(true) {
@@ -904,20 +838,22 @@ std::string Game::SelectAudio() {
     PrintCentered(11, selector.path_);
     PrintCentered(12, help);
 
-    attron(COLOR_PAIR(COLOR_ERROR));
+    renderer_->SetColor(COLOR_ERROR);
     PrintCentered(13, error);
     error = "";
-    attron(COLOR_PAIR(COLOR_DEFAULT));
+    renderer_->SetColor(COLOR_DEFAULT);
 
     for (unsigned int i=0; i<visible_options.size(); i++) {
       if (i == selected)
-        attron(COLOR_PAIR(COLOR_MARKED));
+        renderer_->SetColor(COLOR_MARKED);
       PrintCentered(15 + i, visible_options[i].second);
-      attron(COLOR_PAIR(COLOR_DEFAULT));
+      renderer_->SetColor(COLOR_DEFAULT);
     }
 
-    // Get players choice.
-    char choice = getch();
+    // Get players choice (no song selected, if there is no more input).
+    int choice = renderer_->GetCh();
+    if (choice == INPUT_END)
+      return "";
     if (utils::IsRight(choice)) {
       level++;
       if (visible_options[selected].first == "dissonance_recently_played")
@@ -1018,22 +954,20 @@ Game::AudioSelector Game::SetupAudioSelector(std::string path, std::string title
 
 std::string Game::InputString(std::string msg) {
   ClearField();
-  PrintCentered(LINES/2, msg.c_str());
-  echo();
-  curs_set(1);
+  PrintCentered(renderer_->lines()/2, msg.c_str());
+  renderer_->ShowInput(true);
   std::string input;
-  int ch = getch();
-  while (ch != '\n') {
+  int ch = renderer_->GetCh();
+  while (ch != '\n' && ch != INPUT_END) {
     input.push_back(ch);
-    ch = getch();
+    ch = renderer_->GetCh();
   }
-  noecho();
-  curs_set(0);
+  renderer_->ShowInput(false);
   return input;
 }
 
 position_t Game::SelectNucleus(Player*) {
-  auto all_neuron_positions = player_one_->GetAllPositionsOfNeurons(UnitsTech::NUCLEUS);
+  auto all_neuron_positions = player_one_->snapshot()->GetAllPositionsOfNeurons(UnitsTech::NUCLEUS);
   position_t nucleus_pos = {-1, -1};
   if (all_neuron_positions.size() > 1)
     nucleus_pos = SelectNeuron(player_one_, UnitsTech::NUCLEUS);
@@ -2,7 +2,6 @@
 #define SRC_GAME_H_
 
 #include <cstddef>
-#include <curses.h>
 #include <mutex>
 #include <string>
 #include <stdio.h>
@@ -11,12 +10,16 @@
 #include <vector>
 
 #include "audio/audio.h"
+#include "game/replay.h"
+#include "game/scheduler.h"
+#include "game/simulation.h"
 #include "constants/texts.h"
 #include "game/field.h"
 #include "player/audio_ki.h"
 #include "player/player.h"
 #include "objects/units.h"
 #include "random/random.h"
+#include "render/renderer.h"
 
 class Game {
   public:
@@ -24,21 +27,43 @@ class Game {
      * Constructor initializing game with availible lines and columns.
      * @param[in] lines availible lines.
      * @param[in] cols availible cols
+     * @param[in] left_border
+     * @param[in] audio_base_path
+     * @param[in] renderer used for all in- and output.
      */
-    Game(int lines, int cols, int left_border, std::string audio_base_path);
+    Game(int lines, int cols, int left_border, std::string audio_base_path, Renderer* renderer);
 
     /**
      * Starts game.
      */
     void play();
 
+    /**
+     * Re-runs recorded match.
+     * @param[in] replay
+     * @param[in] speed multiplier of game-time.
+     * @throws std::logic_error if analysis of song changed since recording.
+     */
+    void PlayReplay(const Replay& replay, double speed);
+
   private: 
+    /**
+     * Timers used by the game-threads.
+     */
+    enum Timers {
+      RENDER,
+    };
+
+    Renderer* renderer_;
     Field* field_;
     Player* player_one_;
     AudioKi* player_two_;
+    Simulation* simulation_;
     bool game_over_;
-    bool pause_;
     bool resigned_;
+    bool replay_;  ///< replaying recorded match (no player input).
+    double speed_;  ///< multiplier of game-time.
+    Scheduler scheduler_;
     Audio audio_;
     const std::string base_path_;
     std::vector<std::string> audio_paths_;
@@ -49,19 +74,11 @@ class Game {
 
     int difficulty_;
 
-    std::vector<int> played_levels_;
-
     std::shared_mutex mutex_print_field_;  ///< mutex locked, when printing field.
 
     /**
-     * Constantly checks whether to do actions (Runs as thread).
-     * Actions might be:
-     * - increase player resources
-     * - move soldiers (player and ki)
-     * - handle defence actions (remove soldiers when hit by tower).
-     * - ki: add new soldier
-     * - ki: add defence tower
-     * - ki: lower time to add new soldier/ defence tower.
+     * Sleeps until next render update is due, runs all simulation ticks up to
+     * current game-time and renders field (Runs as thread).
      */
     void RenderField();
 
@@ -77,11 +94,6 @@ class Game {
 
     void DistributeIron();
 
-    /**
-     * Handles ki-towers and soldiers.
-     */
-    void HandleActions();
-
     /**
      * Print help line, field and status player's status line.
      */
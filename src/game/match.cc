@@ -0,0 +1,89 @@
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "game/match.h"
+#include "constants/codes.h"
+#include "random/random.h"
+#include "spdlog/spdlog.h"
+#include "utils/logger.h"
+
+
+Match CreateMatch(Audio* audio, int lines, int cols, int left_border, unsigned int seed, bool ki_vs_ki) {
+  if (audio->analysed_data().data_per_beat_.empty())
+    throw std::invalid_argument("CreateMatch: song has no beats.");
+  // Build field.
+  RandomGenerator* ran_gen = new RandomGenerator(audio->analysed_data(), &RandomGenerator::ran_note, seed);
+  RandomGenerator* map_1 = new RandomGenerator(audio->analysed_data(), 
+      &RandomGenerator::ran_boolean_minor_interval, seed);
+  RandomGenerator* map_2 = new RandomGenerator(audio->analysed_data(), &RandomGenerator::ran_level_peaks, seed);
+  LOG_INFO(LOG_GAME, "CreateMatch: creating map");
+  Field* field = new Field(lines, cols, ran_gen, left_border);
+  field->AddHills(map_1, map_2, 0);
+  int player_one_section = (int)audio->analysed_data().average_bpm_%8+1;
+  int player_two_section = (int)audio->analysed_data().average_level_%8+1;
+  if (player_one_section == player_two_section)
+    player_two_section = player_two_section%8+1;
+  // Nuclei are placed in connected positions, so graph can always be build.
+  auto [nucleus_pos_1, nucleus_pos_2] = field->AddNuclei(player_one_section, player_two_section);
+  field->BuildGraph(nucleus_pos_1, nucleus_pos_2);
+  auto resource_positions_1 = field->AddResources(nucleus_pos_1);
+  auto resource_positions_2 = field->AddResources(nucleus_pos_2);
+
+  // Setup players.
+  std::vector<AudioKi*> kis;
+  Player* player_one = nullptr;
+  if (ki_vs_ki) {
+    kis.push_back(new AudioKi(nucleus_pos_1, field, audio, ran_gen, resource_positions_1));
+    player_one = kis.back();
+  }
+  else
+    player_one = new Player(nucleus_pos_1, field, ran_gen, resource_positions_1);
+  AudioKi* player_two = new AudioKi(nucleus_pos_2, field, audio, ran_gen, resource_positions_2);
+  kis.push_back(player_two);
+  player_one->set_enemy(player_two);
+  player_two->set_enemy(player_one);
+
+  // Let kis distribute initial iron.
+  for (const auto& ki : kis) {
+    ki->SetUpTactics(true); 
+    ki->DistributeIron(Resources::OXYGEN);
+    ki->DistributeIron(Resources::OXYGEN);
+    ki->HandleIron(audio->analysed_data().data_per_beat_.front());
+  }
+
+  Simulation* simulation = new Simulation(audio, field, player_one, player_two, kis);
+  return {field, player_one, player_two, simulation, {ran_gen, map_1, map_2}};
+}
+
+void DestroyMatch(Match& match) {
+  delete match.simulation_;
+  delete match.player_one_;
+  delete match.player_two_;
+  delete match.field_;
+  for (const auto& ran_gen : match.ran_gens_)
+    delete ran_gen;
+  match = {nullptr, nullptr, nullptr, nullptr, {}};
+}
+
+nlohmann::json GetMatchResult(Match& match) {
+  std::string winner = "none";
+  if (match.player_two_->HasLost())
+    winner = "player_one";
+  else if (match.player_one_->HasLost() || match.simulation_->resigned())
+    winner = "player_two";
+  nlohmann::json result = {{"winner", winner}, {"ticks", match.simulation_->tick()}, 
+    {"game_time_ms", match.simulation_->GameTime()}, {"phases_ms", match.simulation_->phase_times()}};
+  std::vector<std::pair<std::string, Player*>> players = {{"player_one", match.player_one_}, 
+    {"player_two", match.player_two_}};
+  for (const auto& [name, player] : players) {
+    result["units_built"][name] = nlohmann::json::object();
+    for (const auto& [unit, num] : player->units_built()) {
+      std::string unit_name = (units_tech_mapping.count(unit) > 0) ? units_tech_mapping.at(unit) 
+        : std::to_string(unit);
+      result["units_built"][name][unit_name] = num;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,53 @@
+#ifndef SRC_GAME_MATCH_H_
+#define SRC_GAME_MATCH_H_
+
+#include <vector>
+
+#include "audio/audio.h"
+#include "nlohmann/json.hpp"
+#include "game/field.h"
+#include "game/simulation.h"
+#include "player/audio_ki.h"
+#include "player/player.h"
+#include "random/random.h"
+
+/**
+ * Map, players and simulation of one match.
+ */
+struct Match {
+  Field* field_;
+  Player* player_one_;  ///< ki too, if match is ki against ki.
+  AudioKi* player_two_;
+  Simulation* simulation_;
+  std::vector<RandomGenerator*> ran_gens_;  ///< owned by match (used by field and players).
+};
+
+/**
+ * Creates map and players for analysed song. Same song, map-size and seed
+ * always create the same match.
+ * @param[in] audio with analysed song.
+ * @param[in] lines of map.
+ * @param[in] cols of map.
+ * @param[in] left_border of map.
+ * @param[in] seed for random numbers not based on song.
+ * @param[in] ki_vs_ki if set, player one is a ki too.
+ * @return match (kis' initial iron is distributed, human player's is not).
+ * @throws std::invalid_argument if song has no beats.
+ */
+Match CreateMatch(Audio* audio, int lines, int cols, int left_border, unsigned int seed, bool ki_vs_ki=false);
+
+/**
+ * Frees map, players, simulation and random generators of match.
+ * @param[in] match
+ */
+void DestroyMatch(Match& match);
+
+/**
+ * Gets result of (finished) match: winner, duration, units built by each
+ * player and real time spent in each phase of the simulation.
+ * @param[in] match
+ * @return result as json.
+ */
+nlohmann::json GetMatchResult(Match& match);
+
+#endif
@@ -0,0 +1,65 @@
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "game/path_cache.h"
+
+PathCache::PathCache(size_t capacity) : capacity_(capacity), version_(0), hits_(0), misses_(0) {}
+
+size_t PathCache::size() {
+  std::unique_lock ul(mutex_);
+  return entries_.size();
+}
+
+size_t PathCache::hits() const {
+  return hits_;
+}
+
+size_t PathCache::misses() const {
+  return misses_;
+}
+
+path_t PathCache::Get(position_t start, const std::vector<position_t>& way_points, unsigned int version) {
+  std::unique_lock ul(mutex_);
+  UpdateVersion(version);
+  auto it = index_.find({start, way_points});
+  if (it == index_.end()) {
+    misses_++;
+    return nullptr;
+  }
+  // Mark as most recently used.
+  entries_.splice(entries_.begin(), entries_, it->second);
+  hits_++;
+  return it->second->second;
+}
+
+void PathCache::Put(position_t start, const std::vector<position_t>& way_points, unsigned int version, 
+    path_t way) {
+  std::unique_lock ul(mutex_);
+  UpdateVersion(version);
+  if (version != version_ || capacity_ == 0)
+    return;
+  key_t key = {start, way_points};
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->second = way;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (entries_.size() >= capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.push_front({key, way});
+  index_[key] = entries_.begin();
+}
+
+void PathCache::UpdateVersion(unsigned int version) {
+  if (version <= version_)
+    return;
+  entries_.clear();
+  index_.clear();
+  version_ = version;
+}
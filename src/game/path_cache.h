@@ -0,0 +1,70 @@
+#ifndef SRC_GAME_PATH_CACHE_H_
+#define SRC_GAME_PATH_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "utils/pathfinder.h"
+
+/**
+ * Least-recently-used cache of ways, keyed by start-position and way-points
+ * (last way-point being the target). Every entry belongs to a map-version:
+ * once a lookup uses a newer version, all older ways are dropped.
+ * Thread-safe.
+ */
+class PathCache {
+  public:
+    /**
+     * Constructor.
+     * @param[in] capacity maximum number of cached ways.
+     */
+    PathCache(size_t capacity);
+
+    // getter:
+    size_t size();
+    size_t hits() const;
+    size_t misses() const;
+
+    /**
+     * Gets cached way.
+     * @param[in] start
+     * @param[in] way_points
+     * @param[in] version current map-version.
+     * @return cached way or nullptr if not found.
+     */
+    path_t Get(position_t start, const std::vector<position_t>& way_points, unsigned int version);
+
+    /**
+     * Adds way to cache (removing least recently used way, if cache is full).
+     * @param[in] start
+     * @param[in] way_points
+     * @param[in] version map-version way was calculated with.
+     * @param[in] way
+     */
+    void Put(position_t start, const std::vector<position_t>& way_points, unsigned int version, path_t way);
+
+  private:
+    typedef std::pair<position_t, std::vector<position_t>> key_t;
+    typedef std::list<std::pair<key_t, path_t>> entries_t;
+
+    const size_t capacity_;
+    unsigned int version_;
+    entries_t entries_;  ///< most recently used first.
+    std::map<key_t, entries_t::iterator> index_;
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+    std::mutex mutex_;
+
+    /**
+     * Drops all entries if given version is newer than version of entries.
+     * Expects mutex to be locked.
+     * @param[in] version
+     */
+    void UpdateVersion(unsigned int version);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "game/replay.h"
+#include "nlohmann/json.hpp"
+#include "utils/utils.h"
+
+void Replay::Save(std::string path) const {
+  nlohmann::json data = {{"song", song_}, {"analysis_hash", analysis_hash_}, {"seed", seed_}, 
+    {"lines", lines_}, {"cols", cols_}};
+  data["commands"] = nlohmann::json::array();
+  for (const auto& [tick, cmd] : commands_) {
+    data["commands"].push_back({tick, cmd.type_, cmd.pos_.first, cmd.pos_.second, cmd.unit_, 
+        cmd.target_.first, cmd.target_.second});
+  }
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+  utils::WriteJsonFromDisc(path, data);
+}
+
+Replay Replay::Load(std::string path) {
+  nlohmann::json data = utils::LoadJsonFromDisc(path);
+  if (!data.is_object() || !data.contains("commands"))
+    throw std::logic_error("Replay::Load: no valid replay: " + path);
+  Replay replay;
+  replay.song_ = data["song"];
+  replay.analysis_hash_ = data["analysis_hash"];
+  replay.seed_ = data["seed"];
+  replay.lines_ = data["lines"];
+  replay.cols_ = data["cols"];
+  for (const auto& it : data["commands"]) {
+    replay.commands_.push_back({it[0], Command(it[1], {it[2], it[3]}, it[4], {it[5], it[6]})});
+  }
+  return replay;
+}
+
+std::string Replay::HashAnalysis(const AudioData& analysed_data) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](int64_t value) {
+    for (int i=0; i<8; i++) {
+      hash ^= (value >> (i*8)) & 0xff;
+      hash *= 1099511628211ULL;
+    }
+  };
+  for (const auto& it : analysed_data.data_per_beat_) {
+    add(std::llround(it.time_*1000));
+    add(it.bpm_);
+    add(it.level_);
+    for (const auto& note : it.notes_)
+      add(note.midi_note_);
+  }
+  std::stringstream ss;
+  ss << std::hex << hash;
+  return ss.str();
+}
@@ -0,0 +1,47 @@
+#ifndef SRC_GAME_REPLAY_H_
+#define SRC_GAME_REPLAY_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "audio/audio.h"
+#include "game/simulation.h"
+
+/**
+ * Everything needed to re-run a match: song (checked against hash of its
+ * analysis), map-size, seed and all commands with the tick they were applied
+ * before. Stored as compact json (one array per command).
+ */
+struct Replay {
+  std::string song_;
+  std::string analysis_hash_;
+  unsigned int seed_;
+  int lines_;
+  int cols_;
+  std::vector<std::pair<unsigned int, Command>> commands_;
+
+  /**
+   * Writes replay to disc.
+   * @param[in] path
+   */
+  void Save(std::string path) const;
+
+  /**
+   * Loads replay from disc.
+   * @param[in] path
+   * @return replay.
+   * @throws std::logic_error if file is no valid replay.
+   */
+  static Replay Load(std::string path);
+
+  /**
+   * Hashes analysed data of a song (FNV-1a over all beats), so replays detect
+   * a changed analysis.
+   * @param[in] analysed_data
+   * @return hash as hex-string.
+   */
+  static std::string HashAnalysis(const AudioData& analysed_data);
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "game/scheduler.h"
+
+Scheduler::Scheduler() : start_(std::chrono::steady_clock::now()), pause_start_(start_), time_in_pause_(0),
+  paused_(false), stopped_(false), notifications_(0) {}
+
+bool Scheduler::paused() {
+  std::unique_lock ul(mutex_);
+  return paused_;
+}
+
+bool Scheduler::stopped() {
+  std::unique_lock ul(mutex_);
+  return stopped_;
+}
+
+void Scheduler::set_pause(bool pause) {
+  std::unique_lock ul(mutex_);
+  if (pause == paused_)
+    return;
+  auto now = std::chrono::steady_clock::now();
+  if (pause)
+    pause_start_ = now;
+  else
+    time_in_pause_ += std::chrono::duration<double, std::milli>(now - pause_start_).count();
+  paused_ = pause;
+  notifications_++;
+  cv_.notify_all();
+}
+
+void Scheduler::Start() {
+  std::unique_lock ul(mutex_);
+  start_ = std::chrono::steady_clock::now();
+  pause_start_ = start_;
+  time_in_pause_ = 0;
+  timers_.clear();
+}
+
+void Scheduler::Stop() {
+  std::unique_lock ul(mutex_);
+  stopped_ = true;
+  cv_.notify_all();
+}
+
+void Scheduler::Notify() {
+  std::unique_lock ul(mutex_);
+  notifications_++;
+  cv_.notify_all();
+}
+
+double Scheduler::GameTime() {
+  std::unique_lock ul(mutex_);
+  return GameTime(std::chrono::steady_clock::now());
+}
+
+void Scheduler::Schedule(int timer, double game_time) {
+  std::unique_lock ul(mutex_);
+  timers_[timer] = game_time;
+  cv_.notify_all();
+}
+
+std::vector<int> Scheduler::WaitForDue(const std::vector<int>& timers) {
+  std::unique_lock ul(mutex_);
+  unsigned int notifications = notifications_;
+  while (!stopped_ && notifications == notifications_) {
+    if (paused_) {
+      cv_.wait(ul);
+      continue;
+    }
+    // Get earliest of the requested timers.
+    bool found = false;
+    double earliest = 0;
+    for (const auto& timer : timers) {
+      if (timers_.count(timer) > 0 && (!found || timers_.at(timer) < earliest)) {
+        earliest = timers_.at(timer);
+        found = true;
+      }
+    }
+    if (!found) {
+      cv_.wait(ul);
+      continue;
+    }
+    // Return all due timers or sleep until earliest is due.
+    double game_time = GameTime(std::chrono::steady_clock::now());
+    if (earliest <= game_time) {
+      std::vector<int> due;
+      for (const auto& timer : timers) {
+        if (timers_.count(timer) > 0 && timers_.at(timer) <= game_time) {
+          due.push_back(timer);
+          timers_.erase(timer);
+        }
+      }
+      return due;
+    }
+    cv_.wait_until(ul, ToTimePoint(earliest));
+  }
+  return {};
+}
+
+bool Scheduler::SleepFor(double ms) {
+  std::unique_lock ul(mutex_);
+  double until = GameTime(std::chrono::steady_clock::now()) + ms;
+  while (!stopped_) {
+    if (paused_) {
+      cv_.wait(ul);
+      continue;
+    }
+    if (GameTime(std::chrono::steady_clock::now()) >= until)
+      return true;
+    cv_.wait_until(ul, ToTimePoint(until));
+  }
+  return false;
+}
+
+double Scheduler::GameTime(std::chrono::steady_clock::time_point now) const {
+  if (paused_)
+    now = pause_start_;
+  return std::chrono::duration<double, std::milli>(now - start_).count() - time_in_pause_;
+}
+
+std::chrono::steady_clock::time_point Scheduler::ToTimePoint(double game_time) const {
+  auto offset = std::chrono::duration<double, std::milli>(game_time + time_in_pause_);
+  return start_ + std::chrono::ceil<std::chrono::steady_clock::duration>(offset);
+}
@@ -0,0 +1,101 @@
+#ifndef SRC_GAME_SCHEDULER_H_
+#define SRC_GAME_SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Game clock and timer queue.
+ * Threads sleep on a condition variable until one of their timers is due
+ * instead of polling the clock. All times are game-times: milliseconds since
+ * Start() not counting pauses, so no timer runs out while the game is paused.
+ */
+class Scheduler {
+  public:
+    Scheduler();
+
+    // getter:
+    bool paused();
+    bool stopped();
+
+    // setter:
+    /**
+     * Pauses/ unpauses game-clock and wakes all waiting threads.
+     * @param[in] pause
+     */
+    void set_pause(bool pause);
+
+    // methods:
+    /**
+     * (Re-)starts game-clock at game-time 0.
+     */
+    void Start();
+
+    /**
+     * Stops scheduler: all waiting threads are woken up and no further waits
+     * will block.
+     */
+    void Stop();
+
+    /**
+     * Wakes up all waiting threads without any timer being due (f.e. after
+     * input changed the game state).
+     */
+    void Notify();
+
+    /**
+     * Gets current game-time.
+     * @return milliseconds since start, not counting pauses.
+     */
+    double GameTime();
+
+    /**
+     * Adds timer or moves timer to new game-time.
+     * @param[in] timer id of timer.
+     * @param[in] game_time at which timer is due.
+     */
+    void Schedule(int timer, double game_time);
+
+    /**
+     * Blocks until at least one of the given timers is due. While paused, no
+     * timer is due.
+     * @param[in] timers ids of timers to wait for.
+     * @return due timers (removed from queue), empty if woken up by pause,
+     * Notify() or Stop().
+     */
+    std::vector<int> WaitForDue(const std::vector<int>& timers);
+
+    /**
+     * Sleeps for given game-time (returns early if stopped).
+     * @param[in] ms milliseconds to sleep.
+     * @return false if stopped.
+     */
+    bool SleepFor(double ms);
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<int, double> timers_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point pause_start_;
+    double time_in_pause_;
+    bool paused_;
+    bool stopped_;
+    unsigned int notifications_;
+
+    /**
+     * Gets game-time (mutex must be locked).
+     */
+    double GameTime(std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * Converts game-time to time-point (assuming no pause in between, mutex
+     * must be locked).
+     */
+    std::chrono::steady_clock::time_point ToTimePoint(double game_time) const;
+};
+
+#endif
@@ -0,0 +1,232 @@
+#include <chrono>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "game/simulation.h"
+#include "constants/codes.h"
+#include "spdlog/spdlog.h"
+#include "utils/logger.h"
+
+
+Simulation::Simulation(Audio* audio, Field* field, Player* player_one, Player* player_two, 
+    std::vector<AudioKi*> kis) : audio_(audio), field_(field), player_one_(player_one), player_two_(player_two), 
+  kis_(kis), data_per_beat_(audio->analysed_data().data_per_beat_), tick_(0), resigned_(false), off_notes_(false), 
+  phase_ms_(Phases::NUM_PHASES, 0) {
+  // Until first beat, updates are based on first beat's bpm.
+  double bpm = (data_per_beat_.size() > 0) ? data_per_beat_.front().bpm_ : 0;
+  move_frequency_ = 40;
+  player_resource_frequency_ = bpm;
+  ki_resource_frequency_ = bpm;
+  next_move_ = move_frequency_;
+  next_player_resources_ = player_resource_frequency_;
+  next_ki_resources_ = ki_resource_frequency_;
+}
+
+unsigned int Simulation::tick() {
+  return tick_;
+}
+
+bool Simulation::resigned() {
+  return resigned_;
+}
+
+double Simulation::render_frequency() {
+  return move_frequency_;
+}
+
+std::vector<int> Simulation::played_levels() {
+  std::unique_lock ul(mutex_played_levels_);
+  return played_levels_;
+}
+
+std::vector<std::pair<unsigned int, Command>> Simulation::commands() {
+  return commands_;
+}
+
+double Simulation::GameTime() {
+  return static_cast<double>(tick_)*TICK_MS;
+}
+
+bool Simulation::Finished() {
+  return resigned_ || player_one_->HasLost() || player_two_->HasLost() || data_per_beat_.size() == 0;
+}
+
+void Simulation::Tick() {
+  auto start = std::chrono::steady_clock::now();
+  // Apply scheduled and submitted commands (before game-time advances, just
+  // as commands executed between two ticks).
+  while (scheduled_commands_.size() > 0 && scheduled_commands_.front().first <= tick_) {
+    Apply(scheduled_commands_.front().second);
+    scheduled_commands_.pop_front();
+  }
+  while (auto command = submitted_commands_.Pop())
+    Apply(*command);
+  Measure(Phases::COMMANDS, start);
+  // Match ended with resign (before this tick).
+  if (resigned_)
+    return;
+
+  double game_time = static_cast<double>(tick_)*TICK_MS;
+  player_one_->set_game_time(game_time);
+  player_two_->set_game_time(game_time);
+
+  // Handle beats due.
+  while (data_per_beat_.size() > 0 && data_per_beat_.front().time_ <= game_time) {
+    HandleBeat(data_per_beat_.front());
+    data_per_beat_.pop_front();
+  }
+  Measure(Phases::BEATS, start);
+
+  // Increase resources.
+  if (game_time >= next_player_resources_) {
+    player_one_->IncreaseResources(off_notes_);
+    next_player_resources_ = game_time + player_resource_frequency_;
+  }
+  if (game_time >= next_ki_resources_) {
+    player_two_->IncreaseResources(off_notes_);
+    next_ki_resources_ = game_time + ki_resource_frequency_;
+  }
+  Measure(Phases::RESOURCES, start);
+
+  // Run ki actions spanning over time (f.e. launching attacks).
+  for (const auto& ki : kis_)
+    ki->RunJobs();
+  Measure(Phases::KI_JOBS, start);
+
+  if (game_time >= next_move_) {
+    // Move soldiers and check if enemy den's lp is down to 0.
+    player_one_->MovePotential(player_two_);
+    player_two_->MovePotential(player_one_);
+    HandleCollisions();
+    Measure(Phases::MOVE, start);
+    // Publish state of this tick for defence, renderer and ki.
+    player_one_->PublishSnapshot();
+    player_two_->PublishSnapshot();
+    Measure(Phases::SNAPSHOT, start);
+    // Remove enemy soldiers in range of defence towers.
+    player_one_->HandleDef(player_two_);
+    player_two_->HandleDef(player_one_);
+    Measure(Phases::DEFENCE, start);
+    next_move_ = game_time + move_frequency_;
+  }
+  tick_++;
+}
+
+void Simulation::RunToEnd() {
+  while (!Finished())
+    Tick();
+}
+
+void Simulation::HandleBeat(const AudioDataTimePoint& data_at_beat) {
+  move_frequency_ = 60000.0/(data_at_beat.bpm_*16);
+  ki_resource_frequency_ = 60000.0/data_at_beat.bpm_;
+  player_resource_frequency_ = 60000.0/(static_cast<double>(data_at_beat.bpm_)/2);
+  off_notes_ = audio_->MoreOffNotes(data_at_beat);
+  std::unique_lock ul(mutex_played_levels_);
+  played_levels_.push_back(audio_->analysed_data().average_level_-data_at_beat.level_);
+  ul.unlock();
+  for (const auto& ki : kis_)
+    ki->DoAction(data_at_beat);
+}
+
+std::map<std::string, double> Simulation::phase_times() {
+  std::map<std::string, double> phase_times;
+  std::vector<std::string> names = {"commands", "beats", "resources", "ki_jobs", "move", "snapshot", "defence"};
+  for (size_t i=0; i<names.size(); i++)
+    phase_times[names[i]] = phase_ms_[i];
+  return phase_times;
+}
+
+void Simulation::HandleCollisions() {
+  // First epsp and ipsp of each player at each position of a potential.
+  auto potentials_by_position = [](const SlotMap<Potential>& potentials) {
+    std::map<position_t, std::map<int, SlotHandle>> by_position;
+    for (size_t i=0; i<potentials.size(); i++) {
+      const auto& potential = potentials.values()[i];
+      by_position[potential.pos_].emplace(potential.type_, potentials.handle(i));
+    }
+    return by_position;
+  };
+  auto potentials_one = potentials_by_position(player_one_->potential());
+  auto potentials_two = potentials_by_position(player_two_->potential());
+  for (const auto& [pos, one] : potentials_one) {
+    if (potentials_two.count(pos) == 0)
+      continue;
+    const auto& two = potentials_two.at(pos);
+    if (one.count(UnitsTech::EPSP) > 0 && two.count(UnitsTech::IPSP) > 0) {
+      player_one_->NeutralizePotential(one.at(UnitsTech::EPSP), 1);
+      player_two_->NeutralizePotential(two.at(UnitsTech::IPSP), -1);  // -1: increase potential.
+    }
+    else if (one.count(UnitsTech::IPSP) > 0 && two.count(UnitsTech::EPSP) > 0) {
+      player_one_->NeutralizePotential(one.at(UnitsTech::IPSP), -1);
+      player_two_->NeutralizePotential(two.at(UnitsTech::EPSP), 1);
+    }
+  }
+}
+
+void Simulation::Measure(int phase, std::chrono::steady_clock::time_point& start) {
+  auto now = std::chrono::steady_clock::now();
+  phase_ms_[phase] += std::chrono::duration<double, std::milli>(now - start).count();
+  start = now;
+}
+
+bool Simulation::Execute(const Command& cmd) {
+  return Apply(cmd);
+}
+
+void Simulation::Submit(Command cmd) {
+  submitted_commands_.Push(std::move(cmd));
+}
+
+void Simulation::ScheduleCommands(const std::vector<std::pair<unsigned int, Command>>& commands) {
+  scheduled_commands_.insert(scheduled_commands_.end(), commands.begin(), commands.end());
+  // Stable, so commands of the same tick keep their order.
+  scheduled_commands_.sort([](const auto& a, const auto& b) { return a.first < b.first; });
+}
+
+bool Simulation::Apply(const Command& cmd) {
+  LOG_DEBUG(LOG_SIMULATION, "Simulation::Apply: command {} before tick {}", cmd.type_, tick_);
+  commands_.push_back({tick_, cmd});
+  if (cmd.type_ == ADD_POTENTIAL)
+    return player_one_->AddPotential(cmd.pos_, cmd.unit_);
+  if (cmd.type_ == ADD_NEURON) {
+    position_t epsp_target = {-1, -1};
+    position_t ipsp_target = {-1, -1};
+    if (cmd.unit_ == UnitsTech::SYNAPSE) {
+      epsp_target = player_two_->GetOneNucleus();
+      ipsp_target = player_two_->GetRandomNeuron(); // random tower.
+    }
+    if (!player_one_->AddNeuron(cmd.pos_, cmd.unit_, epsp_target, ipsp_target))
+      return false;
+    field_->AddNewUnitToPos(cmd.pos_, cmd.unit_);
+    return true;
+  }
+  if (cmd.type_ == ADD_TECHNOLOGY)
+    return player_one_->AddTechnology(cmd.unit_);
+  if (cmd.type_ == DISTRIBUTE_IRON)
+    return player_one_->DistributeIron(cmd.unit_);
+  if (cmd.type_ == REMOVE_IRON)
+    return player_one_->RemoveIron(cmd.unit_);
+  if (cmd.type_ == SWITCH_SWARM)
+    player_one_->SwitchSwarmAttack(cmd.pos_);
+  else if (cmd.type_ == RESET_WAY)
+    return player_one_->ResetWayForSynapse(cmd.pos_, cmd.target_) >= 0;
+  else if (cmd.type_ == ADD_WAY_POS)
+    return player_one_->AddWayPosForSynapse(cmd.pos_, cmd.target_) >= 0;
+  else if (cmd.type_ == CHANGE_IPSP_TARGET)
+    player_one_->ChangeIpspTargetForSynapse(cmd.pos_, cmd.target_);
+  else if (cmd.type_ == CHANGE_EPSP_TARGET)
+    player_one_->ChangeEpspTargetForSynapse(cmd.pos_, cmd.target_);
+  else if (cmd.type_ == INCREASE_RESOURCES) {
+    for (int i=0; i<cmd.unit_; i++)
+      player_one_->IncreaseResources(true);
+  }
+  else if (cmd.type_ == RESIGN)
+    resigned_ = true;
+  else 
+    return false;
+  return true;
+}
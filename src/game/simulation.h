@@ -0,0 +1,181 @@
+#ifndef SRC_GAME_SIMULATION_H_
+#define SRC_GAME_SIMULATION_H_
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "audio/audio.h"
+#include "game/field.h"
+#include "player/audio_ki.h"
+#include "player/player.h"
+#include "utils/mpsc_queue.h"
+
+#define TICK_MS 10  ///< game-time of one simulation tick (milliseconds).
+
+/**
+ * Commands changing the game state (input of player one).
+ */
+enum CommandType {
+  ADD_POTENTIAL,  ///< pos_: synapse, unit_: epsp/ ipsp.
+  ADD_NEURON,  ///< pos_: position, unit_: neuron.
+  ADD_TECHNOLOGY,  ///< unit_: technology.
+  DISTRIBUTE_IRON,  ///< unit_: resource.
+  REMOVE_IRON,  ///< unit_: resource.
+  SWITCH_SWARM,  ///< pos_: synapse.
+  RESET_WAY,  ///< pos_: synapse, target_: way-point.
+  ADD_WAY_POS,  ///< pos_: synapse, target_: way-point.
+  CHANGE_IPSP_TARGET,  ///< pos_: synapse, target_: target.
+  CHANGE_EPSP_TARGET,  ///< pos_: synapse, target_: target.
+  INCREASE_RESOURCES,  ///< unit_: number of increases.
+  RESIGN,  ///< player one gives up: match ends before this tick.
+};
+
+struct Command {
+  int type_;
+  position_t pos_;
+  int unit_;
+  position_t target_;
+
+  Command(int type, position_t pos={-1, -1}, int unit=-1, position_t target={-1, -1})
+    : type_(type), pos_(pos), unit_(unit), target_(target) {}
+};
+
+/**
+ * Fixed-timestep simulation: advances all game state (beats, ki actions,
+ * resources, movement and defence) by ticks of TICK_MS game-time. Game-time
+ * is derived from the tick counter only, so the simulation is independent of
+ * real time and rendering: the same song and commands (applied before the same
+ * ticks) always lead to the same outcome, and ticks can be run as fast as
+ * possible when no display is attached.
+ * Single writer: only the thread running ticks changes (and reads) the game
+ * state. Other threads submit commands (applied at the beginning of the next
+ * tick) and read the players' published snapshots.
+ */
+class Simulation {
+  public:
+    /**
+     * Constructor.
+     * @param[in] audio with analysed data of song (beats drive the simulation).
+     * @param[in] field
+     * @param[in] player_one
+     * @param[in] player_two
+     * @param[in] kis players (out of player one and two) controlled by the ki.
+     */
+    Simulation(Audio* audio, Field* field, Player* player_one, Player* player_two, std::vector<AudioKi*> kis);
+
+    // getter:
+    unsigned int tick();
+    bool resigned();  ///< whether player one resigned.
+    double render_frequency();  ///< game-time between moves (milliseconds).
+    std::vector<int> played_levels();  ///< thread-safe.
+    std::vector<std::pair<unsigned int, Command>> commands();  ///< applied commands with tick applied before.
+    std::map<std::string, double> phase_times();  ///< real time (milliseconds) spent in each phase of ticks.
+
+    /**
+     * Gets current game-time.
+     * @return milliseconds (tick*TICK_MS).
+     */
+    double GameTime();
+
+    /**
+     * Checks whether game is over (one player lost or resigned or song ended).
+     */
+    bool Finished();
+
+    /**
+     * Advances game by one tick.
+     */
+    void Tick();
+
+    /**
+     * Runs ticks until game is over.
+     */
+    void RunToEnd();
+
+    /**
+     * Applies command for player one right away (only from thread running
+     * ticks).
+     * @param[in] command
+     * @return whether command succeeded.
+     */
+    bool Execute(const Command& command);
+
+    /**
+     * Queues command for player one, to be applied at the beginning of the
+     * next tick (thread-safe, lock-free).
+     * @param[in] command
+     */
+    void Submit(Command command);
+
+    /**
+     * Queues commands (f.e. of a replay), each to be applied right before given
+     * tick.
+     * @param[in] commands with tick.
+     */
+    void ScheduleCommands(const std::vector<std::pair<unsigned int, Command>>& commands);
+
+  private:
+    /**
+     * Phases of a tick (for measuring time spent in each phase).
+     */
+    enum Phases {
+      COMMANDS,
+      BEATS,
+      RESOURCES,
+      KI_JOBS,
+      MOVE,
+      SNAPSHOT,
+      DEFENCE,
+      NUM_PHASES,
+    };
+
+    Audio* audio_;
+    Field* field_;
+    Player* player_one_;
+    Player* player_two_;
+    std::vector<AudioKi*> kis_;
+    std::list<AudioDataTimePoint> data_per_beat_;  ///< beats still to come.
+    std::vector<int> played_levels_;
+    std::vector<std::pair<unsigned int, Command>> commands_;
+    std::list<std::pair<unsigned int, Command>> scheduled_commands_;
+    MpscQueue<Command> submitted_commands_;
+    unsigned int tick_;
+    bool resigned_;
+    bool off_notes_;
+
+    // Update frequencies (set at each beat) and game-time of next update.
+    double move_frequency_;
+    double player_resource_frequency_;
+    double ki_resource_frequency_;
+    double next_move_;
+    double next_player_resources_;
+    double next_ki_resources_;
+    std::vector<double> phase_ms_;
+
+    std::mutex mutex_played_levels_;
+
+    void HandleBeat(const AudioDataTimePoint& data_at_beat);
+
+    /**
+     * Neutralizes potentials of both players meeting at one position (epsp of
+     * one player and ipsp of the other).
+     */
+    void HandleCollisions();
+
+    /**
+     * Adds real time since start to given phase and resets start to now.
+     */
+    void Measure(int phase, std::chrono::steady_clock::time_point& start);
+
+    /**
+     * Applies and records command.
+     */
+    bool Apply(const Command& command);
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "game/tournament.h"
+#include "game/match.h"
+#include "spdlog/spdlog.h"
+#include "utils/logger.h"
+#include "utils/thread_pool.h"
+
+#define TOURNAMENT_LINES 40
+#define TOURNAMENT_COLS 74
+
+namespace {
+  /**
+   * Gets distribution of given values.
+   * @param[in] values (not empty).
+   * @return json with min, max, mean, median and 90th percentile.
+   */
+  nlohmann::json Distribution(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    double sum = std::accumulate(values.begin(), values.end(), 0.0);
+    return {{"min", values.front()}, {"max", values.back()}, {"mean", sum/values.size()},
+      {"median", values[values.size()/2]}, {"p90", values[(values.size()*9)/10]}};
+  }
+
+  /**
+   * Gets wins and win rates from winners.
+   * @param[in] wins number of matches won by each winner (including "none").
+   * @param[in] matches number of finished matches.
+   * @return json with wins and win rates.
+   */
+  nlohmann::json WinRates(const std::map<std::string, unsigned int>& wins, unsigned int matches) {
+    nlohmann::json result = {{"matches", matches}, {"wins", nlohmann::json::object()},
+      {"win_rates", nlohmann::json::object()}};
+    for (const auto& [winner, num] : wins) {
+      result["wins"][winner] = num;
+      result["win_rates"][winner] = (matches > 0) ? (double)num/matches : 0.0;
+    }
+    return result;
+  }
+}
+
+nlohmann::json RunTournament(const std::map<std::string, Audio*>& songs, const std::vector<unsigned int>& seeds,
+    size_t num_threads, const std::map<std::string, std::string>& song_errors) {
+  std::vector<std::pair<std::string, unsigned int>> matches;
+  for (const auto& it : songs)
+    for (const auto& seed : seeds)
+      matches.push_back({it.first, seed});
+  // Each job only writes its own (pre-allocated) slot, so no locking is needed.
+  std::vector<nlohmann::json> results(matches.size());
+  // Matches of songs which could not be analysed are failed right away.
+  for (const auto& [song, error] : song_errors)
+    for (const auto& seed : seeds)
+      results.push_back({{"error", error}, {"song", song}, {"seed", seed}});
+
+  auto start = std::chrono::steady_clock::now();
+  ThreadPool pool(num_threads);
+  LOG_INFO(LOG_GAME, "RunTournament: {} matches on {} threads", matches.size(), pool.size());
+  for (size_t i=0; i<matches.size(); i++) {
+    pool.Submit([&songs, &matches, &results, i]() {
+      const auto& [song, seed] = matches[i];
+      Match match = {nullptr, nullptr, nullptr, nullptr, {}};
+      try {
+        match = CreateMatch(songs.at(song), TOURNAMENT_LINES, TOURNAMENT_COLS, 0, seed, true);
+        match.simulation_->RunToEnd();
+        results[i] = GetMatchResult(match);
+      } catch (std::exception& e) {
+        LOG_ERROR(LOG_GAME, "RunTournament: match failed: {}", e.what());
+        results[i] = {{"error", e.what()}};
+      }
+      DestroyMatch(match);  // also if match failed.
+      results[i]["song"] = song;
+      results[i]["seed"] = seed;
+    });
+  }
+  pool.Wait();
+  double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+
+  // Aggregate results.
+  std::map<std::string, unsigned int> wins;
+  std::map<std::string, std::map<std::string, unsigned int>> wins_per_song;
+  std::map<std::string, unsigned int> finished_per_song;
+  std::vector<double> ticks;
+  unsigned int errors = 0;
+  for (const auto& result : results) {
+    if (result.contains("error")) {
+      errors++;
+      continue;
+    }
+    std::string song = result["song"];
+    wins[result["winner"]]++;
+    wins_per_song[song][result["winner"]]++;
+    finished_per_song[song]++;
+    ticks.push_back(result["ticks"].get<double>());
+  }
+  nlohmann::json tournament = WinRates(wins, ticks.size());
+  tournament["errors"] = errors;
+  tournament["songs"] = nlohmann::json::object();
+  for (const auto& [song, song_wins] : wins_per_song)
+    tournament["songs"][song] = WinRates(song_wins, finished_per_song[song]);
+  tournament["ticks"] = (ticks.size() > 0) ? Distribution(ticks) : nlohmann::json();
+  tournament["threads"] = pool.size();
+  tournament["elapsed_ms"] = elapsed;
+  tournament["matches_per_second"] = (elapsed > 0) ? matches.size()/(elapsed/1000) : 0.0;
+  tournament["results"] = results;
+  return tournament;
+}
@@ -0,0 +1,25 @@
+#ifndef SRC_GAME_TOURNAMENT_H_
+#define SRC_GAME_TOURNAMENT_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "audio/audio.h"
+#include "nlohmann/json.hpp"
+
+/**
+ * Runs headless ki-against-ki matches for every song and seed in parallel
+ * (on a work-stealing thread pool, one match per job) and aggregates results.
+ * @param[in] songs analysed songs by name (only read by matches).
+ * @param[in] seeds each song is played once with each seed.
+ * @param[in] num_threads number of workers (0: number of cores).
+ * @param[in] song_errors songs which could not be analysed, with error (each
+ * seed is recorded as failed match).
+ * @return json with results of all matches, win rates (overall and per song),
+ * distribution of match lengths (ticks) and throughput (matches per second).
+ */
+nlohmann::json RunTournament(const std::map<std::string, Audio*>& songs, const std::vector<unsigned int>& seeds,
+    size_t num_threads=0, const std::map<std::string, std::string>& song_errors={});
+
+#endif
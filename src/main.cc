@@ -1,23 +1,32 @@
 #include <chrono>
+#include <exception>
 #include <cstdlib>
 #include <curses.h>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
 #include <sstream>
 #include <stdlib.h>
+#include <thread>
+#include <vector>
 #include <lyra/lyra.hpp>
 #include "audio/audio.h"
 #include "game/game.h"
+#include "game/match.h"
+#include "game/replay.h"
+#include "game/tournament.h"
+#include "render/renderer.h"
 
 #include <spdlog/spdlog.h>
+#include "utils/logger.h"
 #include "lyra/help.hpp"
 #include "spdlog/common.h"
-#include "spdlog/sinks/basic_file_sink.h"
 #include "utils/utils.h"
 
-#define LOGGER "logger"
 #define ITERMAX 10000
 
 int main(int argc, const char** argv) {
@@ -28,12 +37,26 @@ int main(int argc, const char** argv) {
   std::string log_level = "warn";
   std::string base_path = getenv("HOME");
   base_path += "/.dissonance/";
+  std::string replay_path = "";
+  double speed = 1;
+  std::string simulate_path = "";
+  unsigned int seed = std::random_device()();
+  std::string tournament_path = "";
+  unsigned int num_seeds = 10;
+  unsigned int num_threads = std::thread::hardware_concurrency();
 
   auto cli = lyra::cli() 
     | lyra::opt(relative_size) ["-r"]["--relative-size"]("If set, adjusts map size to terminal size.")
     | lyra::opt(clear_log) ["-c"]["--clear-log"]("If set, removes all log-files before starting the game.")
-    | lyra::opt(log_level, "options: [warn, info, debug], default: \"warn\"") ["-l"]["--log_level"]("set log-level")
-    | lyra::opt(base_path, "path to dissonance files") ["-p"]["--base-path"]("Set path to dissonance files (logs, settings, data)");
+    | lyra::opt(log_level, "options: [warn, info, debug], default: \"warn\"") ["-l"]["--log_level"]("set log-level (of all categories, or per category: f.e. \"warn,player=debug,ki=info\"; categories: game, field, player, ki, audio, simulation)")
+    | lyra::opt(base_path, "path to dissonance files") ["-p"]["--base-path"]("Set path to dissonance files (logs, settings, data)")
+    | lyra::opt(replay_path, "path to replay") ["--replay"]("Re-run recorded match (replays are stored at <base-path>/replays/)")
+    | lyra::opt(speed, "multiplier, default: 1") ["--speed"]("Speed of replay (0: as fast as possible, without display)")
+    | lyra::opt(simulate_path, "path to song") ["--simulate"]("Let ki play against ki (as fast as possible, without display and audio) and print result as json")
+    | lyra::opt(seed, "seed, default: random") ["--seed"]("Seed of random numbers for simulated match")
+    | lyra::opt(tournament_path, "path to list of songs") ["--tournament"]("Let ki play against ki on each song (one path per line) with each seed in parallel and print results as json")
+    | lyra::opt(num_seeds, "number, default: 10") ["--seeds"]("Number of seeds (0 to number-1) per song in tournament")
+    | lyra::opt(num_threads, "number, default: number of cores") ["--threads"]("Number of threads running tournament matches");
     
   cli.add_argument(lyra::help(show_help));
   auto result = cli.parse({ argc, argv });
@@ -52,36 +75,121 @@ int main(int argc, const char** argv) {
 
   // Logger 
   std::string logger_file = "logs/" + utils::GetFormatedDatetime() + "_logfile.txt";
-  auto logger = spdlog::basic_logger_mt("logger", base_path + logger_file);
-  spdlog::flush_on(spdlog::level::warn);
-  if (log_level == "warn")
-    spdlog::set_level(spdlog::level::warn);
-  else if (log_level == "info")
-    spdlog::set_level(spdlog::level::info);
-  else if (log_level == "debug") {
-    spdlog::set_level(spdlog::level::debug);
-    spdlog::flush_on(spdlog::level::info);
-    spdlog::flush_every(std::chrono::seconds(1));
+  utils::InitLogging(base_path + logger_file, spdlog::level::warn, true);
+  if (!utils::SetLogLevels(log_level)) {
+    std::cout << "Invalid log-level: " << log_level << std::endl;
+    return 1;
   }
+  if (log_level != "warn")
+    spdlog::flush_every(std::chrono::seconds(1));
 
   // Initialize audio
   Audio::Initialize();
 
-  // Initialize random numbers.
-  srand (time(NULL));
+  // Load replay.
+  Replay replay;
+  if (replay_path != "") {
+    try {
+      replay = Replay::Load(replay_path);
+    } catch (std::exception& e) {
+      std::cout << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  // Re-run replay without display.
+  if (replay_path != "" && speed <= 0) {
+    Audio audio(base_path);
+    audio.set_source_path(replay.song_);
+    try {
+      audio.Analyze();
+    } catch (std::exception& e) {
+      std::cout << e.what() << std::endl;
+      return 1;
+    }
+    if (Replay::HashAnalysis(audio.analysed_data()) != replay.analysis_hash_) {
+      std::cout << "Analysis of song changed since replay was recorded." << std::endl;
+      return 1;
+    }
+    Match match = CreateMatch(&audio, replay.lines_, replay.cols_, 0, replay.seed_);
+    match.simulation_->ScheduleCommands(replay.commands_);
+    auto start = std::chrono::steady_clock::now();
+    match.simulation_->RunToEnd();
+    nlohmann::json result = GetMatchResult(match);
+    result["elapsed_ms"] = utils::GetElapsed(start, std::chrono::steady_clock::now());
+    std::cout << result.dump(2) << std::endl;
+    return 0;
+  }
+
+  // Simulate ki against ki.
+  if (simulate_path != "") {
+    Audio audio(base_path);
+    audio.set_source_path(simulate_path);
+    auto start = std::chrono::steady_clock::now();
+    try {
+      audio.Analyze();
+    } catch (std::exception& e) {
+      std::cout << e.what() << std::endl;
+      return 1;
+    }
+    if (audio.analysed_data().data_per_beat_.empty()) {
+      std::cout << "Song has no beats: " << simulate_path << std::endl;
+      return 1;
+    }
+    double analysis_ms = utils::GetElapsed(start, std::chrono::steady_clock::now());
+    start = std::chrono::steady_clock::now();
+    Match match = CreateMatch(&audio, 40, 74, 0, seed, true);
+    double setup_ms = utils::GetElapsed(start, std::chrono::steady_clock::now());
+    start = std::chrono::steady_clock::now();
+    match.simulation_->RunToEnd();
+    nlohmann::json result = GetMatchResult(match);
+    result["song"] = simulate_path;
+    result["seed"] = seed;
+    result["elapsed_ms"] = utils::GetElapsed(start, std::chrono::steady_clock::now());
+    result["phases_ms"]["analysis"] = analysis_ms;
+    result["phases_ms"]["setup"] = setup_ms;
+    std::cout << result.dump(2) << std::endl;
+    return 0;
+  }
+
+  // Run tournament (ki against ki on all songs and seeds).
+  if (tournament_path != "") {
+    std::ifstream songs_file(tournament_path);
+    if (!songs_file) {
+      std::cout << "Could not open list of songs: " << tournament_path << std::endl;
+      return 1;
+    }
+    // Songs are analysed up front, matches only read analysed data.
+    std::map<std::string, Audio*> songs;
+    std::map<std::string, std::string> song_errors;  ///< songs which could not be analysed.
+    std::string song;
+    while (std::getline(songs_file, song)) {
+      if (song == "" || songs.count(song) > 0 || song_errors.count(song) > 0)
+        continue;
+      Audio* audio = new Audio(base_path);
+      audio->set_source_path(song);
+      try {
+        audio->Analyze();
+        songs[song] = audio;
+      } catch (std::exception& e) {
+        LOG_ERROR(LOG_GAME, "Tournament: analysis of {} failed: {}", song, e.what());
+        song_errors[song] = e.what();
+        delete audio;
+      }
+    }
+    std::vector<unsigned int> seeds;
+    for (unsigned int i=0; i<num_seeds; i++)
+      seeds.push_back(i);
+    std::cout << RunTournament(songs, seeds, num_threads, song_errors).dump(2) << std::endl;
+    for (const auto& it : songs)
+      delete it.second;
+    return 0;
+  }
 
   // Initialize curses
-  setlocale(LC_ALL, "");
-  initscr();
-  cbreak();
-  noecho();
-  curs_set(0);
-  keypad(stdscr, true);
-  clear();
+  CursesRenderer renderer;
   
   // Initialize colors.
-  use_default_colors();
-  start_color();
   init_pair(COLOR_AVAILIBLE, COLOR_BLUE, -1);
   init_pair(COLOR_ERROR, COLOR_RED, -1);
   init_pair(COLOR_DEFAULT, -1, -1);
@@ -89,23 +197,29 @@ int main(int argc, const char** argv) {
   init_pair(COLOR_SUCCESS, COLOR_GREEN, -1);
   init_pair(COLOR_MARKED, COLOR_MAGENTA, -1);
 
-  // Setup map-size
-  int lines = 40;
-  int cols  = 74;
-  int left_border = (COLS - cols) /2 - 40;
-  if (relative_size) {
-    lines = LINES-20;
-    cols = (COLS-40)/2;
+  // Setup map-size (replays use recorded size).
+  int lines = (replay_path != "") ? replay.lines_ : 40;
+  int cols  = (replay_path != "") ? replay.cols_ : 74;
+  int left_border = (renderer.cols() - cols) /2 - 40;
+  if (relative_size && replay_path == "") {
+    lines = renderer.lines()-20;
+    cols = (renderer.cols()-40)/2;
     left_border = 10;
   }
   // Initialize game.
-  Game game(lines, cols, left_border, base_path);
+  Game game(lines, cols, left_border, base_path, &renderer);
   // Start game
-  game.play();
+  try {
+    if (replay_path != "")
+      game.PlayReplay(replay, speed);
+    else
+      game.play();
+  } catch (std::exception& e) {
+    LOG_ERROR(LOG_GAME, "main: {}", e.what());
+  }
   
-  // Wrap up.
-  refresh();
-  clear();
-  endwin();
-  exit(0);
+  // Wrap up (curses-mode is ended, when renderer goes out of scope).
+  renderer.Refresh();
+  renderer.Clear();
+  return 0;
 }
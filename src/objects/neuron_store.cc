@@ -0,0 +1,58 @@
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "objects/neuron_store.h"
+#include "utils/utils.h"
+
+int NeuronStore::TypeAt(position_t pos) const {
+  auto it = index_.find(pos);
+  return (it != index_.end()) ? it->second.type_ : -1;
+}
+
+const std::set<position_t>& NeuronStore::positions(int type) const {
+  if (type < 0 || type >= NUM_NEURON_TYPES)
+    throw std::out_of_range("NeuronStore::positions: not a neuron: " + std::to_string(type));
+  return positions_[type];
+}
+
+size_t NeuronStore::Count(int type) const {
+  if (type == -1)
+    return index_.size();
+  return (type >= 0 && type < NUM_NEURON_TYPES) ? positions_[type].size() : 0;
+}
+
+position_t NeuronStore::PositionByIndex(const std::vector<int>& types, size_t index) {
+  for (int type : types) {
+    size_t count = Count(type);
+    if (index < count)
+      return Visit(type, [index](auto& components) { return components.values()[index].pos_; });
+    index -= count;
+  }
+  throw std::out_of_range("NeuronStore::PositionByIndex: index out of range.");
+}
+
+Neuron& NeuronStore::at(position_t pos) {
+  auto it = index_.find(pos);
+  if (it == index_.end())
+    throw std::out_of_range("NeuronStore::at: no neuron at " + utils::PositionToString(pos));
+  SlotHandle handle = it->second.handle_;
+  return Visit(it->second.type_, [handle](auto& components) -> Neuron& { return components.at(handle); });
+}
+
+const Neuron& NeuronStore::at(position_t pos) const {
+  return const_cast<NeuronStore*>(this)->at(pos);
+}
+
+bool NeuronStore::Erase(position_t pos) {
+  auto it = index_.find(pos);
+  if (it == index_.end())
+    return false;
+  SlotHandle handle = it->second.handle_;
+  Visit(it->second.type_, [handle](auto& components) { return components.Erase(handle); });
+  positions_[it->second.type_].erase(pos);
+  index_.erase(it);
+  return true;
+}
@@ -0,0 +1,176 @@
+#ifndef SRC_OBJECTS_NEURON_STORE_H_
+#define SRC_OBJECTS_NEURON_STORE_H_
+
+#include <array>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "constants/codes.h"
+#include "objects/units.h"
+#include "utils/slot_map.h"
+
+/**
+ * Id of a neuron: its type and handle into the components of this type.
+ */
+struct NeuronId {
+  int type_;
+  SlotHandle handle_;
+};
+
+/**
+ * Entity-component storage of all neurons of a player: neurons of each type
+ * (synapses, activated neurons, nuclei and resource-neurons) are stored
+ * densely in their own slot-map, an index maps positions to neurons. Loops
+ * over one type run over contiguous components without virtual calls;
+ * lookups by position go through the index. Positions of each type are kept
+ * as sorted sets, updated on Add and Erase.
+ */
+class NeuronStore {
+  public:
+    // getter:
+    size_t size() const { return index_.size(); }
+    const std::map<position_t, NeuronId>& index() const { return index_; }  ///< ordered by position.
+    SlotMap<Synapse>& synapses() { return synapses_; }
+    const SlotMap<Synapse>& synapses() const { return synapses_; }
+    SlotMap<ActivatedNeuron>& activated_neurons() { return activated_neurons_; }
+    const SlotMap<ActivatedNeuron>& activated_neurons() const { return activated_neurons_; }
+    const SlotMap<Nucleus>& nuclei() const { return nuclei_; }
+    const SlotMap<ResourceNeuron>& resource_neurons() const { return resource_neurons_; }
+
+    bool Contains(position_t pos) const { return index_.count(pos) > 0; }
+
+    /**
+     * Gets positions of all neurons of given type.
+     * @param[in] type
+     * @return positions (sorted).
+     * @throws std::out_of_range if type is not a neuron.
+     */
+    const std::set<position_t>& positions(int type) const;
+
+    /**
+     * Gets number of neurons of given type.
+     * @param[in] type (-1: all neurons).
+     * @return number of neurons (0 if type is not a neuron).
+     */
+    size_t Count(int type=-1) const;
+
+    /**
+     * Gets position of neuron of one of given types by index, counting
+     * neurons of given types in order of types (dense order within a type).
+     * @param[in] types
+     * @param[in] index in [0, number of neurons of given types).
+     * @return position.
+     * @throws std::out_of_range if index is out of range.
+     */
+    position_t PositionByIndex(const std::vector<int>& types, size_t index);
+
+    /**
+     * Gets type of neuron at given position.
+     * @param[in] pos
+     * @return type of neuron or -1 if there is no neuron at this position.
+     */
+    int TypeAt(position_t pos) const;
+
+    /**
+     * Gets components shared by all neurons of neuron at given position.
+     * @param[in] pos
+     * @return neuron.
+     * @throws std::out_of_range if there is no neuron at this position.
+     */
+    Neuron& at(position_t pos);
+    const Neuron& at(position_t pos) const;
+
+    /**
+     * Gets neuron of given type at given position.
+     * @tparam T type of neuron (Synapse, ActivatedNeuron, Nucleus or ResourceNeuron).
+     * @param[in] pos
+     * @return neuron or nullptr if there is no neuron of this type at this position.
+     */
+    template<class T>
+    T* Get(position_t pos) {
+      auto it = index_.find(pos);
+      if (it == index_.end() || it->second.type_ != TypeOf<T>())
+        return nullptr;
+      return &Components<T>().at(it->second.handle_);
+    }
+    template<class T>
+    const T* Get(position_t pos) const {
+      return const_cast<NeuronStore*>(this)->Get<T>(pos);
+    }
+
+    /**
+     * Adds neuron (replacing neuron at same position).
+     * @param[in] neuron
+     */
+    template<class T>
+    void Add(T neuron) {
+      position_t pos = neuron.pos_;
+      Erase(pos);
+      index_[pos] = {TypeOf<T>(), Components<T>().Insert(std::move(neuron))};
+      positions_[TypeOf<T>()].insert(pos);
+    }
+
+    /**
+     * Removes neuron at given position.
+     * @param[in] pos
+     * @return whether neuron existed.
+     */
+    bool Erase(position_t pos);
+
+  private:
+    SlotMap<Synapse> synapses_;
+    SlotMap<ActivatedNeuron> activated_neurons_;
+    SlotMap<Nucleus> nuclei_;
+    SlotMap<ResourceNeuron> resource_neurons_;
+    std::map<position_t, NeuronId> index_;
+    std::array<std::set<position_t>, NUM_NEURON_TYPES> positions_;  ///< indexed by type.
+
+    template<class T>
+    static constexpr int TypeOf() {
+      if constexpr (std::is_same_v<T, Synapse>)
+        return UnitsTech::SYNAPSE;
+      else if constexpr (std::is_same_v<T, ActivatedNeuron>)
+        return UnitsTech::ACTIVATEDNEURON;
+      else if constexpr (std::is_same_v<T, Nucleus>)
+        return UnitsTech::NUCLEUS;
+      else {
+        static_assert(std::is_same_v<T, ResourceNeuron>, "not a type of neuron");
+        return UnitsTech::RESOURCENEURON;
+      }
+    }
+
+    template<class T>
+    SlotMap<T>& Components() {
+      if constexpr (std::is_same_v<T, Synapse>)
+        return synapses_;
+      else if constexpr (std::is_same_v<T, ActivatedNeuron>)
+        return activated_neurons_;
+      else if constexpr (std::is_same_v<T, Nucleus>)
+        return nuclei_;
+      else
+        return resource_neurons_;
+    }
+
+    /**
+     * Calls func with components of given type.
+     * @param[in] type
+     * @param[in] func
+     * @return result of func.
+     */
+    template<class F>
+    decltype(auto) Visit(int type, F func) {
+      if (type == UnitsTech::SYNAPSE)
+        return func(synapses_);
+      else if (type == UnitsTech::ACTIVATEDNEURON)
+        return func(activated_neurons_);
+      else if (type == UnitsTech::NUCLEUS)
+        return func(nuclei_);
+      return func(resource_neurons_);
+    }
+};
+
+#endif
@@ -1,68 +1,129 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
 #include "objects/resource.h"
 #include "objects/units.h"
+#include "utils/logger.h"
 
-Resource::Resource(double init, unsigned int max, int distributed_iron, bool to_int, position_t pos) 
-    : to_int_(to_int), pos_(pos) {
-  free_ = init;
-  limit_ = max;
-  bound_ = 0;
-  distributed_iron_ = distributed_iron;
-  blocked_ = false;
-}
+ConstResource::ConstResource(const ResourceTable* table, int resource) : table_(table), resource_(resource) {}
 
 // getter
-double Resource::cur() const {
-  return (to_int_) ? (int)free_ : free_;
+double ConstResource::cur() const {
+  return (table_->to_int_[resource_]) ? (int)table_->free_[resource_] : table_->free_[resource_];
 }
-double Resource::bound() const {
-  return bound_;
+double ConstResource::bound() const {
+  return table_->bound_[resource_];
 }
-unsigned int Resource::limit() const {
-  return limit_;
+unsigned int ConstResource::limit() const {
+  return table_->limit_[resource_];
 }
-unsigned int Resource::distributed_iron() const {
-  return distributed_iron_;
+unsigned int ConstResource::distributed_iron() const {
+  return table_->iron_[resource_];
 }
-bool Resource::blocked() const {
-  return blocked_;
+bool ConstResource::blocked() const {
+  return table_->blocked_[resource_] != 0;
 }
-position_t Resource::pos() const {
-  return pos_;
+position_t ConstResource::pos() const {
+  return table_->pos_[resource_];
 }
 
+Resource::Resource(ResourceTable* table, int resource) : ConstResource(table, resource),
+  writable_table_(table) {}
+
 // setter 
 void Resource::set_cur(double value) {
-  free_ = value;
+  writable_table_->free_[resource_] = value;
 }
 void Resource::set_bound(double value) {
-  bound_ = value;
+  writable_table_->bound_[resource_] = value;
 }
 void Resource::set_distribited_iron(unsigned int value) {
-  distributed_iron_ = value;
+  writable_table_->iron_[resource_] = value;
 }
 void Resource::set_limit(unsigned int value) {
-  limit_ = value;
+  writable_table_->limit_[resource_] = value;
 }
 void Resource::set_blocked(bool value) {
-  blocked_ = value;
+  writable_table_->blocked_[resource_] = (value) ? 1 : 0;
 }
 
 // functions
 
-bool Resource::Active() const {
-  return distributed_iron_ >= 2;
+bool ConstResource::Active() const {
+  return distributed_iron() >= 2;
+}
+
+std::string ConstResource::Print() const {
+  return utils::Dtos(cur()) + "+" + utils::Dtos(bound()) + "/" + utils::Dtos(limit());
+}
+
+ResourceTable::ResourceTable() {
+  free_.fill(0);
+  bound_.fill(0);
+  limit_.fill(1);
+  iron_.fill(0);
+  blocked_.fill(0);
+  to_int_.fill(false);
+  pos_.fill({-1, -1});
+}
+
+Resource ResourceTable::at(int resource) {
+  if (!Contains(resource))
+    throw std::out_of_range("ResourceTable::at: not a resource: " + std::to_string(resource));
+  return Resource(this, resource);
+}
+
+ConstResource ResourceTable::at(int resource) const {
+  if (!Contains(resource))
+    throw std::out_of_range("ResourceTable::at: not a resource: " + std::to_string(resource));
+  return ConstResource(this, resource);
+}
+
+bool ResourceTable::Contains(int resource) {
+  return resource >= 0 && resource < NUM_RESOURCES;
+}
+
+void ResourceTable::Set(int resource, double init, unsigned int max, int distributed_iron, bool to_int, 
+    position_t pos) {
+  Resource res = at(resource);
+  res.set_cur(init);
+  res.set_bound(0);
+  res.set_limit(max);
+  res.set_distribited_iron(distributed_iron);
+  res.set_blocked(false);
+  to_int_[resource] = to_int;
+  pos_[resource] = pos;
+}
+
+void ResourceTable::Increase(double gain, double slowdown, bool inc_iron) {
+  // No branches in loop (inactive resources are increased by zero), so it is vectorized.
+  double min_increase = 0;
+  for (int i=0; i<NUM_RESOURCES; i++) {
+    double increase = (iron_[i] >= 2) * (1-blocked_[i]) * (i != IRON || inc_iron) 
+      * ((1+iron_[i]/10) * gain * (1-(free_[i]+bound_[i])/limit_[i]))/slowdown;
+    free_[i] += increase;
+    min_increase = std::min(min_increase, increase);
+  }
+  if (min_increase < 0)
+    LOG_ERROR(LOG_PLAYER, "ResourceTable::Increase: increasing by neg value! gain: {}, slowdown: {}", gain, slowdown);
 }
 
-std::string Resource::Print() const {
-  return utils::Dtos(cur()) + "+" + utils::Dtos(bound_) + "/" + utils::Dtos(limit_);
+resource_mask_t ResourceTable::Missing(const std::array<double, NUM_RESOURCES>& costs, double boast) const {
+  resource_mask_t missing = 0;
+  for (int i=0; i<NUM_RESOURCES; i++) {
+    double cur = (to_int_[i]) ? std::trunc(free_[i]) : free_[i];
+    missing |= static_cast<resource_mask_t>(cur < costs[i]*boast) << i;
+  }
+  return missing;
 }
 
-void Resource::IncreaseResource(double gain, double slowdown) {
-  auto calc_boast = [](int boast) -> double { return 1+static_cast<double>(boast)/10; };
-  auto calc_negative_factor = [](double cur, double max) -> double { return 1-cur/max; };
-  double val = (calc_boast(distributed_iron_) * ((false) ? 1 : gain) * calc_negative_factor(free_+bound_, limit_))/slowdown;
-  if (val < 0)
-    spdlog::get(LOGGER)->error("Increasing by neg value!! boast: {} gain: {} neg: {}, others {}, {}, {}", 
-        calc_boast(distributed_iron_), gain, calc_negative_factor(free_+bound_, limit_), free_, bound_, limit_);
-  free_ += val;
+void ResourceTable::Take(const std::array<double, NUM_RESOURCES>& costs, double boast, bool bind) {
+  for (int i=0; i<NUM_RESOURCES; i++) {
+    double cur = (to_int_[i] && costs[i] != 0) ? std::trunc(free_[i]) : free_[i];
+    free_[i] = cur - costs[i]*boast;
+    bound_[i] += bind * costs[i]*boast;
+  }
 }
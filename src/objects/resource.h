@@ -1,19 +1,27 @@
 #ifndef SRC_DATA_STRUCTS_H_
 #define SRC_DATA_STRUCTS_H_
 
+#include <array>
 #include <map>
 #include <math.h>
 #include <string>
 #include <vector>
+#include "constants/codes.h"
 #include "objects/units.h"
 #include "spdlog/spdlog.h"
 #include "utils/utils.h"
 
-#define LOGGER "logger"
+typedef unsigned int resource_mask_t;  ///< one bit per resource (bit i: resource i).
 
-class Resource {
+class ResourceTable;
+
+/**
+ * Read-only view on one resource of a resource-table (reads go to the
+ * table). Cheap to copy, valid as long as the table exists.
+ */
+class ConstResource {
   public:
-    Resource(double init, unsigned int max, int distributed_iron, bool to_int, position_t pos);
+    ConstResource(const ResourceTable* table, int resource);
 
     // getter
     double cur() const;
@@ -23,13 +31,6 @@ class Resource {
     bool blocked() const;
     position_t pos() const;
 
-    // setter 
-    void set_cur(double value);
-    void set_bound(double value);
-    void set_distribited_iron(unsigned int value);
-    void set_limit(unsigned int value);
-    void set_blocked(bool value);
-
     // functions
    
     /**
@@ -44,24 +45,103 @@ class Resource {
      */
     std::string Print() const;
 
+  protected:
+    const ResourceTable* table_;
+    int resource_;
+};
+
+/**
+ * View on one resource of a (non-const) resource-table: reads and writes go
+ * to the table.
+ */
+class Resource : public ConstResource {
+  public:
+    Resource(ResourceTable* table, int resource);
+
+    // setter 
+    void set_cur(double value);
+    void set_bound(double value);
+    void set_distribited_iron(unsigned int value);
+    void set_limit(unsigned int value);
+    void set_blocked(bool value);
+
+  private:
+    ResourceTable* writable_table_;
+};
+
+/**
+ * All resources of a player, stored as fixed-size arrays indexed by
+ * Resources (struct of arrays), so that updates run over all resources at
+ * once, without branches.
+ */
+class ResourceTable {
+  public:
+    ResourceTable();
+
+    /**
+     * Gets resource.
+     * @param[in] resource
+     * @return view on resource (read-only for const tables).
+     * @throws std::out_of_range if not a resource.
+     */
+    Resource at(int resource);
+    ConstResource at(int resource) const;
+
+    /**
+     * Checks whether given code is a resource.
+     */
+    static bool Contains(int resource);
+
     /**
-     * Increases current free.
+     * (Re-)sets resource.
+     * @param[in] resource
+     * @param[in] init initial free resource.
+     * @param[in] max limit of resource (free+bound).
+     * @param[in] distributed_iron
+     * @param[in] to_int whether free resource is only availible as whole numbers.
+     * @param[in] pos position of resource on field.
+     */
+    void Set(int resource, double init, unsigned int max, int distributed_iron, bool to_int, position_t pos);
+
+    /**
+     * Increases free resource of every active, not blocked resource.
      * Increasesing is done with the following formular: ([boast] * gain * [negative-faktor])/[slowdown]
      * Boast is calculated as: `1 + boast/10` -> in range: [1..2]
      * Negative-faktor is calculated as: `1 - (cur+bound)/max` -> in range: [0..1]
-     * TODO (fux): what to do with slowdown?
+     * @param[in] gain
+     * @param[in] slowdown
+     * @param[in] inc_iron whether to increase iron too.
+     */
+    void Increase(double gain, double slowdown, bool inc_iron);
+
+    /**
+     * Gets resources with less free resource than given costs.
+     * @param[in] costs per resource.
+     * @param[in] boast factor for costs.
+     * @return bitmask of missing resources (0 if all costs are availible).
      */
-    void IncreaseResource(double gain, double slowdown);
+    resource_mask_t Missing(const std::array<double, NUM_RESOURCES>& costs, double boast=1) const;
+
+    /**
+     * Subtracts costs from free resources (without checking availibility).
+     * Resources availible only as whole numbers are truncated before paying.
+     * @param[in] costs per resource.
+     * @param[in] boast factor for costs.
+     * @param[in] bind whether to add costs to bound resources.
+     */
+    void Take(const std::array<double, NUM_RESOURCES>& costs, double boast, bool bind);
 
   private:
-    // members
-    double free_;  ///< current availible 
-    double bound_;  ///< current bound
-    unsigned int limit_;  ///< maximum of this resource (free+bound)
-    unsigned int distributed_iron_;
-    bool blocked_;
-    const bool to_int_;
-    const position_t pos_;
+    friend class ConstResource;
+    friend class Resource;
+
+    std::array<double, NUM_RESOURCES> free_;  ///< current availible 
+    std::array<double, NUM_RESOURCES> bound_;  ///< current bound
+    std::array<double, NUM_RESOURCES> limit_;  ///< maximum of this resource (free+bound), whole numbers.
+    std::array<double, NUM_RESOURCES> iron_;  ///< distributed iron.
+    std::array<double, NUM_RESOURCES> blocked_;  ///< 1 if blocked, 0 otherwise.
+    std::array<bool, NUM_RESOURCES> to_int_;
+    std::array<position_t, NUM_RESOURCES> pos_;
 };
 
 #endif
@@ -1,10 +1,10 @@
 #include "spdlog/spdlog.h"
+#include "utils/logger.h"
 #include "objects/units.h"
 #include "utils/utils.h"
 #include <cstddef>
 #include <spdlog/spdlog.h>
 
-#define LOGGER "logger"
 
 // Neurons
 Neuron::Neuron() : Unit() {}
@@ -15,13 +15,15 @@ Neuron::Neuron(position_t pos, int lp, int type) : Unit(pos, type) {
 }
 
 // getter 
-int Neuron::voltage() { 
+int Neuron::voltage() const { 
   return lp_; 
 }
-int Neuron::max_voltage() { 
+int Neuron::max_voltage() const { 
   return max_lp_; 
 }
-bool Neuron::blocked() { return blocked_; };
+bool Neuron::blocked() const { 
+  return blocked_; 
+}
 
 // setter
 void Neuron::set_blocked(bool blocked) { 
@@ -53,16 +55,16 @@ Synapse::Synapse(position_t pos, int max_stored, int num_availible_ways, positio
 }
 
 // getter: 
-std::vector<position_t> Synapse::ways_points() { 
+const std::vector<position_t>& Synapse::ways_points() const { 
   return way_points_; 
 }
-bool Synapse::swarm() { 
+bool Synapse::swarm() const { 
   return swarm_; 
 }
-unsigned int Synapse::num_availible_ways() { 
+unsigned int Synapse::num_availible_ways() const { 
   return num_availible_way_points_; 
 }
-unsigned int Synapse::max_stored() { 
+unsigned int Synapse::max_stored() const { 
   return max_stored_; 
 }
 
@@ -88,7 +90,7 @@ void Synapse::set_max_stored(unsigned int max_stored) {
 
 // methods: 
 std::vector<position_t> Synapse::GetWayPoints(int unit) const { 
-  spdlog::get(LOGGER)->debug("SYNAPSE::GetWayPoints");
+  LOG_DEBUG(LOG_PLAYER, "SYNAPSE::GetWayPoints");
   auto way = way_points_;
   if (unit == UnitsTech::EPSP)
     way.push_back(epsp_target_);
@@ -100,7 +102,7 @@ std::vector<position_t> Synapse::GetWayPoints(int unit) const {
 }
 
 unsigned int Synapse::AddEpsp() { 
-  spdlog::get(LOGGER)->debug("Synapse::AddEpsp");
+  LOG_DEBUG(LOG_PLAYER, "Synapse::AddEpsp");
   if (swarm_) {
     if (++stored_ >= max_stored_) {
       stored_ = 0;
@@ -114,43 +116,77 @@ unsigned int Synapse::AddEpsp() {
 void Synapse::UpdateIpspTargetIfNotSet(position_t pos) {
   if (ipsp_target_.first == -1) {
     ipsp_target_ = pos;
-    spdlog::get(LOGGER)->info("Updated ipsp target to: {}", utils::PositionToString(pos));
+    LOG_INFO(LOG_PLAYER, "Updated ipsp target to: {}", utils::PositionToString(pos));
   }
 }
 
 // Activated neurons...
 ActivatedNeuron::ActivatedNeuron() : Neuron() {}
-ActivatedNeuron::ActivatedNeuron(position_t pos, int slowdown_boast, int speed_boast) : 
+ActivatedNeuron::ActivatedNeuron(position_t pos, int slowdown_boast, int speed_boast, double game_time) : 
     Neuron(pos, 17, UnitsTech::ACTIVATEDNEURON) {
   speed_ = 700-speed_boast;
   potential_slowdown_ = 1+slowdown_boast;
-  last_action_ = std::chrono::steady_clock::now();
+  last_action_ = game_time;
 }
 
 // getter 
-int ActivatedNeuron::speed() { 
+int ActivatedNeuron::speed() const { 
   return speed_; 
 }
-int ActivatedNeuron::potential_slowdown() { 
+int ActivatedNeuron::potential_slowdown() const { 
   return potential_slowdown_; 
 }
-std::chrono::time_point<std::chrono::steady_clock> ActivatedNeuron::last_action() { 
+double ActivatedNeuron::last_action() const { 
   return last_action_; 
 }
 
 // setter
-void ActivatedNeuron::set_last_action(std::chrono::time_point<std::chrono::steady_clock> time) { 
-  last_action_ = time; 
+void ActivatedNeuron::set_last_action(double game_time) { 
+  last_action_ = game_time; 
 }
 
 // ResourceNeuron...
 ResourceNeuron::ResourceNeuron() : Neuron(), resource_(999) {}
 ResourceNeuron::ResourceNeuron(position_t pos, size_t resource) : Neuron(pos, 0, UnitsTech::RESOURCENEURON), 
     resource_(resource) {
-  spdlog::get(LOGGER)->debug("ResourceNeuron::ResourceNeuron, type {}", UnitsTech::RESOURCENEURON);
+  LOG_DEBUG(LOG_PLAYER, "ResourceNeuron::ResourceNeuron, type {}", UnitsTech::RESOURCENEURON);
 }
 
 // getter 
-size_t ResourceNeuron::resource() {
+size_t ResourceNeuron::resource() const {
   return resource_;
 }
+
+void Potential::FollowFlowField(std::shared_ptr<const FlowField> flow, position_t target) {
+  way_ = nullptr;
+  cursor_ = 0;
+  flow_ = flow;
+  target_ = target;
+}
+
+bool Potential::AtTarget() const {
+  if (flow_)
+    return flow_->NextStep(pos_) == pos_;
+  return !way_ || cursor_ >= way_->size();
+}
+
+void Potential::Step() {
+  if (flow_) {
+    pos_ = flow_->NextStep(pos_);
+  }
+  else if (!AtTarget()) {
+    pos_ = (*way_)[cursor_++];
+  }
+}
+
+std::vector<position_t> Potential::Way() const {
+  if (!flow_) {
+    if (AtTarget())
+      return {};
+    return std::vector<position_t>(way_->begin()+cursor_, way_->end());
+  }
+  std::vector<position_t> way;
+  for (position_t pos = pos_; flow_->NextStep(pos) != pos; pos = flow_->NextStep(pos))
+    way.push_back(flow_->NextStep(pos));
+  return way;
+}
@@ -1,17 +1,19 @@
 #ifndef SRC_SOLDIER_H_
 #define SRC_SOLDIER_H_
 
-#include <chrono>
 #include <cstddef>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 #include <spdlog/spdlog.h>
+#include "utils/logger.h"
 
 #include "constants/codes.h"
+#include "utils/flow_field.h"
+#include "utils/pathfinder.h"
 
-#define LOGGER "logger"
 
 typedef std::pair<int, int> position_t;
 
@@ -29,9 +31,10 @@ struct Unit {
 };
 
 /**
- * Abstrackt class for all neurons.
+ * Components shared by all neurons.
  * Neurons are non-moving units on the field (buildings), which have lp. When
- * lp<=0, a neuron is destroyed
+ * lp<=0, a neuron is destroyed. Neurons are plain components (no virtual
+ * functions), stored per type (see NeuronStore).
  * Attributes:
  * - pos (derived from Unit)
  * - lp 
@@ -39,27 +42,12 @@ struct Unit {
 struct Neuron : Unit {
   public:
     // getter 
-    int voltage();
-    int max_voltage();
-    bool blocked();
-    virtual int speed() { return -1; };
-    virtual int potential_slowdown() { return -1; };
-    virtual std::chrono::time_point<std::chrono::steady_clock> last_action() {return std::chrono::steady_clock::now(); }
-    virtual std::vector<position_t> ways_points() {return {}; }
-    virtual bool swarm() { return false; }
-    virtual unsigned int num_availible_ways() { return 0; }
-    virtual unsigned int max_stored() { return 0; }
-    virtual size_t resource() { return 9999; }
+    int voltage() const;
+    int max_voltage() const;
+    bool blocked() const;
 
     // setter
     void set_blocked(bool blocked);
-    virtual void set_last_action(std::chrono::time_point<std::chrono::steady_clock> time) {};
-    virtual void set_way_points(std::vector<position_t> pos) {};
-    virtual void set_swarm(bool swarm) {};
-    virtual void set_epsp_target_pos(position_t pos) {};
-    virtual void set_ipsp_target_pos(position_t pos) {};
-    virtual void set_availible_ways(unsigned int num_ways) {};
-    virtual void set_max_stored(unsigned int max_stored) {};
 
     // methods
 
@@ -68,16 +56,8 @@ struct Neuron : Unit {
      */
     bool IncreaseVoltage(int potential);
 
-    virtual std::vector<position_t> GetWayPoints(int unit) const { 
-      spdlog::get(LOGGER)->error("Neuron::GetWayPoints: invalid base clase call!");
-      return {}; 
-    }
-    virtual unsigned int AddEpsp() { return 0; }
-    virtual void UpdateIpspTargetIfNotSet(position_t pos) { }
-
     Neuron();
     Neuron(position_t pos, int lp, int type);
-    virtual ~Neuron() {}
 
   private:
     int lp_;
@@ -98,10 +78,10 @@ struct Synapse : Neuron {
     Synapse(position_t pos, int max_stored, int num_availible_ways, position_t epsp_target, position_t ipsp_target);
 
     // getter: 
-    std::vector<position_t> ways_points();
-    bool swarm();
-    unsigned int num_availible_ways();
-    unsigned int max_stored();
+    const std::vector<position_t>& ways_points() const;
+    bool swarm() const;
+    unsigned int num_availible_ways() const;
+    unsigned int max_stored() const;
    
     // setter: 
     void set_way_points(std::vector<position_t> way_points);
@@ -138,24 +118,29 @@ struct Synapse : Neuron {
 struct ActivatedNeuron : Neuron {
   public:
     ActivatedNeuron();
-    ActivatedNeuron(position_t pos, int slowdown_boast, int speed_boast);
+    ActivatedNeuron(position_t pos, int slowdown_boast, int speed_boast, double game_time);
 
     // getter 
-    int speed();
-    int potential_slowdown();
-    std::chrono::time_point<std::chrono::steady_clock> last_action();
+    int speed() const;
+    int potential_slowdown() const;
+    double last_action() const;
     
     // setter
-    void set_last_action(std::chrono::time_point<std::chrono::steady_clock> time);
+    void set_last_action(double game_time);
 
   private:
     int speed_;  ///< lower number means higher speed.
     int potential_slowdown_;
-    std::chrono::time_point<std::chrono::steady_clock> last_action_; 
+    double last_action_;  ///< game-time (ms) of last action.
 };
 
 /**
- *
+ * Implemented class: ResourceNeuron.
+ * Resource neurons are built on the position of a resource, once the
+ * resource is activated.
+ * Attributes:
+ * - pos (derived from Unit)
+ * - lp (derived from Neuron)
  */
 struct ResourceNeuron : Neuron {
   public: 
@@ -163,10 +148,10 @@ struct ResourceNeuron : Neuron {
     ResourceNeuron(position_t, size_t resource);
 
     // getter 
-    size_t resource();
+    size_t resource() const;
 
   private:
-    const size_t resource_;
+    size_t resource_;
 };
 
 /** 
@@ -183,20 +168,51 @@ struct Nucleus : Neuron {
 
 /**
  * Abstrackt class for all potentials.
+ * Potentials created together (swarm) are stored as one stack, moving as one
+ * unit; a stack is only split, when one of its potentials is neutralized.
  * Attributes:
  * - pos (derived from Unit)
  */
 struct Potential : Unit {
-  int potential_;
+  int potential_;  ///< potential of each potential in stack.
+  int count_;  ///< number of potentials in stack.
   int speed_;  ///< lower number means higher speed.
   int duration_; ///< only potential
-  std::chrono::time_point<std::chrono::steady_clock> last_action_; 
-  std::list<position_t> way_;
-
-  Potential() : Unit(), speed_(999), last_action_(std::chrono::steady_clock::now()) {}
-  Potential(position_t pos, int attack, std::list<position_t> way, int speed, int type, int duration) 
-    : Unit(pos, type), potential_(attack), speed_(speed), duration_(duration),
-    last_action_(std::chrono::steady_clock::now()), way_(way) {}
+  double last_action_;  ///< game-time (ms) of last action.
+  path_t way_;  ///< shared way (not set when following flow-field).
+  size_t cursor_;  ///< index of next position on way.
+  position_t target_;
+  std::shared_ptr<const FlowField> flow_;  ///< if set, next steps are taken from flow-field.
+
+  Potential() : Unit(), count_(1), speed_(999), last_action_(0), cursor_(0), target_({-1, -1}) {}
+  Potential(position_t pos, int attack, path_t way, int speed, int type, int duration) 
+    : Unit(pos, type), potential_(attack), count_(1), speed_(speed), duration_(duration),
+    last_action_(0), way_(way), cursor_(0), 
+    target_((way && way->size() > 0) ? way->back() : pos) {}
+
+  /**
+   * Sets flow-field to follow instead of way.
+   * @param[in] flow flow-field towards target.
+   * @param[in] target
+   */
+  void FollowFlowField(std::shared_ptr<const FlowField> flow, position_t target);
+
+  /**
+   * Checks whether potential has reached its target.
+   * @return whether potential has reached its target.
+   */
+  bool AtTarget() const;
+
+  /**
+   * Moves potential to next position of its way.
+   */
+  void Step();
+
+  /**
+   * Gets remaining way (following flow-field if set).
+   * @return remaining way.
+   */
+  std::vector<position_t> Way() const;
 };
 
 /**
@@ -210,7 +226,7 @@ struct Potential : Unit {
  */
 struct Epsp : Potential {
   Epsp() : Potential() {}
-  Epsp(position_t pos, std::list<position_t> way, int potential_boast, int speed_boast) 
+  Epsp(position_t pos, path_t way, int potential_boast, int speed_boast) 
     : Potential(pos, 2+potential_boast, way, 370-speed_boast, UnitsTech::EPSP, 0) {}
 };
 
@@ -226,7 +242,7 @@ struct Epsp : Potential {
 struct Ipsp: Potential {
 
   Ipsp() : Potential() {}
-  Ipsp(position_t pos, std::list<position_t> way, int potential_boast, int speed_boast, int duration_boast) 
+  Ipsp(position_t pos, path_t way, int potential_boast, int speed_boast, int duration_boast) 
     : Potential(pos, 3+potential_boast, way, 420-speed_boast, UnitsTech::IPSP, 4+duration_boast) {}
 };
 
@@ -5,12 +5,13 @@
 #include "game/field.h"
 #include "objects/units.h"
 #include "spdlog/spdlog.h"
+#include "utils/logger.h"
 #include "utils/utils.h"
+#include <chrono>
 #include <cstddef>
 #include <iterator>
-#include <mutex>
 #include <algorithm>
-#include <shared_mutex>
+#include <thread>
 #include <vector>
 
 AudioKi::AudioKi(position_t nucleus_pos, Field* field, Audio* audio, RandomGenerator* ran_gen,
@@ -20,6 +21,7 @@ AudioKi::AudioKi(position_t nucleus_pos, Field* field, Audio* audio, RandomGener
     average_level_(audio->analysed_data().average_level_) 
 {
   audio_ = audio;
+  attack_running_ = false;
   max_activated_neurons_ = 3;
   nucleus_pos_ = nucleus_pos;
   cur_interval_ = audio_->analysed_data().intervals_[0];
@@ -33,19 +35,28 @@ AudioKi::AudioKi(position_t nucleus_pos, Field* field, Audio* audio, RandomGener
   building_tactics_ = {{ACTIVATEDNEURON, 4}, {SYNAPSE, 1}, {NUCLEUS, 1}};
 
   // Set additional activated neurons for increased voltage in nucleus.
-  for (int i=0; i< neurons_.at(nucleus_pos)->max_voltage(); i++) {
+  for (int i=0; i< neurons_.at(nucleus_pos).max_voltage(); i++) {
     if (i > 7) extra_activated_neurons_[i] = 2;
     else if (i>4) extra_activated_neurons_[i] = 1;
     else extra_activated_neurons_[i] = 0;
   }
 }
 
-void AudioKi::set_last_time_point(const AudioDataTimePoint &data_at_beat) {
-  last_data_point_ = data_at_beat;
+void AudioKi::RunJobs() {
+  // Jobs might schedule new jobs (also due right away).
+  while (jobs_.size() > 0 && jobs_.begin()->first <= game_time_) {
+    job_t job = jobs_.begin()->second;
+    jobs_.erase(jobs_.begin());
+    job();
+  }
+}
+
+void AudioKi::Schedule(double delay, job_t job) {
+  jobs_.insert({game_time_ + std::max(delay, 0.0), job});
 }
 
 void AudioKi::SetUpTactics(bool economy_tactics) {
-  spdlog::get(LOGGER)->info("AudioKi::SetUpTactics");
+  LOG_INFO(LOG_KI, "AudioKi::SetUpTactics");
   // Setup tactics.
   SetBattleTactics();
   if (economy_tactics)
@@ -57,7 +68,7 @@ void AudioKi::SetUpTactics(bool economy_tactics) {
 }
 
 void AudioKi::SetBattleTactics() {
-  spdlog::get(LOGGER)->info("AudioKi::SetBattleTactics");
+  LOG_INFO(LOG_KI, "AudioKi::SetBattleTactics");
   // Major: defence
   if (cur_interval_.major_) {
     // Additionally increase depending on signature.
@@ -113,18 +124,18 @@ void AudioKi::SetBattleTactics() {
     ipsp_target_strategy_ = BLOCK_SYNAPSES;
 
   // Log results for this interval.
-  spdlog::get(LOGGER)->info("key {}, darkness {}, notes_out_key {}", cur_interval_.key_, cur_interval_.darkness_, 
+  LOG_INFO(LOG_KI, "key {}, darkness {}, notes_out_key {}", cur_interval_.key_, cur_interval_.darkness_, 
       cur_interval_.notes_out_key_);
   for (const auto& it : attack_strategies_)
-    spdlog::get(LOGGER)->info("{}: {}", tactics_mapping.at(it.first), it.second);
+    LOG_INFO(LOG_KI, "{}: {}", tactics_mapping.at(it.first), it.second);
   for (const auto& it : defence_strategies_)
-    spdlog::get(LOGGER)->info("{}: {}", tactics_mapping.at(it.first), it.second);
+    LOG_INFO(LOG_KI, "{}: {}", tactics_mapping.at(it.first), it.second);
   for (const auto& it : building_tactics_)
-    spdlog::get(LOGGER)->info("{}: {}", units_tech_mapping.at(it.first), it.second);
+    LOG_INFO(LOG_KI, "{}: {}", units_tech_mapping.at(it.first), it.second);
 }
 
 void AudioKi::SetEconomyTactics() {
-  spdlog::info("AudioKi::SetEconomyTactics");
+  LOG_INFO(LOG_KI, "AudioKi::SetEconomyTactics");
   std::map<size_t, size_t> resource_tactics;
   std::map<size_t, size_t> technology_tactics;
 
@@ -150,7 +161,7 @@ void AudioKi::SetEconomyTactics() {
     resource_tactics_.push_back(resource_tactics_[i]);
   // Log final resource tactics.
   for (const auto& it : resource_tactics_)
-    spdlog::get(LOGGER)->info("resource: {}", resources_name_mapping.at(it));
+    LOG_INFO(LOG_KI, "resource: {}", resources_name_mapping.at(it));
    
   // technologies
   technology_tactics[SWARM] = (attack_strategies_[AIM_NUCLEUS] > 2) ? 5 : 0;
@@ -174,7 +185,7 @@ void AudioKi::SetEconomyTactics() {
       technology_tactics_.push_back(it.second);
   // log final technology tactics
   for (const auto& it : resource_tactics_)
-    spdlog::get(LOGGER)->info("resource: {}", resources_name_mapping.at(it));
+    LOG_INFO(LOG_KI, "resource: {}", resources_name_mapping.at(it));
 
   // building tactics.
   if (cur_interval_.major_)
@@ -184,7 +195,12 @@ void AudioKi::SetEconomyTactics() {
 }
 
 void AudioKi::DoAction(const AudioDataTimePoint& data_at_beat) {
-  spdlog::get(LOGGER)->debug("AudioKi::DoAction.");
+  LOG_DEBUG(LOG_KI, "AudioKi::DoAction.");
+  // Beats while an attack is launched are handled after the attack.
+  if (attack_running_) {
+    pending_beats_.push_back(data_at_beat);
+    return;
+  }
   // Change tactics when interval changes:
   if (data_at_beat.interval_ > last_data_point_.interval_)
     SetUpTactics(false);
@@ -195,11 +211,21 @@ void AudioKi::DoAction(const AudioDataTimePoint& data_at_beat) {
   // Add data_at_beat to list of beats since switching above average.
   if (data_at_beat.level_ > average_level_) 
     last_data_points_above_average_level_.push_back(data_at_beat);
-  // Launch attack, when above average wave is over.
+  // Launch attack, when above average wave is over. Rest of action is done,
+  // when attack is launched.
   if (data_at_beat.level_ <= average_level_ && last_data_points_above_average_level_.size() > 0) {
-    LaunchAttack(data_at_beat);
+    attack_running_ = true;
+    LaunchAttack(data_at_beat, [this, data_at_beat]() { 
+        attack_running_ = false; 
+        FinishAction(data_at_beat); 
+      });
     last_data_points_above_average_level_.clear();
+    return;
   }
+  FinishAction(data_at_beat);
+}
+
+void AudioKi::FinishAction(const AudioDataTimePoint& data_at_beat) {
   // Create activated neuron if level drops below average.
   if (last_data_point_.level_ >= average_level_ && data_at_beat.level_ < average_level_)
     CreateActivatedNeuron();
@@ -210,37 +236,43 @@ void AudioKi::DoAction(const AudioDataTimePoint& data_at_beat) {
     HandleIron(data_at_beat);
   CreateExtraActivatedNeurons();
 
-  spdlog::get(LOGGER)->info("Enemy current resources: {}", GetCurrentResources());
+  LOG_INFO(LOG_KI, "Enemy current resources: {}", GetCurrentResources());
+  last_data_point_ = data_at_beat;
+
+  // Handle beats, which were due while attack was launched.
+  if (pending_beats_.size() > 0) {
+    auto next = pending_beats_.front();
+    pending_beats_.pop_front();
+    DoAction(next);
+  }
 }
 
-void AudioKi::LaunchAttack(const AudioDataTimePoint& data_at_beat) {
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack.");
+void AudioKi::LaunchAttack(const AudioDataTimePoint& data_at_beat, job_t then) {
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack.");
   // Sort synapses (use synapses futhest from enemy for epsp)
   auto sorted_synapses = SortPositionsByDistance(enemy_->GetOneNucleus(), GetAllPositionsOfNeurons(UnitsTech::SYNAPSE));
   if (sorted_synapses.size() == 0) {
-    spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: stoped: no synapses");
-    return;
+    LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: stoped: no synapses");
+    return then();
   }
-  std::unique_lock ul(mutex_all_neurons_);
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: get epsp synapses.");
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: get epsp synapses.");
   position_t epsp_synapses_pos = sorted_synapses.back();
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: epsp synapses: {}", utils::PositionToString(epsp_synapses_pos));
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: epsp synapses exists? {}", neurons_.count(epsp_synapses_pos));
-  if (neurons_.count(epsp_synapses_pos) == 0) {
-    spdlog::get(LOGGER)->error("AudioKi::LaunchAttack: epsp synapses does not exist! {}", utils::PositionToString(epsp_synapses_pos));
-    return;
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: epsp synapses: {}", utils::PositionToString(epsp_synapses_pos));
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: epsp synapses exists? {}", neurons_.Contains(epsp_synapses_pos));
+  if (!neurons_.Get<Synapse>(epsp_synapses_pos)) {
+    LOG_ERROR(LOG_KI, "AudioKi::LaunchAttack: epsp synapses does not exist! {}", utils::PositionToString(epsp_synapses_pos));
+    return then();
   }
-  auto epsp_way = field_->GetWayForSoldier(epsp_synapses_pos, neurons_.at(epsp_synapses_pos)->GetWayPoints(UnitsTech::EPSP));
-  ul.unlock();
- 
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: Get ipsp targets");
+  auto epsp_way = field_->GetWayForSoldier(epsp_synapses_pos, neurons_.Get<Synapse>(epsp_synapses_pos)->GetWayPoints(UnitsTech::EPSP));
+
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: Get ipsp targets");
   auto ipsp_launch_synapes = AvailibleIpspLaunches(sorted_synapses, 5);
-  auto ipsp_targets = GetIpspTargets(epsp_way, sorted_synapses);  // using epsp-way, since we want to clear this way.
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: Got {} ipsp targets.", ipsp_targets.size());
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: Get epsp target");
+  auto ipsp_targets = GetIpspTargets(*epsp_way, sorted_synapses);  // using epsp-way, since we want to clear this way.
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: Got {} ipsp targets.", ipsp_targets.size());
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: Get epsp target");
   position_t epsp_target = {-1, -1};
   // Take first target which is not already ipsp target.
-  auto possible_epsp_targets = GetEpspTargets(sorted_synapses.back(), epsp_way);
+  auto possible_epsp_targets = GetEpspTargets(sorted_synapses.back(), *epsp_way);
   for (const auto& it : possible_epsp_targets)
     if (std::find(ipsp_targets.begin(), ipsp_targets.end(), it) == ipsp_targets.end())
       epsp_target = it;
@@ -250,47 +282,64 @@ void AudioKi::LaunchAttack(const AudioDataTimePoint& data_at_beat) {
   // Check whether to launch attack.
   size_t available_ipsps = AvailibleIpsps();
   size_t num_epsps_to_create = GetLaunchAttack(data_at_beat, available_ipsps);
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: targeting to create epsps {}.", num_epsps_to_create);
-
-  // Launch ipsp attacks first. Only launch if epsp attack is launched too or
-  // strategy is blocking enemy synapses.
-  if (ipsp_target_strategy_ == BLOCK_SYNAPSES || num_epsps_to_create > 0) {
-    spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: launching ipsp attacks...");
-    size_t available_ipsps = AvailibleIpsps();
-    for (size_t i=0; i<ipsp_targets.size() && i<ipsp_launch_synapes.size(); i++) {
-      CreateIpsps(ipsp_launch_synapes[i], ipsp_targets[i], available_ipsps/ipsp_targets.size(), data_at_beat.bpm_);
+  LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: targeting to create epsps {}.", num_epsps_to_create);
+
+  // The attack runs as a chain of jobs (built backwards): ipsps, waiting for
+  // ipsps to get ahead, epsps and finally reseting targets.
+  int bpm = data_at_beat.bpm_;
+  job_t reset_targets = [this, sorted_synapses, then]() {
+    LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: reseting target-positions.");
+    for (const auto& it : sorted_synapses) {
+      ChangeEpspTargetForSynapse(it, enemy_->GetOneNucleus());
+      ChangeIpspTargetForSynapse(it, enemy_->GetOneNucleus());
     }
-  }
+    then();
+  };
+
   // Only launch if expected number of epsps to create is reached.
+  job_t epsp_attack = reset_targets;
   if (num_epsps_to_create > 0) {
-    if (ipsp_launch_synapes.size() > 0) {
-      ul.lock();
+    epsp_attack = [this, sorted_synapses, epsp_target, epsp_way, ipsp_launch_synapes, bpm, reset_targets]() {
+      job_t create_epsps = [this, sorted_synapses, epsp_target, bpm, reset_targets]() {
+        LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: launching epsp attack...");
+        CreateEpsps(sorted_synapses.back(), epsp_target, bpm, reset_targets);
+      };
+      if (ipsp_launch_synapes.size() == 0)
+        return create_epsps();
+      // Synapse might have been destroyed while launching ipsps.
+      if (!neurons_.Get<Synapse>(ipsp_launch_synapes.front()))
+        return create_epsps();
       auto ipsp_way = field_->GetWayForSoldier(ipsp_launch_synapes.front(), 
-          neurons_.at(ipsp_launch_synapes.front())->GetWayPoints(UnitsTech::IPSP));
-      ul.unlock();
-      SynchAttacks(epsp_way.size(), ipsp_way.size());
-    }
-    spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: launching epsp attack...");
-    // Launch epsps next.
-    CreateEpsps(sorted_synapses.back(), epsp_target, data_at_beat.bpm_);
+          neurons_.Get<Synapse>(ipsp_launch_synapes.front())->GetWayPoints(UnitsTech::IPSP));
+      SynchAttacks(epsp_way->size(), ipsp_way->size(), create_epsps);
+    };
   }
 
-  // Reset target for all synapses
-  spdlog::get(LOGGER)->debug("AudioKi::LaunchAttack: reseting target-positions.");
-  for (const auto& it : sorted_synapses) {
-    ChangeEpspTargetForSynapse(it, enemy_->GetOneNucleus());
-    ChangeIpspTargetForSynapse(it, enemy_->GetOneNucleus());
+  // Launch ipsp attacks first. Only launch if epsp attack is launched too or
+  // strategy is blocking enemy synapses.
+  job_t attack = epsp_attack;
+  if (ipsp_target_strategy_ == BLOCK_SYNAPSES || num_epsps_to_create > 0) {
+    LOG_DEBUG(LOG_KI, "AudioKi::LaunchAttack: launching ipsp attacks...");
+    size_t available_ipsps = AvailibleIpsps();
+    for (size_t i=std::min(ipsp_targets.size(), ipsp_launch_synapes.size()); i-- > 0;) {
+      job_t next = attack;
+      size_t num_ipsps = available_ipsps/ipsp_targets.size();
+      attack = [this, synapse_pos=ipsp_launch_synapes[i], target_pos=ipsp_targets[i], num_ipsps, bpm, next]() {
+        CreateIpsps(synapse_pos, target_pos, num_ipsps, bpm, next);
+      };
+    }
   }
+  attack();
 }
 
-std::vector<position_t> AudioKi::GetEpspTargets(position_t synapse_pos, std::list<position_t> way, size_t ignore_strategy) {
-  spdlog::get(LOGGER)->debug("AudioKi::GetEpspTargets");
+std::vector<position_t> AudioKi::GetEpspTargets(position_t synapse_pos, const std::vector<position_t>& way, size_t ignore_strategy) {
+  LOG_DEBUG(LOG_KI, "AudioKi::GetEpspTargets");
   if (technologies_.at(UnitsTech::TARGET).first < 2)  {
-    spdlog::get(LOGGER)->debug("AudioKi::GetEpspTargets: using default.");
+    LOG_DEBUG(LOG_KI, "AudioKi::GetEpspTargets: using default.");
     return {enemy_->GetOneNucleus()};
   }
   if (epsp_target_strategy_ == DESTROY_ACTIVATED_NEURONS && ignore_strategy != DESTROY_ACTIVATED_NEURONS) {
-    spdlog::get(LOGGER)->debug("AudioKi::GetEpspTargets: using DESTROY_ACTIVATED_NEURONS.");
+    LOG_DEBUG(LOG_KI, "AudioKi::GetEpspTargets: using DESTROY_ACTIVATED_NEURONS.");
     auto activated_neurons_on_way = GetAllActivatedNeuronsOnWay(way);
     activated_neurons_on_way = SortPositionsByDistance(nucleus_pos_, activated_neurons_on_way, false);
     if (activated_neurons_on_way.size() == 0)
@@ -298,34 +347,34 @@ std::vector<position_t> AudioKi::GetEpspTargets(position_t synapse_pos, std::lis
     return activated_neurons_on_way;
   }
   else if (epsp_target_strategy_ == DESTROY_SYNAPSES && ignore_strategy != DESTROY_SYNAPSES) {
-    spdlog::get(LOGGER)->debug("AudioKi::GetEpspTargets: using DESTROY_SYNAPSES.");
+    LOG_DEBUG(LOG_KI, "AudioKi::GetEpspTargets: using DESTROY_SYNAPSES.");
     auto enemy_synapses = GetEnemySynapsesSortedByLeastDef(synapse_pos);
     if (enemy_synapses.size() == 0)
       return GetEpspTargets(synapse_pos, way, DESTROY_SYNAPSES);
     return enemy_synapses;
   }
   else {
-   spdlog::get(LOGGER)->debug("AudioKi::GetEpspTargets: using AIM_NUCLEUS.");
+   LOG_DEBUG(LOG_KI, "AudioKi::GetEpspTargets: using AIM_NUCLEUS.");
    return {enemy_->GetPositionOfClosestNeuron(synapse_pos, UnitsTech::NUCLEUS)};
   }
 }
 
-std::vector<position_t> AudioKi::GetIpspTargets(std::list<position_t> way, std::vector<position_t>& synapses, size_t ignore_strategy) {
-  spdlog::get(LOGGER)->debug("AudioKi::GetIpspTargets");
+std::vector<position_t> AudioKi::GetIpspTargets(const std::vector<position_t>& way, std::vector<position_t>& synapses, size_t ignore_strategy) {
+  LOG_DEBUG(LOG_KI, "AudioKi::GetIpspTargets");
   if (technologies_.at(UnitsTech::TARGET).first == 0) {
-    spdlog::get(LOGGER)->debug("AudioKi::GetIpspTargets: using default.");
+    LOG_DEBUG(LOG_KI, "AudioKi::GetIpspTargets: using default.");
     return {enemy_->GetRandomNeuron()};
   }
   std::vector<position_t> isps_targets;
   if (ipsp_target_strategy_ == BLOCK_ACTIVATED_NEURON && ignore_strategy != BLOCK_ACTIVATED_NEURON) {
-    spdlog::get(LOGGER)->debug("AudioKi::GetIpspTargets: using BLOCK_ACTIVATED_NEURON.");
+    LOG_DEBUG(LOG_KI, "AudioKi::GetIpspTargets: using BLOCK_ACTIVATED_NEURON.");
     auto activated_neurons_on_way = GetAllActivatedNeuronsOnWay(way);
     activated_neurons_on_way = SortPositionsByDistance(nucleus_pos_, activated_neurons_on_way, false);
     for (size_t i=0; i<synapses.size() && i<activated_neurons_on_way.size(); i++)
       isps_targets.push_back(activated_neurons_on_way[i]);
   }
   else if (epsp_target_strategy_ == BLOCK_SYNAPSES && ignore_strategy != BLOCK_SYNAPSES) {
-    spdlog::get(LOGGER)->debug("AudioKi::GetIpspTargets: using BLOCK_SYNAPSES.");
+    LOG_DEBUG(LOG_KI, "AudioKi::GetIpspTargets: using BLOCK_SYNAPSES.");
     auto enemy_synapses = GetEnemySynapsesSortedByLeastDef(nucleus_pos_);
     if (enemy_synapses.size() == 0)
       return GetIpspTargets(way, synapses, BLOCK_SYNAPSES);
@@ -335,45 +384,42 @@ std::vector<position_t> AudioKi::GetIpspTargets(std::list<position_t> way, std::
   return isps_targets;
 }
 
-void AudioKi::CreateEpsps(position_t synapse_pos, position_t target_pos, int bpm) {
-  spdlog::get(LOGGER)->debug("AudioKi::CreateEpsp.");
+void AudioKi::CreateEpsps(position_t synapse_pos, position_t target_pos, int bpm, job_t then) {
+  LOG_DEBUG(LOG_KI, "AudioKi::CreateEpsp.");
   ChangeEpspTargetForSynapse(synapse_pos, target_pos);
   // Calculate update number of epsps to create and update interval
   double update_interval = 60000.0/(bpm*16);
-  auto last_epsp = std::chrono::steady_clock::now();  
-  while (GetMissingResources(UnitsTech::EPSP).size() == 0) {
-    // Add epsp in certain interval.
-    if (utils::GetElapsed(last_epsp, std::chrono::steady_clock::now()) < update_interval) {
-      AddPotential(synapse_pos, UnitsTech::EPSP);
-      last_epsp = std::chrono::steady_clock::now();
-    }
-  }
+  AddPotentials(synapse_pos, UnitsTech::EPSP, update_interval, then);
 }
 
-void AudioKi::CreateIpsps(position_t synapse_pos, position_t target_pos, int num_ipsp_to_create, int bpm) {
-  spdlog::get(LOGGER)->debug("AudioKi::CreateIpsp.");
+void AudioKi::CreateIpsps(position_t synapse_pos, position_t target_pos, int num_ipsp_to_create, int bpm, 
+    job_t then) {
+  LOG_DEBUG(LOG_KI, "AudioKi::CreateIpsp.");
   ChangeIpspTargetForSynapse(synapse_pos, target_pos);
 
   // Calculate update number of ipsps to create and update interval
   double update_interval = 60000.0/(bpm*16);
-  auto last_ipsp = std::chrono::steady_clock::now();  
-  while (GetMissingResources(UnitsTech::IPSP).size() == 0) {
-    // Add ipsp in certain interval.
-    if (utils::GetElapsed(last_ipsp, std::chrono::steady_clock::now()) >= update_interval) {
-      AddPotential(synapse_pos, UnitsTech::IPSP);
-      last_ipsp = std::chrono::steady_clock::now();
-    }
-  }
+  AddPotentials(synapse_pos, UnitsTech::IPSP, update_interval, then);
+}
+
+void AudioKi::AddPotentials(position_t synapse_pos, int unit, double interval, job_t then) {
+  if (GetMissingResources(unit) != 0)
+    return then();
+  // Add potential in certain interval.
+  Schedule(interval, [this, synapse_pos, unit, interval, then]() {
+      AddPotential(synapse_pos, unit);
+      AddPotentials(synapse_pos, unit, interval, then);
+    });
 }
 
 void AudioKi::CreateSynapses(bool force) {
-  spdlog::get(LOGGER)->debug("AudioKi::Synapse.");
+  LOG_DEBUG(LOG_KI, "AudioKi::Synapse.");
   unsigned int availible_oxygen = resources_.at(OXYGEN).limit() - resources_.at(OXYGEN).bound();
-  unsigned int num_existing_synapses = GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size();
+  unsigned int num_existing_synapses = GetNumNeurons(UnitsTech::SYNAPSE);
   if (num_existing_synapses <= building_tactics_[SYNAPSE] && availible_oxygen > 25 + num_existing_synapses*2) {
-    spdlog::get(LOGGER)->debug("AudioKi::CreateSynapses: creating synapses.");
+    LOG_DEBUG(LOG_KI, "AudioKi::CreateSynapses: creating synapses.");
     auto pos = field_->FindFree(nucleus_pos_, 1, 5);
-    spdlog::get(LOGGER)->debug("AudioKi::CreateSynapses: Found free pos: {} {}", utils::PositionToString(nucleus_pos_), utils::PositionToString(pos));
+    LOG_DEBUG(LOG_KI, "AudioKi::CreateSynapses: Found free pos: {} {}", utils::PositionToString(nucleus_pos_), utils::PositionToString(pos));
     // If no more free positions are availible, try to extend range.
     if (pos.first == -1 && pos.second == -1) {
       AddTechnology(UnitsTech::NUCLEUS_RANGE);
@@ -382,57 +428,60 @@ void AudioKi::CreateSynapses(bool force) {
     else if (AddNeuron(pos, UnitsTech::SYNAPSE, enemy_->GetOneNucleus())) {
       field_->AddNewUnitToPos(pos, UnitsTech::SYNAPSE);
       CheckResourceLimit();
-      spdlog::get(LOGGER)->debug("AudioKi::CreateSynapses: created synapses.");
+      LOG_DEBUG(LOG_KI, "AudioKi::CreateSynapses: created synapses.");
     }
     else {
-      spdlog::get(LOGGER)->debug("AudioKi::CreateSynapses: not enough resources");
+      LOG_DEBUG(LOG_KI, "AudioKi::CreateSynapses: not enough resources");
     }
   }
 }
 
 void AudioKi::CreateActivatedNeuron(bool force) {
-  spdlog::get(LOGGER)->debug("AudioKi::CreateActivatedNeuron.");
-  size_t num_activated_neurons = GetAllPositionsOfNeurons(ACTIVATEDNEURON).size();
+  LOG_DEBUG(LOG_KI, "AudioKi::CreateActivatedNeuron.");
+  size_t num_activated_neurons = GetNumNeurons(ACTIVATEDNEURON);
   int availible_oxygen = resources_.at(OXYGEN).limit() - resources_.at(OXYGEN).bound();
   if (!force && (num_activated_neurons >= building_tactics_[ACTIVATEDNEURON] || availible_oxygen < 25))
     return;
   // Don't add def, if no synapses already exists and atleast one def already exists.
-  if (!force && num_activated_neurons > 0 && GetAllPositionsOfNeurons(UnitsTech::SYNAPSE).size() == 0)
+  if (!force && num_activated_neurons > 0 && GetNumNeurons(UnitsTech::SYNAPSE) == 0)
     return;
 
-  spdlog::get(LOGGER)->debug("AudioKi::CreateActivatedNeuron: createing neuron");
+  LOG_DEBUG(LOG_KI, "AudioKi::CreateActivatedNeuron: createing neuron");
   // Find position to place neuron coresponding to tactics.
   position_t pos = {-1, -1};
   if (SortStrategy(defence_strategies_).front().second == DEF_SURROUNG_FOCUS) {
-    for (int i=1; i<cur_range_; i++) {
-      auto positions = field_->GetAllInRange(nucleus_pos_, i, i-1, true);
-      if (positions.size() > 0) {
-        positions = SortPositionsByDistance(enemy_->GetOneNucleus(), positions);
-        pos = positions.front(); 
-        spdlog::get(LOGGER)->debug("AudioKi::CreateActivatedNeuron: got pos {}", utils::PositionToString(pos));
-        break;
-      }
+    position_t enemy_nucleus = enemy_->GetOneNucleus();
+    for (int i=1; i<cur_range_ && pos.first == -1; i++) {
+      // Get free position closest to enemy nucleus in current ring.
+      std::pair<size_t, position_t> closest = {0, {-1, -1}};
+      field_->ForEachInRange(nucleus_pos_, i, i-1, true, [&](position_t position) {
+          std::pair<size_t, position_t> cur = {utils::Dist(enemy_nucleus, position), position};
+          if (closest.second.first == -1 || cur < closest)
+            closest = cur;
+        });
+      pos = closest.second;
     }
+    LOG_DEBUG(LOG_KI, "AudioKi::CreateActivatedNeuron: got pos {}", utils::PositionToString(pos));
   }
   else {
     auto way = field_->GetWayForSoldier(nucleus_pos_, {enemy_->GetOneNucleus()});
-    auto positions = field_->GetAllInRange(nucleus_pos_, cur_range_, 1, true);
     int max_way_points_in_range = 0;
-    pos = positions.front();
-    for (const auto& position : positions) {
-      int counter = 0;
-      int way_points_in_range = 0;
-      for (const auto& way_point : way) {
-        if (counter++ > cur_range_+3) 
-          break;
-        if (utils::Dist(position, way_point) <= 3)
-          way_points_in_range++;
-      }
-      if (way_points_in_range > max_way_points_in_range) {
-        max_way_points_in_range = way_points_in_range;
-        pos = position;
-      }
-    }
+    field_->ForEachInRange(nucleus_pos_, cur_range_, 1, true, [&](position_t position) {
+        if (pos.first == -1)
+          pos = position;
+        int counter = 0;
+        int way_points_in_range = 0;
+        for (const auto& way_point : *way) {
+          if (counter++ > cur_range_+3) 
+            break;
+          if (utils::Dist(position, way_point) <= 3)
+            way_points_in_range++;
+        }
+        if (way_points_in_range > max_way_points_in_range) {
+          max_way_points_in_range = way_points_in_range;
+          pos = position;
+        }
+      });
   }
   // If no more free positions are availible, try to extend range.
   if (pos.first == -1 && pos.second == -1) {
@@ -442,63 +491,55 @@ void AudioKi::CreateActivatedNeuron(bool force) {
   else if (AddNeuron(pos, UnitsTech::ACTIVATEDNEURON)) {
     field_->AddNewUnitToPos(pos, UnitsTech::ACTIVATEDNEURON);
     CheckResourceLimit();
-    spdlog::get(LOGGER)->debug("AudioKi::CreateActivatedNeuron: created activated neuron.");
+    LOG_DEBUG(LOG_KI, "AudioKi::CreateActivatedNeuron: created activated neuron.");
   }
   else
-    spdlog::get(LOGGER)->debug("AudioKi::CreateActivatedNeuron: not enough resources");
+    LOG_DEBUG(LOG_KI, "AudioKi::CreateActivatedNeuron: not enough resources");
 }
 
 void AudioKi::HandleIron(const AudioDataTimePoint& data_at_beat) {
-  spdlog::get(LOGGER)->debug("AudioKi::HandleIron.");
+  LOG_DEBUG(LOG_KI, "AudioKi::HandleIron.");
 
-  std::shared_lock sl(mutex_resources_);
   unsigned int iron = resources_.at(IRON).cur();
-  sl.unlock();
 
   // Check if empty.
   if (resource_tactics_.empty() || iron == 0 || (cur_interval_.id_ > 0 && iron < 2))
     return;
   size_t resource = resource_tactics_.front();
   if (!DistributeIron(resource)) {
-    spdlog::get(LOGGER)->debug("AudioKi::HandleIron: no iron or other error.");
+    LOG_DEBUG(LOG_KI, "AudioKi::HandleIron: no iron or other error.");
     return;
   }
   // If resource is now activated, procceed to next resource.
-  sl.lock();
   if (resources_.at(resource).Active())
     resource_tactics_.erase(resource_tactics_.begin());
   // If not activated and iron left, distribute again.
-  else if (resources_.at(IRON).cur() > 0) {
-    sl.unlock();
+  else if (resources_.at(IRON).cur() > 0)
     HandleIron(data_at_beat);
-  }
-  spdlog::get(LOGGER)->debug("AudioKi::HandleIron: done.");
+  LOG_DEBUG(LOG_KI, "AudioKi::HandleIron: done.");
 }
 
 void AudioKi::NewTechnology(const AudioDataTimePoint& data_at_beat) {
-  spdlog::get(LOGGER)->debug("AudioKi::NewTechnology.");
+  LOG_DEBUG(LOG_KI, "AudioKi::NewTechnology.");
 
   // Check if empty.
   if (technology_tactics_.empty()) {
-    spdlog::get(LOGGER)->debug("AudioKi::NewTechnology: List empty.");
+    LOG_DEBUG(LOG_KI, "AudioKi::NewTechnology: List empty.");
     return;
   }
   // Research technology and remove from tech-list.
   size_t technology = technology_tactics_.front();
   if (!AddTechnology(technology)) {
-    spdlog::get(LOGGER)->debug("AudioKi::NewTechnology: no resources or other error.");
+    LOG_DEBUG(LOG_KI, "AudioKi::NewTechnology: no resources or other error.");
     return;
   }
   technology_tactics_.erase(technology_tactics_.begin());
   // If technology was already fully researched, research next technology right away.
-  std::shared_lock sl(mutex_technologies_);
   if (technologies_.at(technology).first == technologies_.at(technology).second) {
-    spdlog::get(LOGGER)->debug("AudioKi::NewTechnology: calling again, as fully researched.");
-    sl.unlock();
-    sl.release();
+    LOG_DEBUG(LOG_KI, "AudioKi::NewTechnology: calling again, as fully researched.");
     NewTechnology(data_at_beat);
   }
-  spdlog::get(LOGGER)->debug("AudioKi::NewTechnology: success.");
+  LOG_DEBUG(LOG_KI, "AudioKi::NewTechnology: success.");
 }
 
 AudioKi::sorted_stragety AudioKi::SortStrategy(std::map<size_t, size_t> strategy) {
@@ -511,40 +552,37 @@ AudioKi::sorted_stragety AudioKi::SortStrategy(std::map<size_t, size_t> strategy
 }
 
 size_t AudioKi::AvailibleIpsps() {
-  spdlog::get(LOGGER)->debug("AudioKi::AvailibleIpsps.");
-  std::shared_lock sl(mutex_resources_);
-  auto costs = units_costs_.at(UnitsTech::IPSP);
-  size_t res = std::min(resources_.at(POTASSIUM).cur() / costs[POTASSIUM], resources_.at(CHLORIDE).cur() / costs[CHLORIDE]);
-  spdlog::get(LOGGER)->debug("AudioKi::AvailibleIpsps: available ipsps: {}", res);
+  LOG_DEBUG(LOG_KI, "AudioKi::AvailibleIpsps.");
+  size_t res = std::min(resources_.at(POTASSIUM).cur() / Cost<UnitsTech::IPSP, POTASSIUM>(), 
+      resources_.at(CHLORIDE).cur() / Cost<UnitsTech::IPSP, CHLORIDE>());
+  LOG_DEBUG(LOG_KI, "AudioKi::AvailibleIpsps: available ipsps: {}", res);
   if (attack_strategies_.at(EPSP_FOCUSED) > attack_strategies_.at(IPSP_FOCUSED)) {
     res *= attack_strategies_.at(IPSP_FOCUSED)/attack_strategies_.at(EPSP_FOCUSED);
-    spdlog::get(LOGGER)->debug("AudioKi::AvailibleIpsps: available ipsps taking ipsp-/ epsp-focus under account: {}", res);
+    LOG_DEBUG(LOG_KI, "AudioKi::AvailibleIpsps: available ipsps taking ipsp-/ epsp-focus under account: {}", res);
   }
   return res;
 }
 
 size_t AudioKi::AvailibleEpsps(size_t ipsps_to_create) {
-  spdlog::get(LOGGER)->debug("AudioKi::AvailibleEpsps.");
-  std::shared_lock sl(mutex_resources_);
-  auto costs_ipsp = units_costs_.at(UnitsTech::IPSP);
-  auto costs = units_costs_.at(UnitsTech::EPSP);
-  size_t res = resources_.at(POTASSIUM).cur() / (costs[POTASSIUM] + ipsps_to_create*costs_ipsp[POTASSIUM]);
+  LOG_DEBUG(LOG_KI, "AudioKi::AvailibleEpsps.");
+  size_t res = resources_.at(POTASSIUM).cur() 
+    / (Cost<UnitsTech::EPSP, POTASSIUM>() + ipsps_to_create*Cost<UnitsTech::IPSP, POTASSIUM>());
   return res;
 }
 
 
 std::vector<position_t> AudioKi::AvailibleIpspLaunches(std::vector<position_t>& synapses, int min) {
-  spdlog::get(LOGGER)->debug("AudioKi::AvailibleIpspLaunches.");
+  LOG_DEBUG(LOG_KI, "AudioKi::AvailibleIpspLaunches.");
   size_t available_ipsps = AvailibleIpsps();  
   std::vector<position_t> result_positions;
   for (size_t i=0; i<available_ipsps; i+=min)
     result_positions.push_back(synapses[i]);
-  spdlog::get(LOGGER)->debug("AudioKi::AvailibleIpspLaunches: got {} launch positions", result_positions.size());
+  LOG_DEBUG(LOG_KI, "AudioKi::AvailibleIpspLaunches: got {} launch positions", result_positions.size());
   return result_positions;
 }
 
-std::vector<position_t> AudioKi::GetAllActivatedNeuronsOnWay(std::list<position_t> way) {
-  spdlog::get(LOGGER)->debug("AudioKi::GetAllActivatedNeuronsOnWay.");
+std::vector<position_t> AudioKi::GetAllActivatedNeuronsOnWay(const std::vector<position_t>& way) {
+  LOG_DEBUG(LOG_KI, "AudioKi::GetAllActivatedNeuronsOnWay.");
   auto enemy_activated_neurons = enemy_->GetAllPositionsOfNeurons(UnitsTech::ACTIVATEDNEURON);
   std::vector<position_t> result_positions;
   for (const auto& way_point : way) {
@@ -553,12 +591,12 @@ std::vector<position_t> AudioKi::GetAllActivatedNeuronsOnWay(std::list<position_
         result_positions.push_back(activated_neuron_pos);
     }
   }
-  spdlog::get(LOGGER)->debug("AudioKi::GetAllActivatedNeuronsOnWay: got {} activated neurons on way.", result_positions.size());
+  LOG_DEBUG(LOG_KI, "AudioKi::GetAllActivatedNeuronsOnWay: got {} activated neurons on way.", result_positions.size());
   return result_positions;
 }
 
 std::vector<position_t> AudioKi::SortPositionsByDistance(position_t start, std::vector<position_t> positions, bool reverse) {
-  spdlog::get(LOGGER)->debug("AudioKi::SortPositionsByDistance.");
+  LOG_DEBUG(LOG_KI, "AudioKi::SortPositionsByDistance.");
   std::list<std::pair<size_t, position_t>> sorted_positions;
   for (const auto& it : positions)
     sorted_positions.push_back({utils::Dist(start, it), it});
@@ -568,17 +606,17 @@ std::vector<position_t> AudioKi::SortPositionsByDistance(position_t start, std::
   std::vector<position_t> result_positions;
   for (const auto& it : sorted_positions)
     result_positions.push_back(it.second);
-  spdlog::get(LOGGER)->debug("AudioKi::SortPositionsByDistance: done.");
+  LOG_DEBUG(LOG_KI, "AudioKi::SortPositionsByDistance: done.");
   return result_positions; 
 }
 
 std::vector<position_t> AudioKi::GetEnemySynapsesSortedByLeastDef(position_t start) {
-  spdlog::get(LOGGER)->debug("AudioKi::GetEnemySynapsesSortedByLeastDef.");
+  LOG_DEBUG(LOG_KI, "AudioKi::GetEnemySynapsesSortedByLeastDef.");
   auto enemy_synapses = enemy_->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE);
   std::list<std::pair<size_t, position_t>> sorted_positions;
   for (const auto& it : enemy_synapses) {
     auto way = field_->GetWayForSoldier(start, {it});
-    sorted_positions.push_back({GetAllActivatedNeuronsOnWay(way).size(), it});
+    sorted_positions.push_back({GetAllActivatedNeuronsOnWay(*way).size(), it});
   }
   sorted_positions.sort();
   sorted_positions.reverse();
@@ -607,40 +645,34 @@ size_t AudioKi::GetLaunchAttack(const AudioDataTimePoint& data_at_beat, size_t i
   // From 4th interval onwards, add darkness as factor for number of epsps to create.
   if (cur_interval_.id_ > 3) {
     num_epsps_to_create *= cur_interval_.darkness_*0.125*cur_interval_.id_;
-    spdlog::get(LOGGER)->info("AudioKi::GetLaunchAttack: darkness: {}, epsps to create: {}, available: {}", 
+    LOG_INFO(LOG_KI, "AudioKi::GetLaunchAttack: darkness: {}, epsps to create: {}, available: {}", 
         cur_interval_.darkness_, num_epsps_to_create, available_epsps);
   }
 
   // Crop, to not exeed a to high number of potassium:
-  auto costs_epsp = units_costs_.at(UnitsTech::EPSP);
-  double diff = resources_.at(POTASSIUM).limit() * 0.6 - num_epsps_to_create * costs_epsp[POTASSIUM]; // max-to-spend -                                                                                                       // total costs.
+  constexpr double costs_epsp = Cost<UnitsTech::EPSP, POTASSIUM>();
+  double diff = resources_.at(POTASSIUM).limit() * 0.6 - num_epsps_to_create * costs_epsp; // max-to-spend -                                                                                                       // total costs.
   if (diff < 0)
-    num_epsps_to_create += diff/costs_epsp[POTASSIUM]; // + because diff is negative
-  spdlog::get(LOGGER)->info("AudioKi::GetLaunchAttack: epsps to create: {}, available: {}", 
+    num_epsps_to_create += diff/costs_epsp; // + because diff is negative
+  LOG_INFO(LOG_KI, "AudioKi::GetLaunchAttack: epsps to create: {}, available: {}", 
       num_epsps_to_create, available_epsps);
   // Now, only launch, if target-amount can be reached.
   return (num_epsps_to_create > available_epsps) ? 0 : num_epsps_to_create;
 }
 
-void AudioKi::SynchAttacks(size_t epsp_way_length, size_t ipsp_way_length) {
-  std::shared_lock sl_technologies(mutex_technologies_);
+void AudioKi::SynchAttacks(size_t epsp_way_length, size_t ipsp_way_length, job_t then) {
   int speed_boast = 50*technologies_.at(UnitsTech::ATK_POTENIAL).first;
-  sl_technologies.unlock();
   size_t ipsp_duration = ipsp_way_length*(420-speed_boast);
   size_t epsp_duration = epsp_way_length*(370-speed_boast);
   int wait_time = (ipsp_duration-epsp_duration) + 100;
-  spdlog::get(LOGGER)->info("AudioKi::SynchAttacks: Waiting for {} millisecond.", wait_time);
-  auto start = std::chrono::steady_clock::now();  
-  while (utils::GetElapsed(start, std::chrono::steady_clock::now()) < wait_time) { continue; }
-  spdlog::get(LOGGER)->info("AudioKi::SynchAttacks: Done waiting.");
+  LOG_INFO(LOG_KI, "AudioKi::SynchAttacks: Waiting for {} millisecond.", wait_time);
+  Schedule(wait_time, then);
 }
 
 void AudioKi::CheckResourceLimit() {
-  std::shared_lock sl (mutex_resources_);
-  for (const auto& it : resources_) {
-    double procent_full = (it.second.cur()+it.second.bound())/it.second.limit();
+  for (int i=0; i<NUM_RESOURCES; i++) {
+    double procent_full = (resources_.at(i).cur()+resources_.at(i).bound())/resources_.at(i).limit();
     if (procent_full >= 0.8) {
-      sl.unlock();
       AddTechnology(UnitsTech::TOTAL_RESOURCE);
       break;
     }
@@ -648,18 +680,18 @@ void AudioKi::CheckResourceLimit() {
 }
 
 void AudioKi::CreateExtraActivatedNeurons() {
-  spdlog::get(LOGGER)->info("AudioKi::CreateExtraActivatedNeurons");
+  LOG_INFO(LOG_KI, "AudioKi::CreateExtraActivatedNeurons");
   int voltage = 0;
   try {
-    voltage = neurons_.at(GetOneNucleus())->voltage();
+    voltage = neurons_.at(GetOneNucleus()).voltage();
   }
   catch (std::exception& e) {
-    spdlog::get(LOGGER)->warn("AudioKi::CreateExtraActivatedNeurons: Accessed nucleus but didn't exist.");
+    LOG_WARN(LOG_KI, "AudioKi::CreateExtraActivatedNeurons: Accessed nucleus but didn't exist.");
     return;
   }
   // Build activated neurons based on current voltage.
   if (extra_activated_neurons_.count(voltage) > 0 && extra_activated_neurons_.at(voltage) > 0) {
-    spdlog::get(LOGGER)->info("AudioKi::CreateExtraActivatedNeurons builiding {} a-neurons based on current voltag.",
+    LOG_INFO(LOG_KI, "AudioKi::CreateExtraActivatedNeurons builiding {} a-neurons based on current voltag.",
      extra_activated_neurons_.at(voltage));
     CreateActivatedNeuron(true);
     extra_activated_neurons_.at(voltage)--;
@@ -667,13 +699,14 @@ void AudioKi::CreateExtraActivatedNeurons() {
 
   // Build activated neurons based on enemy epsp-attack launch.
   unsigned int enemy_potentials = 0;
-  for (const auto& it : enemy_->potential()) 
-    if (it.second.type_ == EPSP) 
-      enemy_potentials++;
+  auto enemy_snapshot = enemy_->snapshot();
+  for (const auto& it : enemy_snapshot->potential_) 
+    if (it.type_ == EPSP) 
+      enemy_potentials += it.count_;
   if (enemy_potentials > 0) {
-    auto way = enemy_->potential().begin()->second.way_;
+    auto way = enemy_snapshot->potential_.begin()->Way();
     int diff = GetAllActivatedNeuronsOnWay(way).size()*3-enemy_potentials;
-    spdlog::get(LOGGER)->info("AudioKi::CreateExtraActivatedNeurons got missing defs: {}/3", diff);
+    LOG_INFO(LOG_KI, "AudioKi::CreateExtraActivatedNeurons got missing defs: {}/3", diff);
     if (diff > 0) {
       diff /= 3;
       while(--diff > 0)
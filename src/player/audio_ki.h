@@ -6,6 +6,9 @@
 #include "objects/units.h"
 #include "player/player.h"
 #include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
 #include <vector>
 
 class AudioKi : public Player {
@@ -15,16 +18,25 @@ class AudioKi : public Player {
 
     // getter 
     
-    // setter
-    void set_last_time_point(const AudioDataTimePoint& data_at_beat);
-
     void SetUpTactics(bool economy_tactics);
     void DoAction(const AudioDataTimePoint& data_at_beat);
     void HandleIron(const AudioDataTimePoint& data_at_beat);
 
+    /**
+     * Runs all jobs due at current game-time (see set_game_time). Actions
+     * spanning over time (f.e. launching potentials one by one) are split into
+     * jobs, so the ki never blocks the simulation.
+     */
+    void RunJobs();
+
   private:
+    typedef std::function<void()> job_t;
+
     // members
     Audio* audio_;
+    std::multimap<double, job_t> jobs_;  ///< jobs by game-time they are due.
+    bool attack_running_;
+    std::list<AudioDataTimePoint> pending_beats_;  ///< beats arriving while attack is launched.
     const float average_bpm_;
     const float average_level_;
     size_t max_activated_neurons_;
@@ -44,11 +56,38 @@ class AudioKi : public Player {
     std::map<unsigned int, unsigned int> extra_activated_neurons_;
 
     // functions 
-    void LaunchAttack(const AudioDataTimePoint& data_at_beat);
+    /**
+     * Adds job to be run given game-time from now.
+     * @param[in] delay milliseconds.
+     * @param[in] job
+     */
+    void Schedule(double delay, job_t job);
+
+    /**
+     * Does rest of action at beat (everything but launching attacks).
+     * @param[in] data_at_beat
+     */
+    void FinishAction(const AudioDataTimePoint& data_at_beat);
+
+    /**
+     * Launches attack.
+     * @param[in] data_at_beat
+     * @param[in] then job run once attack is launched completely.
+     */
+    void LaunchAttack(const AudioDataTimePoint& data_at_beat, job_t then);
 
     // Create potental/ neurons. Add technology
-    void CreateEpsps(position_t synapse_pos, position_t target_pos, int bpm);
-    void CreateIpsps(position_t synapse_pos, position_t target_pos, int num_ipsp_to_create, int bpm);
+    void CreateEpsps(position_t synapse_pos, position_t target_pos, int bpm, job_t then);
+    void CreateIpsps(position_t synapse_pos, position_t target_pos, int num_ipsp_to_create, int bpm, job_t then);
+
+    /**
+     * Adds potentials in given interval as long as resources suffice.
+     * @param[in] synapse_pos
+     * @param[in] unit
+     * @param[in] interval milliseconds between potentials.
+     * @param[in] then job run once resources are used up.
+     */
+    void AddPotentials(position_t synapse_pos, int unit, double interval, job_t then);
     void CreateIpspThenEpsp(const AudioDataTimePoint& data_at_beat);
     void CreateSynapses(bool force=false);
     void CreateActivatedNeuron(bool force=false);
@@ -60,8 +99,8 @@ class AudioKi : public Player {
     std::vector<position_t> AvailibleIpspLaunches(std::vector<position_t>& synapses, int min);
     size_t GetLaunchAttack(const AudioDataTimePoint& data_at_beat, size_t ipsps_to_create);
 
-    std::vector<position_t> GetEpspTargets(position_t synapse_pos, std::list<position_t> way, size_t ignore_strategy=-1);
-    std::vector<position_t> GetIpspTargets(std::list<position_t> way, std::vector<position_t>& synapses, 
+    std::vector<position_t> GetEpspTargets(position_t synapse_pos, const std::vector<position_t>& way, size_t ignore_strategy=-1);
+    std::vector<position_t> GetIpspTargets(const std::vector<position_t>& way, std::vector<position_t>& synapses, 
         size_t ignore_strategy=-1);
 
     // Other stretegies
@@ -76,11 +115,11 @@ class AudioKi : public Player {
     // helpers
     typedef std::list<std::pair<size_t, size_t>> sorted_stragety;
     sorted_stragety SortStrategy(std::map<size_t, size_t> strategy);
-    std::vector<position_t> GetAllActivatedNeuronsOnWay(std::list<position_t> way);
+    std::vector<position_t> GetAllActivatedNeuronsOnWay(const std::vector<position_t>& way);
     std::vector<position_t> SortPositionsByDistance(position_t start, std::vector<position_t> positions, bool reverse=false);
     std::vector<position_t> GetEnemySynapsesSortedByLeastDef(position_t start);
     size_t GetMaxLevelExeedance() const;
-    void SynchAttacks(size_t epsp_way_length, size_t ipsp_way_length);
+    void SynchAttacks(size_t epsp_way_length, size_t ipsp_way_length, job_t then);
 
     void SetBattleTactics();
     void SetEconomyTactics();
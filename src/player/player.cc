@@ -1,17 +1,18 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <cwchar>
 #include <exception>
 #include <math.h>
 #include <memory>
-#include <mutex>
-#include <shared_mutex>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 #include <spdlog/spdlog.h>
+#include "utils/logger.h"
 
 #include "constants/codes.h"
 #include "constants/costs.h"
@@ -20,9 +21,9 @@
 #include "curses.h"
 #include "game/field.h"
 #include "player/player.h"
+#include "utils/geometry.h"
 #include "utils/utils.h"
 
-#define LOGGER "logger"
 
 #define HILL ' ' 
 #define DEN 'D' 
@@ -32,41 +33,80 @@
 #define FREE char(46)
 #define DEF 'T'
 
-Player::Player(position_t nucleus_pos, Field* field, RandomGenerator* ran_gen, 
-    std::map<int, position_t> r_pos) : cur_range_(4), resource_slowdown_(3) {
-  field_ = field;
-  ran_gen_ = ran_gen;
+namespace {
+  /**
+   * Gets missing resources for given unit.
+   * @param[in] resources availible resources.
+   * @param[in] unit
+   * @param[in] boast
+   * @return bitmask of missing resources (0 if all needed resources are availible).
+   */
+  resource_mask_t MissingResources(const ResourceTable& resources, int unit, int boast) {
+    return resources.Missing(CostsOf(unit), boast);
+  }
 
-  neurons_[nucleus_pos] = std::make_unique<Nucleus>(nucleus_pos);
-  // Max only 20 as iron should be rare.
-  resources_.insert(std::pair<int, Resource>(IRON, Resource(3, 22, 2, true, {-1, -1})));  
-  resources_.insert(std::pair<int, Resource>(Resources::OXYGEN, Resource(5.5, 100, 0, false, r_pos[OXYGEN]))); 
-  resources_.insert(std::pair<int, Resource>(Resources::POTASSIUM, Resource(0, 100, 0, false, r_pos[POTASSIUM]))); 
-  resources_.insert(std::pair<int, Resource>(Resources::CHLORIDE, Resource(0, 100, 0, false, r_pos[CHLORIDE]))); 
-  // Max 150: allows 7 activated neurons withput updates.
-  resources_.insert(std::pair<int, Resource>(Resources::GLUTAMATE, Resource(0, 150, 0, false, r_pos[GLUTAMATE]))); 
-  // Max low, dopamine is never bound.
-  resources_.insert(std::pair<int, Resource>(Resources::DOPAMINE, Resource(0, 70, 0, false, r_pos[DOPAMINE]))); 
-  // Max low, as serotonin is never bound.
-  resources_.insert(std::pair<int, Resource>(Resources::SEROTONIN, Resource(0, 70, 0, false, r_pos[SEROTONIN]))); 
-  
-  technologies_ = {
-    {UnitsTech::WAY, {0,3}},
-    {UnitsTech::SWARM, {0,3}},
-    {UnitsTech::TARGET, {0,2}},
-    {UnitsTech::TOTAL_RESOURCE, {0,3}},
-    {UnitsTech::CURVE, {0,3}},
-    {UnitsTech::ATK_POTENIAL, {0,3}},
-    {UnitsTech::ATK_SPEED, {0,3}},
-    {UnitsTech::ATK_DURATION, {0,3}},
-    {UnitsTech::DEF_POTENTIAL, {0,3}},
-    {UnitsTech::DEF_SPEED, {0,3}},
-    {UnitsTech::NUCLEUS_RANGE, {0,3}},
-  };
+  std::string VoltageToString(int voltage, int max_voltage) {
+    return std::to_string(voltage) + " / " + std::to_string(max_voltage);
+  }
+}
+
+resource_mask_t PlayerSnapshot::GetMissingResources(int unit, int boast) const {
+  return MissingResources(resources_, unit, boast);
+}
+
+std::vector<position_t> PlayerSnapshot::GetAllPositionsOfNeurons(int type) const {
+  std::vector<position_t> positions;
+  for (const auto& it : *neurons_)
+    if (type == -1 || it.second.type_ == type)
+      positions.push_back(it.first);
+  return positions;
+}
+
+int PlayerSnapshot::GetNeuronTypeAtPosition(position_t pos) const {
+  auto it = neurons_->find(pos);
+  return (it != neurons_->end()) ? it->second.type_ : -1;
+}
+
+bool PlayerSnapshot::IsNeuronBlocked(position_t pos) const {
+  auto it = neurons_->find(pos);
+  return it != neurons_->end() && it->second.blocked_;
+}
+
+position_t PlayerSnapshot::GetOneNucleus() const {
+  for (const auto& it : *neurons_)
+    if (it.second.type_ == UnitsTech::NUCLEUS)
+      return it.first;
+  return {-1, -1};
+}
+
+std::string PlayerSnapshot::GetNucleusLive() const {
+  position_t pos = GetOneNucleus();
+  if (pos.first == -1)
+    return "---";
+  return VoltageToString(neurons_->at(pos).voltage_, neurons_->at(pos).max_voltage_);
 }
 
-std::vector<std::string> Player::GetCurrentStatusLine() {
-  std::shared_lock sl(mutex_resources_);
+choice_mapping_t PlayerSnapshot::GetOptionsForSynapes(position_t pos) const {
+  choice_mapping_t mapping;
+  if (GetNeuronTypeAtPosition(pos) != SYNAPSE) {
+    LOG_WARN(LOG_PLAYER, "PlayerSnapshot::GetOptionsForSynapes: neuron at position does'n exist, or is no synapse: {}.", 
+        utils::PositionToString(pos));
+    return mapping;
+  }
+  const auto& synapse = neurons_->at(pos);
+  mapping[0] = {"(Re-)set way.", (technologies_->at(UnitsTech::WAY).first > 0) ? COLOR_AVAILIBLE : COLOR_DEFAULT};
+  mapping[1] = {"Add way-point.", (synapse.num_way_points_ < synapse.num_availible_ways_) 
+    ? COLOR_AVAILIBLE : COLOR_DEFAULT};
+  mapping[2] = {"Select target for ipsp.", (technologies_->at(UnitsTech::TARGET).first > 0) 
+    ? COLOR_AVAILIBLE : COLOR_DEFAULT};
+  mapping[3] = {"Select target for epsp.", (technologies_->at(UnitsTech::TARGET).first > 1) 
+    ? COLOR_AVAILIBLE : COLOR_DEFAULT};
+  mapping[4] = {(synapse.swarm_) ? "Turn swarm-attack off" : "Turn swarm-attack on", 
+    (technologies_->at(UnitsTech::SWARM).first > 0) ? COLOR_AVAILIBLE : COLOR_DEFAULT};
+  return mapping;
+}
+
+std::vector<std::string> PlayerSnapshot::GetCurrentStatusLine() const {
   std::string end = ": ";
   return { 
     "RESOURCES",
@@ -90,34 +130,80 @@ std::vector<std::string> Player::GetCurrentStatusLine() {
   };
 }
 
+Player::Player(position_t nucleus_pos, Field* field, RandomGenerator* ran_gen, 
+    std::map<int, position_t> r_pos) : cur_range_(4), resource_slowdown_(3), game_time_(0) {
+  field_ = field;
+  ran_gen_ = ran_gen;
+
+  neurons_.Add(Nucleus(nucleus_pos));
+  // Max only 20 as iron should be rare.
+  resources_.Set(IRON, 3, 22, 2, true, {-1, -1});  
+  resources_.Set(Resources::OXYGEN, 5.5, 100, 0, false, r_pos[OXYGEN]); 
+  resources_.Set(Resources::POTASSIUM, 0, 100, 0, false, r_pos[POTASSIUM]); 
+  resources_.Set(Resources::CHLORIDE, 0, 100, 0, false, r_pos[CHLORIDE]); 
+  // Max 150: allows 7 activated neurons withput updates.
+  resources_.Set(Resources::GLUTAMATE, 0, 150, 0, false, r_pos[GLUTAMATE]); 
+  // Max low, dopamine is never bound.
+  resources_.Set(Resources::DOPAMINE, 0, 70, 0, false, r_pos[DOPAMINE]); 
+  // Max low, as serotonin is never bound.
+  resources_.Set(Resources::SEROTONIN, 0, 70, 0, false, r_pos[SEROTONIN]); 
+  
+  technologies_ = {
+    {UnitsTech::WAY, {0,3}},
+    {UnitsTech::SWARM, {0,3}},
+    {UnitsTech::TARGET, {0,2}},
+    {UnitsTech::TOTAL_RESOURCE, {0,3}},
+    {UnitsTech::CURVE, {0,3}},
+    {UnitsTech::ATK_POTENIAL, {0,3}},
+    {UnitsTech::ATK_SPEED, {0,3}},
+    {UnitsTech::ATK_DURATION, {0,3}},
+    {UnitsTech::DEF_POTENTIAL, {0,3}},
+    {UnitsTech::DEF_SPEED, {0,3}},
+    {UnitsTech::NUCLEUS_RANGE, {0,3}},
+  };
+  PublishSnapshot();
+}
+
 // getter 
-std::map<std::string, Potential> Player::potential() { 
-  std::shared_lock sl(mutex_potentials_);
+const SlotMap<Potential>& Player::potential() const { 
   return potential_; 
 }
 
 position_t Player::GetOneNucleus() { 
-  std::shared_lock sl(mutex_all_neurons_); 
-  auto all_nucleus_positions = GetAllPositionsOfNeurons(NUCLEUS);
+  const auto& all_nucleus_positions = neurons_.positions(NUCLEUS);
   if (all_nucleus_positions.size() > 0)
-    return all_nucleus_positions.front();
+    return *all_nucleus_positions.begin();
   return {-1, -1};
 }
 
+double Player::game_time() const {
+  return game_time_;
+}
+
+void Player::set_game_time(double game_time) {
+  game_time_ = game_time;
+}
+
 int Player::cur_range() { 
   return cur_range_;
 }
 
-std::map<int, Resource> Player::resources() {
-  std::shared_lock sl(mutex_resources_);
+std::shared_ptr<const PlayerSnapshot> Player::snapshot() const {
+  return std::atomic_load(&snapshot_);
+}
+
+const ResourceTable& Player::resources() const {
   return resources_;
 }
 
 std::map<int, tech_of_t> Player::technologies() {
-  std::shared_lock sl(mutex_technologies_);
   return technologies_;
 }
 
+std::map<int, unsigned int> Player::units_built() {
+  return units_built_;
+}
+
 // setter 
 void Player::set_enemy(Player *enemy) {
   enemy_ = enemy;
@@ -126,158 +212,141 @@ void Player::set_enemy(Player *enemy) {
 // methods 
 
 position_t Player::GetPositionOfClosestNeuron(position_t pos, int unit) {
-  spdlog::get(LOGGER)->info("Player::GetPositionOfClosestNeuron");
-  std::shared_lock sl(mutex_all_neurons_);
-  int min_dist = 999;
+  LOG_INFO(LOG_PLAYER, "Player::GetPositionOfClosestNeuron");
+  int min_dist = -1;
   position_t closest_nucleus_pos = {-1, -1}; 
-  for (const auto& it : neurons_) {
-    if (it.second->type_ != unit)
-      continue;
-    int dist = utils::Dist(pos, it.first);
-    if(dist < min_dist) {
-      closest_nucleus_pos = it.first;
+  ForEachNeuronPosition(unit, [&](position_t neuron_pos) {
+    int dist = geometry::DistSq(pos, neuron_pos);
+    if(min_dist == -1 || dist < min_dist) {
+      closest_nucleus_pos = neuron_pos;
       min_dist = dist;
     }
-  }
-  spdlog::get(LOGGER)->info("Player::GetPositionOfClosestNeuron: done");
+  });
+  LOG_INFO(LOG_PLAYER, "Player::GetPositionOfClosestNeuron: done");
   return closest_nucleus_pos;
 }
 
 std::string Player::GetNucleusLive() {
-  spdlog::get(LOGGER)->info("Player::GetNucleusLive");
-  std::shared_lock sl(mutex_all_neurons_);
-  auto positions = GetAllPositionsOfNeurons(NUCLEUS);
-  if (positions.size() > 0) {
-    return std::to_string(neurons_.at(positions.front())->voltage()) 
-      + " / " + std::to_string(neurons_.at(positions.front())->max_voltage());
-  }
+  LOG_INFO(LOG_PLAYER, "Player::GetNucleusLive");
+  position_t pos = GetOneNucleus();
+  if (pos.first != -1)
+    return VoltageToString(neurons_.at(pos).voltage(), neurons_.at(pos).max_voltage());
   return "---";
 }
 
 bool Player::HasLost() {
-  std::shared_lock sl(mutex_all_neurons_);
-  return GetAllPositionsOfNeurons(NUCLEUS).size() == 0;
+  return neurons_.Count(NUCLEUS) == 0;
 }
 
 int Player::GetNeuronTypeAtPosition(position_t pos) {
-  std::shared_lock sl(mutex_all_neurons_);
-  if (neurons_.count(pos) > 0)
-    return neurons_.at(pos)->type_;
-  return -1;
+  return neurons_.TypeAt(pos);
 }
 
 bool Player::IsNeuronBlocked(position_t pos) {
-  std::shared_lock sl(mutex_all_neurons_);
-  if (neurons_.count(pos) > 0)
-    return neurons_.at(pos)->blocked();
-  return false;
+  return neurons_.Contains(pos) && neurons_.at(pos).blocked();
 }
 
 std::vector<position_t> Player::GetAllPositionsOfNeurons(int type) {
-  spdlog::get(LOGGER)->info("Player::GetAllPositionsOfNeurons");
-  std::shared_lock sl(mutex_all_neurons_);
   std::vector<position_t> positions;
-  for (const auto& it : neurons_)
-    if (type == -1 || it.second->type_ == type)
-      positions.push_back(it.first);
-  spdlog::get(LOGGER)->info("Player::GetAllPositionsOfNeurons: done");
+  positions.reserve(neurons_.Count(type));
+  ForEachNeuronPosition(type, [&positions](position_t pos) { positions.push_back(pos); });
   return positions;
 }
 
-position_t Player::GetRandomNeuron(std::vector<int>) {
-  spdlog::get(LOGGER)->info("Player::GetRandomNeuron");
-  std::shared_lock sl(mutex_all_neurons_);
-  // Get all positions at which there are activated neurons
-  std::vector<position_t> activated_neuron_postions;
-  for (const auto& it : neurons_)
-    activated_neuron_postions.push_back(it.first);
+size_t Player::GetNumNeurons(int type) {
+  return neurons_.Count(type);
+}
+
+position_t Player::GetRandomNeuron(std::vector<int> type) {
+  LOG_DEBUG(LOG_PLAYER, "Player::GetRandomNeuron");
+  size_t num = 0;
+  for (int t : type)
+    num += neurons_.Count(t);
+  // If player has no neurons of given types, choose from all types.
+  if (num == 0) {
+    type = {ACTIVATEDNEURON, SYNAPSE, NUCLEUS, RESOURCENEURON};
+    num = neurons_.Count();
+  }
   // If none return invalied position.
-  if (activated_neuron_postions.size() == 0)
+  if (num == 0)
     return {-1, -1};
   // If only one, return this position.
-  if (activated_neuron_postions.size() == 1)
-    return activated_neuron_postions.front();
+  if (num == 1)
+    return neurons_.PositionByIndex(type, 0);
   // Otherwise, get random index and return position at index.
-  int ran = ran_gen_->RandomInt(0, activated_neuron_postions.size()-1);
-  spdlog::get(LOGGER)->info("Player::GetRandomNeuron: done");
-  return activated_neuron_postions[ran];
+  int ran = ran_gen_->RandomInt(0, num-1);
+  return neurons_.PositionByIndex(type, ran);
 }
 
 int Player::ResetWayForSynapse(position_t pos, position_t way_position) {
-  spdlog::get(LOGGER)->info("Player::ResetWayForSynapse");
-  std::unique_lock ul(mutex_all_neurons_);
-  if (neurons_.count(pos) && neurons_.at(pos)->type_ == UnitsTech::SYNAPSE) {
-    neurons_.at(pos)->set_way_points({way_position});
-    spdlog::get(LOGGER)->info("Player::ResetWayForSynapse: successfully");
-    return neurons_.at(pos)->ways_points().size();
+  LOG_INFO(LOG_PLAYER, "Player::ResetWayForSynapse");
+  if (Synapse* synapse = neurons_.Get<Synapse>(pos)) {
+    synapse->set_way_points({way_position});
+    neurons_snapshot_ = nullptr;
+    LOG_INFO(LOG_PLAYER, "Player::ResetWayForSynapse: successfully");
+    return synapse->ways_points().size();
   }
   else {
-    spdlog::get(LOGGER)->warn("Player::ResetWayForSynapse: neuron not found or wrong type");
+    LOG_WARN(LOG_PLAYER, "Player::ResetWayForSynapse: neuron not found or wrong type");
     return -1;
   }
 }
 
 int Player::AddWayPosForSynapse(position_t pos, position_t way_position) {
-  spdlog::get(LOGGER)->info("Player::AddWayPosForSynapse");
-  std::unique_lock ul(mutex_all_neurons_);
-  if (neurons_.count(pos) && neurons_.at(pos)->type_ == UnitsTech::SYNAPSE) {
-    auto cur_way = neurons_.at(pos)->ways_points();
+  LOG_INFO(LOG_PLAYER, "Player::AddWayPosForSynapse");
+  if (Synapse* synapse = neurons_.Get<Synapse>(pos)) {
+    auto cur_way = synapse->ways_points();
     cur_way.push_back(way_position);
-    neurons_.at(pos)->set_way_points(cur_way);
-    spdlog::get(LOGGER)->info("Player::AddWayPosForSynapse: successfully");
+    synapse->set_way_points(cur_way);
+    neurons_snapshot_ = nullptr;
+    LOG_INFO(LOG_PLAYER, "Player::AddWayPosForSynapse: successfully");
     return cur_way.size();
   }
   else {
-    spdlog::get(LOGGER)->warn("Player::AddWayPosForSynapse: neuron not found or wrong type");
+    LOG_WARN(LOG_PLAYER, "Player::AddWayPosForSynapse: neuron not found or wrong type");
     return -1;
   }
 }
 
 void Player::SwitchSwarmAttack(position_t pos) {
-  spdlog::get(LOGGER)->info("Player::SwitchSwarmAttack");
-  std::unique_lock ul(mutex_all_neurons_);
-  if (neurons_.count(pos) && neurons_.at(pos)->type_ == UnitsTech::SYNAPSE)
-    neurons_.at(pos)->set_swarm(!neurons_.at(pos)->swarm());
-  spdlog::get(LOGGER)->info("Player::SwitchSwarmAttack: done");
+  LOG_INFO(LOG_PLAYER, "Player::SwitchSwarmAttack");
+  if (Synapse* synapse = neurons_.Get<Synapse>(pos)) {
+    synapse->set_swarm(!synapse->swarm());
+    neurons_snapshot_ = nullptr;
+  }
+  LOG_INFO(LOG_PLAYER, "Player::SwitchSwarmAttack: done");
 }
 
 void Player::ChangeIpspTargetForSynapse(position_t pos, position_t target_pos) {
-  spdlog::get(LOGGER)->info("Player::ChangeIpspTargetForSynapse");
-  std::unique_lock ul(mutex_all_neurons_);
-  if (neurons_.count(pos) && neurons_.at(pos)->type_ == UnitsTech::SYNAPSE)
-    neurons_.at(pos)->set_ipsp_target_pos(target_pos);
-  spdlog::get(LOGGER)->info("Player::ChangeIpspTargetForSynapse: done");
+  LOG_INFO(LOG_PLAYER, "Player::ChangeIpspTargetForSynapse");
+  if (Synapse* synapse = neurons_.Get<Synapse>(pos))
+    synapse->set_ipsp_target_pos(target_pos);
+  LOG_INFO(LOG_PLAYER, "Player::ChangeIpspTargetForSynapse: done");
 }
 
 void Player::ChangeEpspTargetForSynapse(position_t pos, position_t target_pos) {
-  spdlog::get(LOGGER)->info("Player::ChangeEpspTargetForSynapse");
-  std::unique_lock ul(mutex_all_neurons_);
-  if (neurons_.count(pos) && neurons_.at(pos)->type_ == UnitsTech::SYNAPSE)
-    neurons_.at(pos)->set_epsp_target_pos(target_pos);
-  spdlog::get(LOGGER)->info("Player::ChangeEpspTargetForSynapse: done");
+  LOG_INFO(LOG_PLAYER, "Player::ChangeEpspTargetForSynapse");
+  if (Synapse* synapse = neurons_.Get<Synapse>(pos))
+    synapse->set_epsp_target_pos(target_pos);
+  LOG_INFO(LOG_PLAYER, "Player::ChangeEpspTargetForSynapse: done");
 }
 
 void Player::IncreaseResources(bool inc_iron) {
-  spdlog::get(LOGGER)->info("Player::IncreaseResources");
-  std::unique_lock ul_resources(mutex_resources_);
+  LOG_INFO(LOG_PLAYER, "Player::IncreaseResources");
   double gain = std::abs(log(resources_.at(Resources::OXYGEN).cur()+0.5));
-  for (auto& it : resources_) {
-    // Inc only if min 2 iron is distributed, inc iron only depending on audio.
-    if (it.second.Active() && !it.second.blocked() && (it.first != IRON || inc_iron))  
-      it.second.IncreaseResource(gain, resource_slowdown_);
-  }
-  spdlog::get(LOGGER)->info("Player::IncreaseResources: done");
+  // Inc only if min 2 iron is distributed, inc iron only depending on audio.
+  resources_.Increase(gain, resource_slowdown_, inc_iron);
+  LOG_INFO(LOG_PLAYER, "Player::IncreaseResources: done");
 }
 
 bool Player::DistributeIron(int resource) {
-  spdlog::get(LOGGER)->info("Player::DistributeIron: resource={}", resource);
-  std::unique_lock ul(mutex_resources_);
-  if (resources_.count(resource) == 0 || resource == IRON) {
-    spdlog::get(LOGGER)->error("Player::DistributeIron: invalid resource!");
+  LOG_INFO(LOG_PLAYER, "Player::DistributeIron: resource={}", resource);
+  if (!ResourceTable::Contains(resource) || resource == IRON) {
+    LOG_ERROR(LOG_PLAYER, "Player::DistributeIron: invalid resource!");
     return false;
   }
   else if (resources_.at(IRON).cur() < 1) {
-    spdlog::get(LOGGER)->info("Player::DistributeIron: not enough iron!");
+    LOG_INFO(LOG_PLAYER, "Player::DistributeIron: not enough iron!");
     return false;
   }
   int active_before = resources_.at(resource).Active();
@@ -290,19 +359,18 @@ bool Player::DistributeIron(int resource) {
   resources_.at(IRON).set_cur(resources_.at(IRON).cur() - 1);
   resources_.at(IRON).set_bound(resources_.at(IRON).bound() + 1);
 
-  spdlog::get(LOGGER)->info("Player::DistributeIron: success!");
+  LOG_INFO(LOG_PLAYER, "Player::DistributeIron: success!");
   return true;
 }
 
 bool Player::RemoveIron(int resource) {
-  spdlog::get(LOGGER)->info("Player::RemoveIron: resource={}", resource);
-  std::unique_lock ul(mutex_resources_);
-  if (resources_.count(resource) == 0 || resource == IRON) {
-    spdlog::get(LOGGER)->error("Player::RemoveIron: invalid resource!");
+  LOG_INFO(LOG_PLAYER, "Player::RemoveIron: resource={}", resource);
+  if (!ResourceTable::Contains(resource) || resource == IRON) {
+    LOG_ERROR(LOG_PLAYER, "Player::RemoveIron: invalid resource!");
     return false;
   }
   if (resources_.at(resource).distributed_iron() == 0) {
-    spdlog::get(LOGGER)->error("Player::RemoveIron: no iron distributed to this resource!");
+    LOG_ERROR(LOG_PLAYER, "Player::RemoveIron: no iron distributed to this resource!");
     return false;
   }
   int active_before = resources_.at(resource).Active();
@@ -312,152 +380,143 @@ bool Player::RemoveIron(int resource) {
     AddPotentialToNeuron(resources_.at(resource).pos(), 100);  // Remove resource neuron.
   resources_.at(IRON).set_cur(resources_.at(IRON).cur() + 1);
   resources_.at(IRON).set_bound(resources_.at(IRON).bound() -1);
-  spdlog::get(LOGGER)->info("Player::RemoveIron: success!");
+  LOG_INFO(LOG_PLAYER, "Player::RemoveIron: success!");
   return true;
 }
 
-Costs Player::GetMissingResources(int unit, int boast) {
-  std::shared_lock sl(mutex_resources_);
-  // Get costs for desired unit
-  Costs needed = units_costs_.at(unit);
-
-  // Check costs and add to missing.
-  std::map<int, double> missing;
-  for (const auto& it : needed)
-    if (resources_.at(it.first).cur() < it.second*boast) 
-      missing[it.first] = it.second - resources_.at(it.first).cur();
-  return missing;
+resource_mask_t Player::GetMissingResources(int unit, int boast) {
+  return MissingResources(resources_, unit, boast);
 }
 
 bool Player::TakeResources(int type, bool bind_resources, int boast) {
-  spdlog::get(LOGGER)->info("Player::TakeResources");
-  if (units_costs_.count(type) == 0) {
-    spdlog::get(LOGGER)->info("Player::TakeResources: done as free resource.");
+  LOG_INFO(LOG_PLAYER, "Player::TakeResources");
+  if (IsFree(type)) {
+    LOG_INFO(LOG_PLAYER, "Player::TakeResources: done as free resource.");
     return true;
   }
-  if (GetMissingResources(type, boast).size() > 0) {
-    spdlog::get(LOGGER)->warn("Player::TakeResources: taking resources with out enough resources!");
+  if (GetMissingResources(type, boast) != 0) {
+    LOG_WARN(LOG_PLAYER, "Player::TakeResources: taking resources with out enough resources!");
     return false;
   }
-  std::unique_lock ul_resources(mutex_resources_);
-  auto costs = units_costs_.at(type);
-  for (const auto& it : costs) {
-    resources_.at(it.first).set_cur(resources_.at(it.first).cur() - it.second*boast);
-    if (bind_resources)
-      resources_.at(it.first).set_bound(resources_.at(it.first).bound() + it.second*boast);
-  }
-  spdlog::get(LOGGER)->info("Player::TakeResources: done");
+  resources_.Take(CostsOf(type), boast, bind_resources);
+  units_built_[type]++;
+  LOG_INFO(LOG_PLAYER, "Player::TakeResources: done");
   return true;
 }
 
 bool Player::AddNeuron(position_t pos, int neuron_type, position_t epsp_target, position_t ipsp_target) {
-  spdlog::get(LOGGER)->info("Player::AddNeuron");
-  std::unique_lock ul(mutex_all_neurons_);
+  LOG_INFO(LOG_PLAYER, "Player::AddNeuron");
   if (!TakeResources(neuron_type, true))
     return false;
   if (neuron_type == UnitsTech::ACTIVATEDNEURON) {
-    spdlog::get(LOGGER)->debug("Player::AddNeuron: ActivatedNeuron");
-    std::shared_lock sl(mutex_technologies_);
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron: ActivatedNeuron");
     int speed_boast = technologies_.at(UnitsTech::DEF_SPEED).first * 40;
     int potential_boast = technologies_.at(UnitsTech::DEF_POTENTIAL).first;
-    neurons_[pos] = std::make_unique<ActivatedNeuron>(pos, potential_boast, speed_boast);
+    neurons_.Add(ActivatedNeuron(pos, potential_boast, speed_boast, game_time_));
   }
   else if (neuron_type == UnitsTech::SYNAPSE) {
-    spdlog::get(LOGGER)->debug("Player::AddNeuron: Synapse");
-    neurons_[pos] = std::make_unique<Synapse>(pos, technologies_.at(UnitsTech::SWARM).first*3+1, 
-        technologies_.at(UnitsTech::WAY).first, epsp_target, ipsp_target);
-    spdlog::get(LOGGER)->debug("Player::AddNeuron, created synapse, {}", neurons_.at(pos)->type_);
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron: Synapse");
+    neurons_.Add(Synapse(pos, technologies_.at(UnitsTech::SWARM).first*3+1, 
+        technologies_.at(UnitsTech::WAY).first, epsp_target, ipsp_target));
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron, created synapse, {}", neurons_.TypeAt(pos));
   }
   else if (neuron_type == UnitsTech::NUCLEUS) {
-    spdlog::get(LOGGER)->debug("Player::AddNeuron: Nucleus");
-    neurons_[pos] = std::make_unique<Nucleus>(pos);
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron: Nucleus");
+    neurons_.Add(Nucleus(pos));
     UpdateResourceLimits(0.1); // Increase max resource if new nucleus is built.
   }
   else if (neuron_type == UnitsTech::RESOURCENEURON) {
-    spdlog::get(LOGGER)->debug("Player::AddNeuron: ResourceNeuron");
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron: ResourceNeuron");
     std::string symbol = field_->GetSymbolAtPos(pos);
-    spdlog::get(LOGGER)->debug("Player::AddNeuron: got symbol: {}", symbol);
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron: got symbol: {}", symbol);
     int resource_type = resources_symbol_mapping.at(symbol);
-    spdlog::get(LOGGER)->debug("Player::AddNeuron: got resource_type: {}", resource_type);
-    neurons_[pos] = std::make_unique<ResourceNeuron>(pos, resource_type);
-    spdlog::get(LOGGER)->debug("Player::AddNeuron, Created resourceneuron, {}", neurons_.at(pos)->type_);
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron: got resource_type: {}", resource_type);
+    neurons_.Add(ResourceNeuron(pos, resource_type));
+    LOG_DEBUG(LOG_PLAYER, "Player::AddNeuron, Created resourceneuron, {}", neurons_.TypeAt(pos));
   }
-  spdlog::get(LOGGER)->info("Player::AddNeuron: done");
+  neurons_snapshot_ = nullptr;
+  LOG_INFO(LOG_PLAYER, "Player::AddNeuron: done");
   return true;
 }
 
 bool Player::AddPotential(position_t synapes_pos, int unit) {
-  spdlog::get(LOGGER)->info("Player::AddPotential.");
   if (!TakeResources(unit, false))
     return false;
   // Get way and target:
-  std::shared_lock sl_neurons(mutex_all_neurons_);
   // Check if synapses is blocked.
-  if (neurons_.count(synapes_pos) == 0 || neurons_.at(synapes_pos)->type_ != SYNAPSE 
-      || neurons_.at(synapes_pos)->blocked()) 
+  Synapse* synapse = neurons_.Get<Synapse>(synapes_pos);
+  if (!synapse || synapse->blocked()) 
     return true;
   
-  // Create way.
-  spdlog::get(LOGGER)->debug("Player::AddPotential: get way for potential.");
-  neurons_.at(synapes_pos)->UpdateIpspTargetIfNotSet(enemy_->GetRandomNeuron());
-  auto way = field_->GetWayForSoldier(synapes_pos, neurons_.at(synapes_pos)->GetWayPoints(unit));
+  // Create way: without custom way-points, potentials follow the flow-field towards their target.
+  LOG_DEBUG(LOG_PLAYER, "Player::AddPotential: get way for potential.");
+  synapse->UpdateIpspTargetIfNotSet(enemy_->GetRandomNeuron());
+  auto way_points = synapse->GetWayPoints(unit);
+  std::shared_ptr<const FlowField> flow = nullptr;
+  if (way_points.size() == 1)
+    flow = field_->GetFlowField(way_points.back());
+  path_t way = nullptr;
+  if (!flow)
+    way = field_->GetWayForSoldier(synapes_pos, way_points);
 
   // Add potential.
-  std::unique_lock ul_potentials(mutex_potentials_);
-  std::shared_lock sl_technologies(mutex_technologies_);
   // Get boast from technologies.
   int potential_boast = technologies_.at(UnitsTech::ATK_POTENIAL).first;
   int speed_boast = 50*technologies_.at(UnitsTech::ATK_POTENIAL).first;
   int duration_boast = technologies_.at(UnitsTech::ATK_DURATION).first;
-  sl_technologies.unlock();
   if (unit == UnitsTech::EPSP) {
-    spdlog::get(LOGGER)->debug("Player::AddPotential: epsp - get num epsps to create.");
+    LOG_DEBUG(LOG_PLAYER, "Player::AddPotential: epsp - get num epsps to create.");
     // Increase num of currently stored epsps and get number of epsps to create.
-    size_t num_epsps_to_create = neurons_.at(synapes_pos)->AddEpsp();
-    spdlog::get(LOGGER)->debug("Player::AddPotential: epsp - creating {} epsps.", num_epsps_to_create);
-    for (size_t i=0; i<num_epsps_to_create; i++)
-      potential_[utils::CreateId("epsp")] = Epsp(synapes_pos, way, potential_boast, speed_boast);
+    size_t num_epsps_to_create = synapse->AddEpsp();
+    LOG_DEBUG(LOG_PLAYER, "Player::AddPotential: epsp - creating {} epsps.", num_epsps_to_create);
+    // All epsps are created as one stack.
+    if (num_epsps_to_create > 0) {
+      Epsp epsp(synapes_pos, way, potential_boast, speed_boast);
+      epsp.count_ = num_epsps_to_create;
+      epsp.last_action_ = game_time_;
+      if (flow)
+        epsp.FollowFlowField(flow, way_points.back());
+      potential_.Insert(epsp);
+    }
   }
   else if (unit == UnitsTech::IPSP) {
-    spdlog::get(LOGGER)->debug("Player::AddPotential: ipsp - creating 1 ipsp.");
-    potential_[utils::CreateId("ipsp")] = Ipsp(synapes_pos, way, potential_boast, speed_boast, duration_boast);
+    LOG_DEBUG(LOG_PLAYER, "Player::AddPotential: ipsp - creating 1 ipsp.");
+    Ipsp ipsp(synapes_pos, way, potential_boast, speed_boast, duration_boast);
+    ipsp.last_action_ = game_time_;
+    if (flow)
+      ipsp.FollowFlowField(flow, way_points.back());
+    potential_.Insert(ipsp);
   }
-  spdlog::get(LOGGER)->info("Player::AddPotential: done.");
   return true;
 }
 
 bool Player::AddTechnology(int technology) {
-  std::unique_lock ul(mutex_technologies_);
-  spdlog::get(LOGGER)->info("Player::AddTechnology.");
+  LOG_INFO(LOG_PLAYER, "Player::AddTechnology.");
 
   // Check if technology exists, resources are missing and whether already fully researched.
   if (technologies_.count(technology) == 0)
     return false;
-  if (GetMissingResources(technology, technologies_[technology].first+1).size() > 0 
+  if (GetMissingResources(technology, technologies_[technology].first+1) != 0 
       || technologies_[technology].first == technologies_[technology].second)
     return false;
   if (!TakeResources(technology, false, technologies_[technology].first+1))
     return false;
  
   // Handle technology.
-  spdlog::get(LOGGER)->debug("Player::AddTechnology: Adding new technology");
-  std::unique_lock ul_resources(mutex_resources_);
+  LOG_DEBUG(LOG_PLAYER, "Player::AddTechnology: Adding new technology");
   technologies_[technology].first++;
+  technologies_snapshot_ = nullptr;
   if (technology == UnitsTech::WAY) {
-    for (auto& it : neurons_)
-      if (it.second->type_ == UnitsTech::SYNAPSE)
-        it.second->set_availible_ways(technologies_[technology].first);
+    for (auto& synapse : neurons_.synapses())
+      synapse.set_availible_ways(technologies_[technology].first);
+    neurons_snapshot_ = nullptr;
   }
   else if (technology == UnitsTech::SWARM) {
-    for (auto& it : neurons_)
-      if (it.second->type_ == UnitsTech::SYNAPSE)
-        it.second->set_max_stored(technologies_[technology].first*3+1);
+    for (auto& synapse : neurons_.synapses())
+      synapse.set_max_stored(technologies_[technology].first*3+1);
   }
-  else if (technology == UnitsTech::TOTAL_RESOURCE) {
-    ul_resources.unlock();
+  else if (technology == UnitsTech::TOTAL_RESOURCE)
     UpdateResourceLimits(0.2);
-    ul_resources.lock();
-  }
   else if (technology == UnitsTech::CURVE) {
     if (technologies_[technology].first == 3)
       resource_slowdown_ = 0.5;
@@ -466,199 +525,208 @@ bool Player::AddTechnology(int technology) {
   }
   else if (technology == UnitsTech::NUCLEUS_RANGE)
     cur_range_++;
-  spdlog::get(LOGGER)->info("Player::AddTechnology: success");
+  LOG_INFO(LOG_PLAYER, "Player::AddTechnology: success");
   return true;
 }
 
 void Player::MovePotential(Player* enemy) {
-  spdlog::get(LOGGER)->info("Player::MovePotential");
   // Move soldiers along the way to it's target and check if target is reached.
-  std::shared_lock sl_potenial(mutex_potentials_);
-  std::vector<std::string> potential_to_remove;
-  auto cur_time = std::chrono::steady_clock::now();
-  for (auto& it : potential_) {
+  std::vector<SlotHandle> potential_to_remove;
+  double cur_time = game_time_;
+  potential_.ForEach([&](SlotHandle id, Potential& potential) {
     // If target not yet reached and it is time for the next action, move potential
-    if (it.second.way_.size() > 0 && utils::GetElapsed(it.second.last_action_, cur_time) > it.second.speed_) {
-      it.second.pos_ = it.second.way_.front(); 
-      it.second.way_.pop_front();
-      it.second.last_action_ = cur_time;  // potential did action, so update last_action_.
+    if (!potential.AtTarget() && cur_time - potential.last_action_ > potential.speed_) {
+      potential.Step();
+      potential.last_action_ = cur_time;  // potential did action, so update last_action_.
     }
     // If target is reached, handle epsp and ipsp seperatly.
     // Epsp: add potential to target and add epsp to list of potentials to remove.
-    if (it.second.type_ == UnitsTech::EPSP) {
-      if (it.second.way_.size() == 0) {
-        enemy->AddPotentialToNeuron(it.second.pos_, it.second.potential_);
-        field_->AddBlink(it.second.pos_);
-        potential_to_remove.push_back(it.first); // remove 
+    if (potential.type_ == UnitsTech::EPSP) {
+      if (potential.AtTarget()) {
+        enemy->AddPotentialToNeuron(potential.pos_, potential.potential_*potential.count_);
+        field_->AddBlink(potential.pos_);
+        potential_to_remove.push_back(id); // remove 
       }
     }
     // Ipsp: check if just time is up -> remove ipsp, otherwise -> block target.
     else {
       // If duration since last action is reached, add ipsp to list of potentials to remove and unblock target.
-      if (utils::GetElapsed(it.second.last_action_, cur_time) > it.second.duration_*1000) {
-        enemy->SetBlockForNeuron(it.second.pos_, false);  // unblock target.
-        potential_to_remove.push_back(it.first); // remove 
+      if (cur_time - potential.last_action_ > potential.duration_*1000) {
+        enemy->SetBlockForNeuron(potential.pos_, false);  // unblock target.
+        potential_to_remove.push_back(id); // remove 
       }
-      else if (it.second.way_.size() == 0)
-        enemy->SetBlockForNeuron(it.second.pos_, true);  // block target
+      else if (potential.AtTarget())
+        enemy->SetBlockForNeuron(potential.pos_, true);  // block target
     }
-  }
-  sl_potenial.unlock();
+  });
 
   // Remove potential which has reached it's target.
-  std::unique_lock ul_potential(mutex_potentials_);
   for (const auto& it : potential_to_remove)
-    potential_.erase(it);
+    potential_.Erase(it);
+}
+
+void Player::PublishSnapshot() {
+  // Reuse memory of snapshot published before last, if no reader holds it anymore.
+  std::shared_ptr<PlayerSnapshot> snapshot = std::move(spare_snapshot_);
+  if (snapshot && snapshot.use_count() == 1)
+    std::atomic_thread_fence(std::memory_order_acquire);  // last reader is done.
+  else {
+    snapshot = std::make_shared<PlayerSnapshot>();
+    snapshot->potential_grid_ = SpatialHash(field_->lines(), field_->cols(), DEF_RANGE);
+  }
+  snapshot->potential_ = potential_;
+  std::vector<position_t> positions;
+  positions.reserve(potential_.size());
+  for (const auto& it : potential_)
+    positions.push_back(it.pos_);
+  snapshot->potential_grid_.Build(positions);
+  snapshot->resources_ = resources_;
+  if (!technologies_snapshot_)
+    technologies_snapshot_ = std::make_shared<const technologies_t>(technologies_);
+  snapshot->technologies_ = technologies_snapshot_;
+  if (!neurons_snapshot_) {
+    auto neurons = std::make_shared<neuron_snapshots_t>();
+    for (const auto& [pos, id] : neurons_.index()) {
+      const Neuron& neuron = neurons_.at(pos);
+      const Synapse* synapse = neurons_.Get<Synapse>(pos);
+      neurons->emplace_hint(neurons->end(), pos, NeuronSnapshot{id.type_, neuron.blocked(), neuron.voltage(),
+          neuron.max_voltage(), synapse && synapse->swarm(), (synapse) ? synapse->ways_points().size() : 0, 
+          (synapse) ? synapse->num_availible_ways() : 0});
+    }
+    neurons_snapshot_ = std::move(neurons);
+  }
+  snapshot->neurons_ = neurons_snapshot_;
+  snapshot->cur_range_ = cur_range_;
+  snapshot->resource_slowdown_ = resource_slowdown_;
+  spare_snapshot_ = std::const_pointer_cast<PlayerSnapshot>(std::atomic_load(&snapshot_));
+  std::atomic_store(&snapshot_, std::shared_ptr<const PlayerSnapshot>(snapshot));
 }
 
 void Player::SetBlockForNeuron(position_t pos, bool blocked) {
-  spdlog::get(LOGGER)->info("Player::SetBlockForNeuron");
-  std::unique_lock ul(mutex_all_neurons_);
-  if (neurons_.count(pos) > 0) {
-    neurons_[pos]->set_blocked(blocked);
+  LOG_INFO(LOG_PLAYER, "Player::SetBlockForNeuron");
+  if (neurons_.Contains(pos)) {
+    neurons_.at(pos).set_blocked(blocked);
+    neurons_snapshot_ = nullptr;
     // If resource neuron, block/ unblock resource.
-    if (neurons_[pos]->type_ == RESOURCENEURON)
-      resources_.at(neurons_[pos]->resource()).set_blocked(blocked);
+    if (const ResourceNeuron* resource_neuron = neurons_.Get<ResourceNeuron>(pos))
+      resources_.at(resource_neuron->resource()).set_blocked(blocked);
   }
-  spdlog::get(LOGGER)->info("Player::SetBlockForNeuron: done");
+  LOG_INFO(LOG_PLAYER, "Player::SetBlockForNeuron: done");
 }
 
 void Player::HandleDef(Player* enemy) {
-  spdlog::get(LOGGER)->info("Player::HandleDef");
-  std::unique_lock ul(mutex_all_neurons_);
-  auto cur_time = std::chrono::steady_clock::now();
-  for (auto& neuron : neurons_) {
-    if (neuron.second->type_ != UnitsTech::ACTIVATEDNEURON)
-      continue;
+  double cur_time = game_time_;
+  auto enemy_snapshot = enemy->snapshot();
+  const auto& potentials = enemy_snapshot->potential_;
+  for (auto& neuron : neurons_.activated_neurons()) {
     // Check if activated neurons recharge is done.
-    if (utils::GetElapsed(neuron.second->last_action(), cur_time) > neuron.second->speed() 
-        && !neuron.second->blocked()) {
-      // Check for potentials in range of activated neuron.
-      for (const auto& potential : enemy->potential()) {
-        int distance = utils::Dist(neuron.first, potential.second.pos_);
-        if (distance < 3) {
-          enemy->NeutralizePotential(potential.first, neuron.second->potential_slowdown());
-          field_->AddBlink(potential.second.pos_);
-          neuron.second->set_last_action(cur_time);  // neuron did action, so update last_action_.
-          break;
-        }
-      }
+    if (cur_time - neuron.last_action() > neuron.speed() && !neuron.blocked()) {
+      // Check for potentials in range of activated neuron (only cells of spatial hash in range).
+      enemy_snapshot->potential_grid_.ForEachInRange(neuron.pos_, DEF_RANGE, [&](uint32_t i) {
+          // Potential might already have been neutralized since snapshot was published.
+          if (!enemy->NeutralizePotential(potentials.handle(i), neuron.potential_slowdown()))
+            return true;
+          field_->AddBlink(potentials.values()[i].pos_);
+          neuron.set_last_action(cur_time);  // neuron did action, so update last_action_.
+          return false;
+        });
     }
   }
 }
 
-void Player::NeutralizePotential(std::string id, int potential) {
-  spdlog::get(LOGGER)->info("Player::NeutralizePotential: {}", potential);
-  std::unique_lock ul(mutex_potentials_);
-  if (potential_.count(id) > 0) {
-    spdlog::get(LOGGER)->debug("Player::NeutralizePotential: left potential: {}", 
-        potential_.at(id).potential_);
-    potential_.at(id).potential_ -= potential;
-    // Remove potential only if not already at it's target (length of way is greater than zero).
-    if (potential_.at(id).potential_ == 0 && potential_.at(id).way_.size() > 0) {
-      spdlog::get(LOGGER)->debug("Player::NeutralizePotential: deleting potential...");
-      potential_.erase(id);
-      spdlog::get(LOGGER)->debug("Player::NeutralizePotential: done.");
-    }
+bool Player::NeutralizePotential(SlotHandle id, int potential) {
+  if (!potential_.Contains(id))
+    return false;
+  LOG_DEBUG(LOG_PLAYER, "Player::NeutralizePotential: left potential: {}", potential_.at(id).potential_);
+  // Only one potential of a stack is hit: split it from stack.
+  if (potential_.at(id).count_ > 1) {
+    Potential hit = potential_.at(id);
+    hit.count_ = 1;
+    potential_.at(id).count_--;
+    id = potential_.Insert(hit);
+  }
+  potential_.at(id).potential_ -= potential;
+  // Remove potential only if not already at it's target (length of way is greater than zero).
+  if (potential_.at(id).potential_ == 0 && !potential_.at(id).AtTarget()) {
+    LOG_DEBUG(LOG_PLAYER, "Player::NeutralizePotential: deleting potential...");
+    potential_.Erase(id);
+    LOG_DEBUG(LOG_PLAYER, "Player::NeutralizePotential: done.");
   }
-  spdlog::get(LOGGER)->info("Player::NeutralizePotential: done.");
+  return true;
 }
 
 void Player::AddPotentialToNeuron(position_t pos, int potential) {
-  std::unique_lock ul_all_neurons(mutex_all_neurons_);
-  spdlog::get(LOGGER)->info("Player::AddPotentialToNeuron: {} {}", utils::PositionToString(pos), potential);
+  LOG_INFO(LOG_PLAYER, "Player::AddPotentialToNeuron: {} {}", utils::PositionToString(pos), potential);
   if (potential < 0) {
-    spdlog::get(LOGGER)->warn("Player::AddPotentialToNeuron: negative potential!");
+    LOG_WARN(LOG_PLAYER, "Player::AddPotentialToNeuron: negative potential!");
     return;
   }
 
-  if (neurons_.count(pos) > 0) {
-    spdlog::get(LOGGER)->debug("Player::AddPotentialToNeuron: left potential: {}", neurons_[pos]->voltage());
-    if (neurons_.at(pos)->IncreaseVoltage(potential)) {
-      int type = neurons_.at(pos)->type_;
-      spdlog::get(LOGGER)->debug("Player::AddPotentialToNeuron: erasing {}", type);
-      neurons_.erase(pos);
-      spdlog::get(LOGGER)->debug("Player::AddPotentialToNeuron: erasing done");
+  if (neurons_.Contains(pos)) {
+    LOG_DEBUG(LOG_PLAYER, "Player::AddPotentialToNeuron: left potential: {}", neurons_.at(pos).voltage());
+    neurons_snapshot_ = nullptr;
+    if (neurons_.at(pos).IncreaseVoltage(potential)) {
+      int type = neurons_.TypeAt(pos);
+      LOG_DEBUG(LOG_PLAYER, "Player::AddPotentialToNeuron: erasing {}", type);
+      neurons_.Erase(pos);
+      field_->RemoveFlowField(pos);
+      LOG_DEBUG(LOG_PLAYER, "Player::AddPotentialToNeuron: erasing done");
       // Potentially deactivate all neurons formally in range of the destroyed nucleus.
       if (type == UnitsTech::NUCLEUS) {
-        ul_all_neurons.unlock();
         CheckNeuronsAfterNucleusDies();
-        ul_all_neurons.lock();
         UpdateResourceLimits(-0.1);  // Remove added max resources when nucleus dies.
       }
-      spdlog::get(LOGGER)->debug("Player::AddPotentialToNeuron: adding potential finished.");
+      LOG_DEBUG(LOG_PLAYER, "Player::AddPotentialToNeuron: adding potential finished.");
     }
   }
-  spdlog::get(LOGGER)->info("Player::AddPotentialToNeuron: done");
+  LOG_INFO(LOG_PLAYER, "Player::AddPotentialToNeuron: done");
 }
 
 void Player::CheckNeuronsAfterNucleusDies() {
-  spdlog::get(LOGGER)->info("Player::CheckNeuronsAfterNucleusDies");
+  LOG_INFO(LOG_PLAYER, "Player::CheckNeuronsAfterNucleusDies");
   // Get all nucleus.
-  std::vector<position_t> all_nucleus = GetAllPositionsOfNeurons(UnitsTech::NUCLEUS);
-  std::shared_lock sl(mutex_all_neurons_);
+  const auto& all_nucleus = neurons_.positions(UnitsTech::NUCLEUS);
   std::vector<position_t> neurons_to_remove;
-  for (const auto& neuron : neurons_) {
+  for (const auto& neuron : neurons_.index()) {
     // Nucleus are not affekted.
-    if (neuron.second->type_ == UnitsTech::NUCLEUS)
+    if (neuron.second.type_ == UnitsTech::NUCLEUS)
       continue;
     // Add first and if in range of a nucleus, remove again.
     neurons_to_remove.push_back(neuron.first);
-    for (const auto& nucleus_pos : all_nucleus)
-      if (utils::Dist(neuron.first, nucleus_pos) <= cur_range_)
+    for (const auto& nucleus_pos : all_nucleus) {
+      if (geometry::DistSq(neuron.first, nucleus_pos) <= cur_range_*cur_range_) {
         neurons_to_remove.pop_back();
+        break;
+      }
+    }
   }
-  sl.unlock();
-  std::unique_lock ul(mutex_all_neurons_);
   for (const auto& it : neurons_to_remove) {
-    neurons_.erase(it);
+    neurons_.Erase(it);
   }
-  spdlog::get(LOGGER)->info("Player::CheckNeuronsAfterNucleusDies: done");
-}
-
-std::string Player::GetPotentialIdIfPotential(position_t pos, int unit) {
-  std::shared_lock sl(mutex_potentials_);
-  for (const auto& it : potential_)
-    if (it.second.pos_ == pos && (unit == -1 || it.second.type_ == unit))
-      return it.first;
-  return "";
+  if (!neurons_to_remove.empty())
+    neurons_snapshot_ = nullptr;
+  LOG_INFO(LOG_PLAYER, "Player::CheckNeuronsAfterNucleusDies: done");
 }
 
-choice_mapping_t Player::GetOptionsForSynapes(position_t pos) {
-  spdlog::get(LOGGER)->info("Player::GetOptionsForSynapes");
-  std::shared_lock sl_technologies(mutex_technologies_);
-  choice_mapping_t mapping;
-
-  if (neurons_.count(pos) == 0 || neurons_.at(pos)->type_ != SYNAPSE) {
-    spdlog::get(LOGGER)->warn("Player::GetOptionsForSynapes: neuron at position does'n exist, or is no synapse: {}.", 
-        utils::PositionToString(pos));
-    return mapping;
+SlotHandle Player::GetPotentialIdIfPotential(position_t pos, int unit) {
+  for (size_t i=0; i<potential_.size(); i++) {
+    const auto& potential = potential_.values()[i];
+    if (potential.pos_ == pos && (unit == -1 || potential.type_ == unit))
+      return potential_.handle(i);
   }
-  
-  mapping[0] = {"(Re-)set way.", (technologies_.at(UnitsTech::WAY).first > 0) ? COLOR_AVAILIBLE : COLOR_DEFAULT};
-  mapping[1] = {"Add way-point.", (neurons_.at(pos)->ways_points().size() < neurons_.at(pos)->num_availible_ways()) 
-    ? COLOR_AVAILIBLE : COLOR_DEFAULT};
-  mapping[2] = {"Select target for ipsp.", (technologies_.at(UnitsTech::TARGET).first > 0) 
-    ? COLOR_AVAILIBLE : COLOR_DEFAULT};
-  mapping[3] = {"Select target for epsp.", (technologies_.at(UnitsTech::TARGET).first > 1) 
-    ? COLOR_AVAILIBLE : COLOR_DEFAULT};
-  mapping[4] = {(neurons_.at(pos)->swarm()) ? "Turn swarm-attack off" : "Turn swarm-attack on", 
-    (technologies_.at(UnitsTech::SWARM).first > 0) ? COLOR_AVAILIBLE : COLOR_DEFAULT};
-  spdlog::get(LOGGER)->info("Player::GetOptionsForSynapes: done");
-  return mapping;
+  return SlotHandle();
 }
 
 void Player::UpdateResourceLimits(float faktor) {
-  spdlog::get(LOGGER)->info("Player::UpdateResourceLimits");
-  std::unique_lock ul(mutex_resources_); 
-  for (auto& it : resources_)
-    it.second.set_limit(it.second.limit() + it.second.limit()*faktor);
-  spdlog::get(LOGGER)->info("Player::Done");
+  LOG_INFO(LOG_PLAYER, "Player::UpdateResourceLimits");
+  for (int i=0; i<NUM_RESOURCES; i++)
+    resources_.at(i).set_limit(resources_.at(i).limit() + resources_.at(i).limit()*faktor);
+  LOG_INFO(LOG_PLAYER, "Player::Done");
 }
 
 std::string Player::GetCurrentResources() {
   std::string msg = "resources: ";
-  for (const auto& it : resources()) 
-    msg += resources_name_mapping.at(it.first) + ": " + std::to_string(it.second.cur()) + ", ";
+  for (int i=0; i<NUM_RESOURCES; i++) 
+    msg += resources_name_mapping.at(i) + ": " + std::to_string(resources_.at(i).cur()) + ", ";
   return msg;
 }
@@ -5,18 +5,19 @@
 #include <iostream>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <set>
-#include <shared_mutex>
 #include <vector>
 
 #include "audio/audio.h"
 #include "constants/codes.h"
 #include "constants/costs.h"
+#include "objects/neuron_store.h"
 #include "objects/resource.h"
 #include "objects/units.h"
 #include "random/random.h"
+#include "utils/slot_map.h"
+#include "utils/spatial_hash.h"
 
 class Field;
 
@@ -30,10 +31,101 @@ using namespace costs;
 #define COLOR_MARKED 6
 #define COLOR_PROGRESS 7
 
+#define DEF_RANGE 3  ///< activated neurons neutralize potentials closer than this.
+
 typedef std::map<size_t, std::pair<std::string, int>> choice_mapping_t;
 typedef std::pair<int, int> position_t;
 typedef std::pair<size_t, size_t> tech_of_t;
 
+/**
+ * State of a neuron as seen by other threads.
+ */
+struct NeuronSnapshot {
+  int type_;
+  bool blocked_;
+  int voltage_;
+  int max_voltage_;
+  bool swarm_;  ///< synapses only.
+  size_t num_way_points_;  ///< synapses only.
+  size_t num_availible_ways_;  ///< synapses only.
+};
+
+typedef std::map<position_t, NeuronSnapshot> neuron_snapshots_t;
+typedef std::map<int, tech_of_t> technologies_t;
+
+/**
+ * Immutable copy of a player's state, published by the simulation, so that
+ * other threads (defence of enemy, renderer, input) read without touching the
+ * player. Neurons and technologies are shared between snapshots until they
+ * change.
+ */
+struct PlayerSnapshot {
+  SlotMap<Potential> potential_;
+  SpatialHash potential_grid_;  ///< positions of potentials (indices into potential_).
+  ResourceTable resources_;
+  std::shared_ptr<const technologies_t> technologies_;
+  std::shared_ptr<const neuron_snapshots_t> neurons_;
+  int cur_range_;
+  double resource_slowdown_;
+
+  /**
+   * Gets missing resources for given unit.
+   * @param[in] unit
+   * @param[in] boast
+   * @return bitmask of missing resources (0 if all needed resources are availible).
+   */
+  resource_mask_t GetMissingResources(int unit, int boast=1) const;
+  template<int unit>
+  resource_mask_t GetMissingResources(int boast=1) const {
+    return resources_.Missing(CostsOf<unit>(), boast);
+  }
+
+  /**
+   * Gets positions of all neurons of given type.
+   * @param[in] type (-1: all neurons).
+   * @return positions.
+   */
+  std::vector<position_t> GetAllPositionsOfNeurons(int type=-1) const;
+
+  /**
+   * Gets type of neuron at given position.
+   * @param[in] pos
+   * @return type or -1 if no neuron at position.
+   */
+  int GetNeuronTypeAtPosition(position_t pos) const;
+
+  bool IsNeuronBlocked(position_t pos) const;
+
+  /**
+   * Gets position of first nucleus.
+   * @return position or {-1, -1} if player has no nucleus.
+   */
+  position_t GetOneNucleus() const;
+
+  /**
+   * Gets voltage of first nucleus in format: "[cur_voltage] / [max_voltage]".
+   */
+  std::string GetNucleusLive() const;
+
+  /**
+   * Gets availible option (depending of current synapse-state and
+   * technologies) for synapse.
+   * @param[in] pos position of synapse
+   * @return options.
+   */
+  choice_mapping_t GetOptionsForSynapes(position_t pos) const;
+
+  /**
+   * Show current status (resources, gatherers, den-lp ...)
+   */
+  std::vector<std::string> GetCurrentStatusLine() const;
+};
+
+/**
+ * Player (human or ki). Not thread-safe: only the simulation thread changes
+ * and reads a player, all other threads read published snapshots.
+ */
+
 class Player {
   public:
 
@@ -48,15 +140,32 @@ class Player {
     Player(position_t nucleus_pos, Field* field, RandomGenerator* ran_gen, 
         std::map<int, position_t> resource_positions);
 
+    virtual ~Player() = default;
+
     // getter:
-    std::map<std::string, Potential> potential();
+    const SlotMap<Potential>& potential() const;
     int cur_range();
-    std::map<int, Resource> resources();
+    const ResourceTable& resources() const;
     std::map<int, tech_of_t> technologies();
+    std::map<int, unsigned int> units_built();  ///< units and technologies paid for, by type.
+
+    /**
+     * Gets last published snapshot (single atomic load, no locking).
+     * @return snapshot of player's state.
+     */
+    std::shared_ptr<const PlayerSnapshot> snapshot() const;
+    double game_time() const;
 
     // setter
     void set_enemy(Player* enemy);
 
+    /**
+     * Sets current game-time (set by simulation at the beginning of every
+     * tick; used for all timing of neurons and potentials).
+     * @param[in] game_time milliseconds since start of game.
+     */
+    void set_game_time(double game_time);
+
     // methods:
     /** 
      * Gets the position of the closet neuron of a specific type to a given position.
@@ -100,16 +209,43 @@ class Player {
     std::vector<position_t> GetAllPositionsOfNeurons(int type=-1);
 
     /**
-     * Gets position of a random activated neuron.
+     * Gets number of neurons of given type (without copying positions).
+     * @param[in] type (-1: all neurons).
+     * @return number of neurons.
+     */
+    size_t GetNumNeurons(int type=-1);
+
+    /**
+     * Calls func(pos) for position of every neuron of given type (sorted by
+     * position, without copying positions).
+     * @param[in] type (-1: all neurons).
+     * @param[in] func
+     */
+    template<class F>
+    void ForEachNeuronPosition(int type, F func) {
+      if (type == -1) {
+        for (const auto& it : neurons_.index())
+          func(it.first);
+      }
+      else if (type >= 0 && type < NUM_NEURON_TYPES) {
+        for (const auto& pos : neurons_.positions(type))
+          func(pos);
+      }
+    }
+
+    /**
+     * Gets position of a random neuron of given types.
      * @param[in] type
-     * @return Position of a random activated neuron.
+     * @return Position of a random neuron of given types. If player has no
+     * neuron of given types, position of random neuron of any type
+     * ({-1, -1} if player has no neurons).
      */
     position_t GetRandomNeuron(std::vector<int> type={UnitsTech::ACTIVATEDNEURON});
 
     /**
-     * Gets the position of the first nucleus in unsorted dictionary of all neurons. Thus
+     * Gets the position of the nucleus with the smallest position. Thus
      * returned position may change, as number of nucleus of player changes.
-     * @return position of first nucleus in unsorted dictionary of all neurons. 
+     * @return position of first nucleus ({-1, -1} if there is no nucleus).
      */
     position_t GetOneNucleus();
 
@@ -149,19 +285,6 @@ class Player {
      */
     void ChangeEpspTargetForSynapse(position_t pos, position_t target_pos);
 
-    /**
-     * Gets availible option (depending of current synapse-state and
-     * technologies) for synapse.
-     * @param[in] pos position of synapse
-     * @return options.
-     */
-    choice_mapping_t GetOptionsForSynapes(position_t pos);
-   
-    /**
-     * Show current status (resources, gatherers, den-lp ...)
-     */
-    std::vector<std::string> GetCurrentStatusLine();
-
     /** 
      * Increases all resources by a the current boast*gain*negative-faktor.
      * gain is calculated as: `|log(current-oxygen+0.5)|`
@@ -182,10 +305,14 @@ class Player {
     /**
      * Returns missing resources for given unit.
      * @param unit code for unit for which to check.
-     * @return missing resources for this unit. Empty if all needed resources
-     * are availible.
+     * @return bitmask of missing resources for this unit. 0 if all needed
+     * resources are availible.
      */
-    Costs GetMissingResources(int unit, int boast=1);
+    resource_mask_t GetMissingResources(int unit, int boast=1);
+    template<int unit>
+    resource_mask_t GetMissingResources(int boast=1) const {
+      return resources_.Missing(CostsOf<unit>(), boast);
+    }
 
     /**
      * Adds a newly create neuron to list of all neurons.
@@ -198,7 +325,7 @@ class Player {
     /**
      * Adds new potential and sets it's current position and the way to it's
      * target.
-     * A potential is always created with a new, random id, as (in contrast to
+     * A potential is always identified by a handle, as (in contrast to
      * neurons) a potential is not uniquely defined by it's position.
      * @param[in] pos start position of new potential.
      * @param[in] way to the enemies neuron.
@@ -223,10 +350,18 @@ class Player {
      */
     void MovePotential(Player* enemy);
 
+    /**
+     * Publishes snapshot of current potentials, resources, technologies and
+     * neurons. Called by simulation after potentials have moved. Neurons and
+     * technologies are only copied if changed since last snapshot.
+     */
+    void PublishSnapshot();
+
     void SetBlockForNeuron(position_t pos, bool block);
 
     /**
-     * Function checking whether a tower has defeted a soldier.
+     * Function checking whether a tower has defeted a soldier (using enemy's
+     * last published snapshot).
      * @param player 
      * @param ki_
      */
@@ -234,9 +369,12 @@ class Player {
 
     /**
      * Decrease potential and removes potential if potential is down to zero.
+     * If potential is a stack, only one potential is split from the stack and
+     * decreased.
      * @param id of potential.
+     * @return whether potential still existed.
      */
-    void NeutralizePotential(std::string id, int potential);
+    bool NeutralizePotential(SlotHandle id, int potential);
 
     /**
      * Adds potential to neuron and destroies neuron if max potential is reached.
@@ -254,8 +392,10 @@ class Player {
     /**
      * Returns id of potential iof unit at given position is potential.
      * @param[in] pos position to check for.
+     * @param[in] unit type of potential (-1: any type).
+     * @return handle of potential (invalid handle if no potential at position).
      */
-    std::string GetPotentialIdIfPotential(position_t pos, int unit=-1);
+    SlotHandle GetPotentialIdIfPotential(position_t pos, int unit=-1);
 
     /** 
      * Increase potential of neuron.
@@ -274,21 +414,23 @@ class Player {
     Player* enemy_;
     int cur_range_;
 
-    std::shared_mutex mutex_resources_;
-    std::map<int, Resource> resources_;
+    ResourceTable resources_;
+    std::map<int, unsigned int> units_built_;
     double resource_slowdown_;
 
-
-    std::shared_mutex mutex_all_neurons_;
-    std::map<position_t, std::unique_ptr<Neuron>> neurons_;
+    NeuronStore neurons_;
     position_t main_nucleus_pos_;
 
-    std::shared_mutex mutex_potentials_;
-    std::map<std::string, Potential> potential_;
+    SlotMap<Potential> potential_;
 
-    std::shared_mutex mutex_technologies_;
     std::map<int, tech_of_t> technologies_;
 
+    std::shared_ptr<const PlayerSnapshot> snapshot_;  ///< only accessed via atomic load/ store.
+    std::shared_ptr<PlayerSnapshot> spare_snapshot_;  ///< previous snapshot, reused once no reader holds it.
+    std::shared_ptr<const neuron_snapshots_t> neurons_snapshot_;  ///< reset, whenever neurons change.
+    std::shared_ptr<const technologies_t> technologies_snapshot_;  ///< reset, whenever technologies change.
+    double game_time_;
+
     // methods
     bool TakeResources(int type, bool bind_resources, int boast=1);
 
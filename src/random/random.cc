@@ -2,19 +2,23 @@
 #include "audio/audio.h"
 #include "constants/codes.h"
 #include "spdlog/spdlog.h"
+#include "utils/logger.h"
 #include <algorithm>
 #include <cstddef>
 #include <cstdlib>
+#include <random>
 #include <vector>
 
-#define LOGGER "logger"
 
-RandomGenerator::RandomGenerator() {
+RandomGenerator::RandomGenerator() : RandomGenerator(std::random_device()()) {}
+
+RandomGenerator::RandomGenerator(unsigned int seed) : engine_(seed) {
   get_ran_ = &RandomGenerator::ran;
   last_point_ = 0;
 }
 
-RandomGenerator::RandomGenerator(AudioData analysed_data, size_t(RandomGenerator::*generator)(size_t, size_t)) {
+RandomGenerator::RandomGenerator(AudioData analysed_data, size_t(RandomGenerator::*generator)(size_t, size_t), 
+    unsigned int seed) : engine_(seed) {
   analysed_data_ = analysed_data;
   get_ran_ = generator;
   last_point_ = 0;
@@ -40,12 +44,12 @@ RandomGenerator::RandomGenerator(AudioData analysed_data, size_t(RandomGenerator
 
 int RandomGenerator::RandomInt(size_t min, size_t max) {
   unsigned int random_faktor = (this->*get_ran_)(min, max);
-  spdlog::get(LOGGER)->info("RandomGenerator::RandomInt: retuning {} < {} < {}", min, random_faktor, max);
+  LOG_INFO(LOG_GAME, "RandomGenerator::RandomInt: retuning {} < {} < {}", min, random_faktor, max);
   return random_faktor;
 }
 
 size_t RandomGenerator::ran(size_t min, size_t max) {
-  return min + (rand()% (max - min + 1)); 
+  return min + (engine_()% (max - min + 1)); 
 }
 
 size_t RandomGenerator::ran_note(size_t min, size_t max) {
@@ -3,22 +3,31 @@
 
 #include "audio/audio.h"
 #include <cstddef>
+#include <random>
 
 class RandomGenerator {
   public:
     /** 
-     * Constructor for tests (no audio needed). Uses simple system random
-     * function.
+     * Constructor for tests (no audio needed). Uses std::random, seeded
+     * randomly.
      */
     RandomGenerator();
 
+    /** 
+     * Constructor (no audio needed). Uses std::random with given seed.
+     * @param[in] seed
+     */
+    RandomGenerator(unsigned int seed);
+
     /**
      * Constructor with audio data and custom random function.
      * @param[in] analysed_data used for generating random numbers.
      * @param[in] generator custom function to generate random numbers based on
      * audio data.
+     * @param[in] seed used by generators not based on audio data.
      */
-    RandomGenerator(AudioData analysed_data, size_t(RandomGenerator::*generator)(size_t, size_t));
+    RandomGenerator(AudioData analysed_data, size_t(RandomGenerator::*generator)(size_t, size_t), 
+        unsigned int seed=0);
 
     /**
      * Base function calling set random number generator.
@@ -59,6 +68,7 @@ class RandomGenerator {
     AudioData analysed_data_;
     size_t last_point_;
     std::vector<int> peaks_;
+    std::mt19937 engine_;
     size_t(RandomGenerator::*get_ran_)(size_t min, size_t max);
 
     // functions:
@@ -0,0 +1,141 @@
+#include <curses.h>
+#include <locale>
+#include <string>
+
+#include "render/renderer.h"
+
+CursesRenderer::CursesRenderer() {
+  setlocale(LC_ALL, "");
+  initscr();
+  cbreak();
+  noecho();
+  curs_set(0);
+  keypad(stdscr, true);
+  clear();
+  use_default_colors();
+  start_color();
+}
+
+CursesRenderer::~CursesRenderer() {
+  endwin();
+}
+
+int CursesRenderer::lines() const {
+  return LINES;
+}
+
+int CursesRenderer::cols() const {
+  return COLS;
+}
+
+void CursesRenderer::AddStr(int line, int col, const std::string& str) {
+  mvaddstr(line, col, str.c_str());
+}
+
+void CursesRenderer::AddCh(int line, int col, char c) {
+  mvaddch(line, col, c);
+}
+
+void CursesRenderer::SetColor(int color) {
+  attron(COLOR_PAIR(color));
+}
+
+void CursesRenderer::Clear() {
+  clear();
+}
+
+void CursesRenderer::Refresh() {
+  refresh();
+}
+
+int CursesRenderer::GetCh() {
+  return getch();
+}
+
+void CursesRenderer::ShowInput(bool show) {
+  if (show) {
+    echo();
+    curs_set(1);
+  }
+  else {
+    noecho();
+    curs_set(0);
+  }
+}
+
+FramebufferRenderer::FramebufferRenderer(int lines, int cols) : lines_(lines), cols_(cols), color_(0) {
+  Clear();
+}
+
+int FramebufferRenderer::lines() const {
+  return lines_;
+}
+
+int FramebufferRenderer::cols() const {
+  return cols_;
+}
+
+void FramebufferRenderer::AddStr(int line, int col, const std::string& str) {
+  // Split into utf-8 symbols: each symbol starts with a byte not of the form 10xxxxxx.
+  std::string symbol = "";
+  for (const char c : str) {
+    if ((c & 0xC0) != 0x80 && symbol != "") {
+      Set(line, col++, symbol);
+      symbol = "";
+    }
+    symbol += c;
+  }
+  if (symbol != "")
+    Set(line, col, symbol);
+}
+
+void FramebufferRenderer::AddCh(int line, int col, char c) {
+  Set(line, col, std::string(1, c));
+}
+
+void FramebufferRenderer::SetColor(int color) {
+  color_ = color;
+}
+
+void FramebufferRenderer::Clear() {
+  cells_.assign(lines_*cols_, " ");
+  colors_.assign(lines_*cols_, 0);
+}
+
+int FramebufferRenderer::GetCh() {
+  if (input_.size() == 0)
+    return INPUT_END;
+  int key = input_.front();
+  input_.pop_front();
+  return key;
+}
+
+std::string FramebufferRenderer::At(int line, int col) const {
+  if (line < 0 || line >= lines_ || col < 0 || col >= cols_)
+    return "";
+  return cells_[line*cols_ + col];
+}
+
+int FramebufferRenderer::ColorAt(int line, int col) const {
+  if (line < 0 || line >= lines_ || col < 0 || col >= cols_)
+    return -1;
+  return colors_[line*cols_ + col];
+}
+
+std::string FramebufferRenderer::Line(int line) const {
+  std::string str = "";
+  for (int c=0; c<cols_; c++)
+    str += At(line, c);
+  return str;
+}
+
+void FramebufferRenderer::PushInput(int key) {
+  input_.push_back(key);
+}
+
+void FramebufferRenderer::Set(int line, int col, std::string symbol) {
+  if (line < 0 || line >= lines_ || col < 0 || col >= cols_)
+    return;
+  cells_[line*cols_ + col] = symbol;
+  colors_[line*cols_ + col] = color_;
+}
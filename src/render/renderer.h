@@ -0,0 +1,174 @@
+#ifndef SRC_RENDER_RENDERER_H_
+#define SRC_RENDER_RENDERER_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#define INPUT_END -1  ///< returned by GetCh, if there is no (more) input.
+
+/**
+ * Output (and input) backend for everything drawn by game and field.
+ * Game-logic never talks to curses directly, so the same game can be run in a
+ * terminal, without any output at all or into an in-memory framebuffer.
+ */
+class Renderer {
+  public:
+    virtual ~Renderer() {}
+
+    // getter:
+    virtual int lines() const = 0;
+    virtual int cols() const = 0;
+
+    // methods:
+    /**
+     * Prints string at given position using current color.
+     * @param[in] line
+     * @param[in] col
+     * @param[in] str (might contain utf-8 symbols)
+     */
+    virtual void AddStr(int line, int col, const std::string& str) = 0;
+
+    /**
+     * Prints single character at given position using current color.
+     * @param[in] line
+     * @param[in] col
+     * @param[in] c
+     */
+    virtual void AddCh(int line, int col, char c) = 0;
+
+    /**
+     * Sets color-pair used for all following outputs.
+     * @param[in] color (color-pair, f.e. COLOR_DEFAULT)
+     */
+    virtual void SetColor(int color) = 0;
+
+    virtual void Clear() = 0;
+    virtual void Refresh() = 0;
+
+    /**
+     * Gets next input character (blocking for curses). Game treats INPUT_END
+     * as end of all input: menus are left, a running match is resigned.
+     * @return next input character or INPUT_END if no input is availible.
+     */
+    virtual int GetCh() = 0;
+
+    /**
+     * Shows/ hides typed characters and cursor (used for text input).
+     * @param[in] show
+     */
+    virtual void ShowInput(bool show) = 0;
+};
+
+/**
+ * Renderer printing to terminal using ncurses.
+ * Initializes curses on construction and ends curses-mode on destruction.
+ */
+class CursesRenderer : public Renderer {
+  public:
+    CursesRenderer();
+    ~CursesRenderer();
+
+    // getter:
+    int lines() const;
+    int cols() const;
+
+    // methods:
+    void AddStr(int line, int col, const std::string& str);
+    void AddCh(int line, int col, char c);
+    void SetColor(int color);
+    void Clear();
+    void Refresh();
+    int GetCh();
+    void ShowInput(bool show);
+};
+
+/**
+ * Renderer discarding all output (headless runs). Has no input, so a game
+ * driven by it ends right away.
+ */
+class NullRenderer : public Renderer {
+  public:
+    NullRenderer(int lines, int cols) : lines_(lines), cols_(cols) {}
+
+    // getter:
+    int lines() const { return lines_; }
+    int cols() const { return cols_; }
+
+    // methods:
+    void AddStr(int, int, const std::string&) {}
+    void AddCh(int, int, char) {}
+    void SetColor(int) {}
+    void Clear() {}
+    void Refresh() {}
+    int GetCh() { return INPUT_END; }
+    void ShowInput(bool) {}
+
+  private:
+    const int lines_;
+    const int cols_;
+};
+
+/**
+ * Renderer writing into an in-memory framebuffer. Each cell holds one
+ * (utf-8) symbol and the color it was printed with. Input is taken from a
+ * queue of keys, which can be filled in advance.
+ */
+class FramebufferRenderer : public Renderer {
+  public:
+    FramebufferRenderer(int lines, int cols);
+
+    // getter:
+    int lines() const;
+    int cols() const;
+
+    // methods:
+    void AddStr(int line, int col, const std::string& str);
+    void AddCh(int line, int col, char c);
+    void SetColor(int color);
+    void Clear();
+    void Refresh() {}
+    int GetCh();
+    void ShowInput(bool) {}
+
+    /**
+     * Gets symbol at given cell ("" if outside of framebuffer).
+     * @param[in] line
+     * @param[in] col
+     * @return symbol at given cell.
+     */
+    std::string At(int line, int col) const;
+
+    /**
+     * Gets color at given cell (-1 if outside of framebuffer).
+     * @param[in] line
+     * @param[in] col
+     * @return color at given cell.
+     */
+    int ColorAt(int line, int col) const;
+
+    /**
+     * Gets complete line as string.
+     * @param[in] line
+     * @return complete line.
+     */
+    std::string Line(int line) const;
+
+    /**
+     * Adds key to input-queue.
+     * @param[in] key
+     */
+    void PushInput(int key);
+
+  private:
+    const int lines_;
+    const int cols_;
+    int color_;
+    std::vector<std::string> cells_;
+    std::vector<int> colors_;
+    std::deque<int> input_;
+
+    void Set(int line, int col, std::string symbol);
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "utils/flow_field.h"
+
+#define COST_STRAIGHT 10
+#define COST_DIAGONAL 14
+
+FlowField::FlowField(const Graph* graph) : graph_(graph),
+  dist_(graph->lines()*graph->cols(), FLOW_FIELD_UNREACHABLE) {}
+
+const std::vector<position_t>& FlowField::sources() const {
+  return sources_;
+}
+
+void FlowField::AddSource(position_t pos) {
+  if (!graph_->InGraph(pos) || std::find(sources_.begin(), sources_.end(), pos) != sources_.end())
+    return;
+  sources_.push_back(pos);
+  dist_[graph_->Index(pos)] = 0;
+  Propagate({graph_->Index(pos)});
+}
+
+void FlowField::RemoveSource(position_t pos) {
+  auto it = std::find(sources_.begin(), sources_.end(), pos);
+  if (it == sources_.end())
+    return;
+  sources_.erase(it);
+  std::fill(dist_.begin(), dist_.end(), FLOW_FIELD_UNREACHABLE);
+  std::vector<uint32_t> start;
+  for (const auto& source : sources_) {
+    dist_[graph_->Index(source)] = 0;
+    start.push_back(graph_->Index(source));
+  }
+  Propagate(start);
+}
+
+uint32_t FlowField::Distance(position_t pos) const {
+  if (!graph_->InGraph(pos))
+    return FLOW_FIELD_UNREACHABLE;
+  return dist_[graph_->Index(pos)];
+}
+
+position_t FlowField::NextStep(position_t pos) const {
+  uint32_t dist = Distance(pos);
+  if (dist == 0 || dist == FLOW_FIELD_UNREACHABLE)
+    return pos;
+  // Take neighbor on shortest way (first one found, if several).
+  uint32_t index = graph_->Index(pos);
+  uint32_t next = index;
+  graph_->ForEachNeighbor(index, [&](uint32_t neighbor) {
+      bool diagonal = neighbor%graph_->cols() != index%graph_->cols() && neighbor/graph_->cols() != index/graph_->cols();
+      if (next == index && dist_[neighbor] != FLOW_FIELD_UNREACHABLE
+          && dist_[neighbor] + ((diagonal) ? COST_DIAGONAL : COST_STRAIGHT) == dist)
+        next = neighbor;
+    });
+  return graph_->Position(next);
+}
+
+void FlowField::Propagate(const std::vector<uint32_t>& start) {
+  auto heap_cmp = std::greater<std::pair<uint32_t, uint32_t>>();
+  std::vector<std::pair<uint32_t, uint32_t>> heap;  // min-heap of (distance, index)
+  for (const auto& index : start)
+    heap.push_back({dist_[index], index});
+  std::make_heap(heap.begin(), heap.end(), heap_cmp);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), heap_cmp);
+    auto [dist, index] = heap.back();
+    heap.pop_back();
+    if (dist > dist_[index])
+      continue;
+    graph_->ForEachNeighbor(index, [&](uint32_t neighbor) {
+        bool diagonal = neighbor%graph_->cols() != index%graph_->cols() && neighbor/graph_->cols() != index/graph_->cols();
+        uint32_t new_dist = dist + ((diagonal) ? COST_DIAGONAL : COST_STRAIGHT);
+        if (new_dist < dist_[neighbor]) {
+          dist_[neighbor] = new_dist;
+          heap.push_back({new_dist, neighbor});
+          std::push_heap(heap.begin(), heap.end(), heap_cmp);
+        }
+      });
+  }
+}
@@ -0,0 +1,68 @@
+#ifndef SRC_UTILS_FLOW_FIELD_H_
+#define SRC_UTILS_FLOW_FIELD_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "utils/graph.h"
+
+#define FLOW_FIELD_UNREACHABLE UINT32_MAX
+
+/**
+ * Distance-field towards a set of sources (targets) on a grid-graph: stores
+ * octile distance (straight 10, diagonal 14) of every node to its closest
+ * source, so the next step towards the target can be read from any position
+ * in constant time.
+ */
+class FlowField {
+  public:
+    /**
+     * Constructor creating field without sources (all nodes unreachable).
+     * @param[in] graph (not owned, must outlive flow-field).
+     */
+    FlowField(const Graph* graph);
+
+    // getter:
+    const std::vector<position_t>& sources() const;
+
+    /**
+     * Adds source, only updating nodes which are closer to the new source
+     * than to all existing sources.
+     * @param[in] pos
+     */
+    void AddSource(position_t pos);
+
+    /**
+     * Removes source and recalculates distances from remaining sources.
+     * @param[in] pos
+     */
+    void RemoveSource(position_t pos);
+
+    /**
+     * Gets distance to closest source.
+     * @param[in] pos
+     * @return distance or FLOW_FIELD_UNREACHABLE.
+     */
+    uint32_t Distance(position_t pos) const;
+
+    /**
+     * Gets next position on shortest way to closest source.
+     * @param[in] pos
+     * @return next position or pos itself, if pos is a source or unreachable.
+     */
+    position_t NextStep(position_t pos) const;
+
+  private:
+    const Graph* graph_;
+    std::vector<position_t> sources_;
+    std::vector<uint32_t> dist_;
+
+    /**
+     * Dijkstra from given (already updated) nodes.
+     * @param[in] start indices of nodes to start from.
+     */
+    void Propagate(const std::vector<uint32_t>& start);
+};
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef SRC_UTILS_GEOMETRY_H_
+#define SRC_UTILS_GEOMETRY_H_
+
+#include <array>
+#include <utility>
+
+/**
+ * Integer geometry on the field-grid.
+ * Range queries iterate precomputed (constexpr) disc-stencils and compare
+ * squared distances, so neither sqrt nor any allocation is needed.
+ */
+namespace geometry {
+  typedef std::pair<int, int> position_t;
+
+  #define MAX_STENCIL_REACH 16
+
+  /**
+   * Offset relative to a center position, with its squared distance.
+   */
+  struct Offset {
+    signed char line_;
+    signed char col_;
+    short dist_sq_;
+  };
+
+  /**
+   * Squared euclidean distance between two positions.
+   * @param[in] pos1
+   * @param[in] pos2
+   * @return squared euclidean distance.
+   */
+  constexpr int DistSq(position_t pos1, position_t pos2) {
+    return (pos2.first-pos1.first)*(pos2.first-pos1.first) + (pos2.second-pos1.second)*(pos2.second-pos1.second);
+  }
+
+  /**
+   * Checks whether squared distance lies in [min_dist, max_dist].
+   * @param[in] dist_sq squared distance.
+   * @param[in] min_dist
+   * @param[in] max_dist
+   * @return whether distance is in range.
+   */
+  constexpr bool DistSqInRange(int dist_sq, double min_dist, double max_dist) {
+    return dist_sq >= min_dist*min_dist && dist_sq <= max_dist*max_dist && max_dist >= 0;
+  }
+
+  /**
+   * Checks whether euclidean distance between given positions lies in [min_dist, max_dist].
+   * @param[in] pos1
+   * @param[in] pos2
+   * @param[in] min_dist
+   * @param[in] max_dist
+   * @return whether distance is in range.
+   */
+  constexpr bool InRange(position_t pos1, position_t pos2, double min_dist, double max_dist) {
+    return DistSqInRange(DistSq(pos1, pos2), (min_dist < 0) ? 0 : min_dist, max_dist);
+  }
+
+  /**
+   * Number of offsets in stencil of given reach: all offsets in
+   * [-reach, reach]^2 closer than reach+1 (thus covering every max-distance in
+   * [reach, reach+1)).
+   */
+  constexpr int StencilSize(int reach) {
+    int size = 0;
+    for (int l=-reach; l<=reach; l++)
+      for (int c=-reach; c<=reach; c++)
+        if (l*l + c*c < (reach+1)*(reach+1))
+          size++;
+    return size;
+  }
+
+  constexpr int AllStencilsSize() {
+    int size = 0;
+    for (int reach=0; reach<=MAX_STENCIL_REACH; reach++)
+      size += StencilSize(reach);
+    return size;
+  }
+
+  /**
+   * Stencils for all reaches 0..MAX_STENCIL_REACH, stored consecutively.
+   * Offsets of each stencil are sorted row by row (same order as scanning the
+   * surrounding square).
+   */
+  struct Stencils {
+    std::array<Offset, AllStencilsSize()> offsets_;
+    std::array<int, MAX_STENCIL_REACH+2> begin_;
+  };
+
+  constexpr Stencils MakeStencils() {
+    Stencils stencils {};
+    int i = 0;
+    for (int reach=0; reach<=MAX_STENCIL_REACH; reach++) {
+      stencils.begin_[reach] = i;
+      for (int l=-reach; l<=reach; l++) {
+        for (int c=-reach; c<=reach; c++) {
+          if (l*l + c*c < (reach+1)*(reach+1))
+            stencils.offsets_[i++] = {static_cast<signed char>(l), static_cast<signed char>(c),
+              static_cast<short>(l*l + c*c)};
+        }
+      }
+    }
+    stencils.begin_[MAX_STENCIL_REACH+1] = i;
+    return stencils;
+  }
+
+  inline constexpr Stencils STENCILS = MakeStencils();
+
+  /**
+   * Calls given function for all positions with min_dist <= distance <= max_dist
+   * to center (in row-major order). Positions are not checked to be inside the
+   * field.
+   * @param[in] center
+   * @param[in] max_dist
+   * @param[in] min_dist
+   * @param[in] func called with each position in range.
+   */
+  template<typename Func>
+  void ForEachInRange(position_t center, double max_dist, double min_dist, Func func) {
+    if (max_dist < 0)
+      return;
+    if (min_dist < 0)
+      min_dist = 0;
+    int reach = static_cast<int>(max_dist);
+    if (reach <= MAX_STENCIL_REACH) {
+      for (int i=STENCILS.begin_[reach]; i<STENCILS.begin_[reach+1]; i++) {
+        const Offset& offset = STENCILS.offsets_[i];
+        if (DistSqInRange(offset.dist_sq_, min_dist, max_dist))
+          func(position_t{center.first+offset.line_, center.second+offset.col_});
+      }
+      return;
+    }
+    // Fallback for big ranges: scan surrounding square.
+    for (int l=-reach; l<=reach; l++)
+      for (int c=-reach; c<=reach; c++)
+        if (DistSqInRange(l*l + c*c, min_dist, max_dist))
+          func(position_t{center.first+l, center.second+c});
+  }
+}
+
+#endif
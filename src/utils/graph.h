@@ -2,116 +2,106 @@
 #define SRC_GRAPH_H_
 
 #include <algorithm>
-#include <curses.h>
-#include <iostream>
+#include <cstdint>
 #include <utility>
-#include <list>
-#include <map>
-
-struct Node {
-  int line_;
-  int col_;
-  std::list<Node*> nodes_;
-};
+#include <vector>
 
 typedef std::pair<int, int> position_t;
 
+/**
+ * Grid-graph: nodes are the passable cells of a lines x cols grid, stored as
+ * one bit per cell. Each node is connected to its (up to) eight passable
+ * neighbors; edges are implicit. Nodes are addressed by dense indices
+ * (line*cols + col).
+ */
 class Graph {
   public:
-    Graph() { }
+    Graph(int lines, int cols) : lines_(lines), cols_(cols), passable_((lines*cols+63)/64, 0) { }
 
     // getter:
-    const std::map<position_t, Node*>& nodes() const {
-      return nodes_; 
+    int lines() const { return lines_; }
+    int cols() const { return cols_; }
+
+    /**
+     * Gets number of nodes.
+     * @return number of nodes.
+     */
+    size_t size() const {
+      size_t size = 0;
+      for (const auto& block : passable_)
+        size += __builtin_popcountll(block);
+      return size;
     }
 
     void AddNode(int line, int col) {
-      position_t pos = {line, col};
-      nodes_[pos] = new Node({line, col, {}});
+      uint32_t index = Index({line, col});
+      passable_[index/64] |= uint64_t(1) << (index%64);
     };
 
-    void AddEdge(Node* a, Node* b) {
-      a->nodes_.push_back(b);
+    bool InGraph(position_t pos) const {
+      if (pos.first < 0 || pos.first >= lines_ || pos.second < 0 || pos.second >= cols_)
+        return false;
+      return InGraph(Index(pos));
     }
 
-    bool InGraph(position_t pos) const {
-      return nodes_.count(pos) > 0;
+    uint32_t Index(position_t pos) const {
+      return pos.first*cols_ + pos.second;
     }
 
-    int RemoveInvalid(position_t pos_a) {
-      // Initialize all nodes as not-vistited.
-      std::map<position_t, bool> visited; 
-      for (auto node : nodes_) {
-        position_t pos = {node.second->line_, node.second->col_};
-        visited[pos] = false;
-      }
-      // Get all nodes which can be visited from player-den.
-      std::list<Node*> queue;
-      visited[pos_a] = true;
-      queue.push_back(nodes_[pos_a]);
-      while(!queue.empty()) {
-        auto cur = queue.front();
-        queue.pop_front();
-        for (auto node : cur->nodes_) {
-          position_t pos = {node->line_, node->col_};
-          if (!visited[pos]) {
-            visited[pos] = true;
-            queue.push_back(node);
-          }
-        }
-      }
-      // erase all nodes not visited
-      int removed_nodes = 0;
-      for (auto it : visited) {
-        if (!it.second) {
-          delete nodes_[it.first];
-          nodes_.erase(it.first);
-          removed_nodes++;
-        }
-      }
-      return removed_nodes;
+    position_t Position(uint32_t index) const {
+      return {static_cast<int>(index/cols_), static_cast<int>(index%cols_)};
     }
 
-    std::list<position_t> find_way(position_t pos_a, position_t pos_b) const {
-      std::map<position_t, position_t> visited; 
-      for (auto node : nodes_) {
-        position_t pos = {node.second->line_, node.second->col_};
-        visited[pos] = {-1, -1};
+    /**
+     * Calls given function with index of each neighbor of given node (row by row).
+     * @param[in] index of node.
+     * @param[in] func called with each neighbor-index.
+     */
+    template<typename Func>
+    void ForEachNeighbor(uint32_t index, Func func) const {
+      int line = index/cols_;
+      int col = index%cols_;
+      for (int l=std::max(line-1, 0); l<=std::min(line+1, lines_-1); l++) {
+        for (int c=std::max(col-1, 0); c<=std::min(col+1, cols_-1); c++) {
+          uint32_t neighbor = l*cols_ + c;
+          if (neighbor != index && InGraph(neighbor))
+            func(neighbor);
+        }
       }
+    }
 
-      // Get all nodes which can be visited from player-den.
-      std::list<Node*> queue;
-      visited[pos_a] = {pos_a.first, pos_a.second};
-      queue.push_back(nodes_.at(pos_a));
-      while(!queue.empty()) {
-        auto cur = queue.front();
-        queue.pop_front();
-        // Check if desired node was found.
-        if (pos_b.first == cur->line_ && pos_b.second == cur->col_)
-          break;
-        // iterate over children.
-        for (auto node : cur->nodes_) {
-          position_t pos = {node->line_, node->col_};
-          if (visited[pos] == std::make_pair(-1, -1)) {
-            visited[pos] = {cur->line_, cur->col_};
-            queue.push_back(node);
-          }
+    /**
+     * Removes all nodes not reachable from given position.
+     * @param[in] pos_a
+     * @return number of removed nodes.
+     */
+    int RemoveInvalid(position_t pos_a) {
+      size_t size_before = size();
+      std::vector<uint64_t> visited(passable_.size(), 0);
+      if (InGraph(pos_a)) {
+        std::vector<uint32_t> queue = {Index(pos_a)};
+        visited[queue[0]/64] |= uint64_t(1) << (queue[0]%64);
+        for (size_t i=0; i<queue.size(); i++) {
+          ForEachNeighbor(queue[i], [&](uint32_t neighbor) {
+              if (!(visited[neighbor/64] & (uint64_t(1) << (neighbor%64)))) {
+                visited[neighbor/64] |= uint64_t(1) << (neighbor%64);
+                queue.push_back(neighbor);
+              }
+            });
         }
       }
-      if (visited[pos_b] == std::make_pair(-1, -1))
-        throw "Could not find enemy den!.";
-      
-      std::list<position_t> way = { pos_b };
-      while (way.back() != pos_a) {
-        way.push_back({visited[way.back()].first, visited[way.back()].second});
-      }
-      //Reverse path and return.
-      std::reverse(std::begin(way), std::end(way));
-      return way;
+      passable_ = visited;
+      return size_before - size();
     }
 
   private:
-    std::map<position_t, Node*> nodes_;
+    int lines_;
+    int cols_;
+    std::vector<uint64_t> passable_;  ///< one bit per cell.
+
+    bool InGraph(uint32_t index) const {
+      return passable_[index/64] & (uint64_t(1) << (index%64));
+    }
 };
 
 #endif
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "utils/flow_field.h"
+#include "utils/hierarchical_pathfinder.h"
+
+#define COST_STRAIGHT 10
+#define COST_DIAGONAL 14
+#define NO_PORTAL UINT32_MAX
+
+namespace {
+  uint32_t Octile(position_t a, position_t b) {
+    int dl = std::abs(a.first - b.first);
+    int dc = std::abs(a.second - b.second);
+    return COST_STRAIGHT*std::max(dl, dc) + (COST_DIAGONAL-COST_STRAIGHT)*std::min(dl, dc);
+  }
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(const Graph* graph, std::vector<int> line_borders, 
+    std::vector<int> col_borders) : graph_(graph), pathfinder_(graph), line_borders_(line_borders), 
+  col_borders_(col_borders) {
+  // Get line/ column of clusters for each line/ column.
+  for (int l=0; l<graph_->lines(); l++)
+    cluster_line_.push_back(std::upper_bound(line_borders_.begin(), line_borders_.end(), l) - line_borders_.begin() - 1);
+  for (int c=0; c<graph_->cols(); c++)
+    cluster_col_.push_back(std::upper_bound(col_borders_.begin(), col_borders_.end(), c) - col_borders_.begin() - 1);
+
+  // Create clusters.
+  for (size_t i=0; i<line_borders_.size(); i++) {
+    int lines = ((i+1 < line_borders_.size()) ? line_borders_[i+1] : graph_->lines()) - line_borders_[i];
+    for (size_t j=0; j<col_borders_.size(); j++) {
+      int cols = ((j+1 < col_borders_.size()) ? col_borders_[j+1] : graph_->cols()) - col_borders_[j];
+      ClusterArea cluster = {line_borders_[i], col_borders_[j], Graph(lines, cols), {}};
+      for (int l=0; l<lines; l++)
+        for (int c=0; c<cols; c++)
+          if (graph_->InGraph({cluster.first_line_+l, cluster.first_col_+c}))
+            cluster.graph_.AddNode(l, c);
+      clusters_.push_back(cluster);
+    }
+  }
+
+  // Add portals on vertical and horizontal borders between clusters.
+  for (const auto& cluster : clusters_) {
+    if (cluster.first_col_ > 0) {
+      std::vector<position_t> side_a, side_b;
+      for (int l=cluster.first_line_; l<cluster.first_line_+cluster.graph_.lines(); l++) {
+        side_a.push_back({l, cluster.first_col_-1});
+        side_b.push_back({l, cluster.first_col_});
+      }
+      AddPortals(side_a, side_b);
+    }
+    if (cluster.first_line_ > 0) {
+      std::vector<position_t> side_a, side_b;
+      for (int c=cluster.first_col_; c<cluster.first_col_+cluster.graph_.cols(); c++) {
+        side_a.push_back({cluster.first_line_-1, c});
+        side_b.push_back({cluster.first_line_, c});
+      }
+      AddPortals(side_a, side_b);
+    }
+  }
+
+  // Add edges between portals of the same cluster (one Dijkstra per portal).
+  for (size_t i=0; i<clusters_.size(); i++) {
+    for (const auto& portal : clusters_[i].portals_) {
+      for (const auto& [to, cost] : CostsToPortals(i, portals_[portal]))
+        if (to != portal)
+          edges_[portal].push_back({to, cost, static_cast<int>(i)});
+    }
+  }
+}
+
+std::vector<int> HierarchicalPathfinder::Borders(int size, int sections, int max_size) {
+  std::vector<int> borders;
+  for (int i=0; i<sections; i++) {
+    int begin = i*(size/sections);
+    int end = (i == sections-1) ? size : (i+1)*(size/sections);
+    int parts = std::max((end - begin + max_size - 1)/std::max(max_size, 1), 1);
+    for (int j=0; j<parts; j++) {
+      int border = begin + j*(end-begin)/parts;
+      if (borders.size() == 0 || border > borders.back())
+        borders.push_back(border);
+    }
+  }
+  if (borders.size() == 0 || borders.front() != 0)
+    borders.insert(borders.begin(), 0);
+  return borders;
+}
+
+size_t HierarchicalPathfinder::num_clusters() const {
+  return clusters_.size();
+}
+
+size_t HierarchicalPathfinder::num_portals() const {
+  return portals_.size();
+}
+
+int HierarchicalPathfinder::Cluster(position_t pos) const {
+  return cluster_line_[pos.first]*col_borders_.size() + cluster_col_[pos.second];
+}
+
+std::vector<position_t> HierarchicalPathfinder::FindWay(position_t start, position_t target) {
+  if (!graph_->InGraph(start) || !graph_->InGraph(target))
+    throw std::logic_error("Could not find way: start or target not in graph.");
+  int start_cluster = Cluster(start);
+  int target_cluster = Cluster(target);
+  if (start_cluster == target_cluster)
+    return pathfinder_.FindWay(start, target);
+
+  // Connect target to portals of its cluster.
+  std::map<uint32_t, uint32_t> target_costs;
+  for (const auto& [portal, cost] : CostsToPortals(target_cluster, target))
+    target_costs[portal] = cost;
+
+  // A* on portals (index portals_.size() is the target), starting at all
+  // portals reachable from start.
+  const uint32_t target_node = portals_.size();
+  std::vector<uint32_t> dist(portals_.size()+1, UINT32_MAX);
+  std::vector<uint32_t> prev(portals_.size()+1, NO_PORTAL);
+  std::vector<bool> closed(portals_.size()+1, false);
+  auto heap_cmp = std::greater<std::pair<uint32_t, uint32_t>>();
+  std::vector<std::pair<uint32_t, uint32_t>> heap;  // (estimated total cost, node)
+  for (const auto& [portal, cost] : CostsToPortals(start_cluster, start)) {
+    dist[portal] = cost;
+    heap.push_back({cost + Octile(portals_[portal], target), portal});
+  }
+  std::make_heap(heap.begin(), heap.end(), heap_cmp);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), heap_cmp);
+    uint32_t node = heap.back().second;
+    heap.pop_back();
+    if (node == target_node)
+      break;
+    if (closed[node])
+      continue;
+    closed[node] = true;
+    uint32_t d = dist[node];
+    auto relax = [&](uint32_t to, uint32_t cost) {
+      if (d + cost < dist[to]) {
+        dist[to] = d + cost;
+        prev[to] = node;
+        heap.push_back({dist[to] + ((to == target_node) ? 0 : Octile(portals_[to], target)), to});
+        std::push_heap(heap.begin(), heap.end(), heap_cmp);
+      }
+    };
+    for (const auto& edge : edges_[node])
+      relax(edge.to_, edge.cost_);
+    if (target_costs.count(node) > 0)
+      relax(target_node, target_costs.at(node));
+  }
+  if (dist[target_node] == UINT32_MAX)
+    return pathfinder_.FindWay(start, target);
+
+  // Get portals on way and refine.
+  std::vector<uint32_t> abstract_way;
+  for (uint32_t node = prev[target_node]; node != NO_PORTAL; node = prev[node])
+    abstract_way.push_back(node);
+  std::reverse(abstract_way.begin(), abstract_way.end());
+  std::vector<position_t> way = LocalWay(start_cluster, start, portals_[abstract_way.front()]);
+  for (size_t i=1; i<abstract_way.size(); i++) {
+    uint32_t from = abstract_way[i-1];
+    uint32_t to = abstract_way[i];
+    // Get cheapest edge between both portals (they might share several clusters).
+    const Edge* best = nullptr;
+    for (const auto& edge : edges_[from])
+      if (edge.to_ == to && (!best || edge.cost_ < best->cost_))
+        best = &edge;
+    if (best->cluster_ == -1) {
+      way.push_back(portals_[to]);
+    }
+    else {
+      auto part = RefinedWay(from, to, best->cluster_);
+      way.insert(way.end(), part.begin()+1, part.end());
+    }
+  }
+  auto last_part = LocalWay(target_cluster, portals_[abstract_way.back()], target);
+  way.insert(way.end(), last_part.begin()+1, last_part.end());
+  return way;
+}
+
+uint32_t HierarchicalPathfinder::AddPortal(position_t pos) {
+  if (portal_index_.count(pos) > 0)
+    return portal_index_.at(pos);
+  uint32_t index = portals_.size();
+  portals_.push_back(pos);
+  portal_index_[pos] = index;
+  edges_.push_back({});
+  clusters_[Cluster(pos)].portals_.push_back(index);
+  return index;
+}
+
+void HierarchicalPathfinder::AddPortals(const std::vector<position_t>& side_a,
+    const std::vector<position_t>& side_b) {
+  size_t i = 0;
+  while (i < side_a.size()) {
+    if (!graph_->InGraph(side_a[i]) || !graph_->InGraph(side_b[i])) {
+      i++;
+      continue;
+    }
+    size_t begin = i;
+    while (i < side_a.size() && graph_->InGraph(side_a[i]) && graph_->InGraph(side_b[i]))
+      i++;
+    size_t middle = (begin + i - 1)/2;
+    uint32_t a = AddPortal(side_a[middle]);
+    uint32_t b = AddPortal(side_b[middle]);
+    edges_[a].push_back({b, COST_STRAIGHT, -1});
+    edges_[b].push_back({a, COST_STRAIGHT, -1});
+  }
+}
+
+std::vector<position_t> HierarchicalPathfinder::LocalWay(int cluster, position_t start, position_t target) const {
+  const auto& area = clusters_[cluster];
+  Pathfinder pathfinder(&area.graph_);
+  auto way = pathfinder.FindWay({start.first-area.first_line_, start.second-area.first_col_},
+      {target.first-area.first_line_, target.second-area.first_col_});
+  for (auto& pos : way)
+    pos = {pos.first+area.first_line_, pos.second+area.first_col_};
+  return way;
+}
+
+std::vector<position_t> HierarchicalPathfinder::RefinedWay(uint32_t from, uint32_t to, int cluster) {
+  std::unique_lock ul(mutex_refined_);
+  if (refined_.count({from, to}) > 0)
+    return refined_.at({from, to});
+  ul.unlock();
+  auto way = LocalWay(cluster, portals_[from], portals_[to]);
+  ul.lock();
+  refined_[{from, to}] = way;
+  return way;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> HierarchicalPathfinder::CostsToPortals(int cluster, 
+    position_t pos) const {
+  const auto& area = clusters_[cluster];
+  FlowField distances(&area.graph_);
+  distances.AddSource({pos.first-area.first_line_, pos.second-area.first_col_});
+  std::vector<std::pair<uint32_t, uint32_t>> costs;
+  for (const auto& portal : area.portals_) {
+    uint32_t cost = distances.Distance({portals_[portal].first-area.first_line_, 
+        portals_[portal].second-area.first_col_});
+    if (cost != FLOW_FIELD_UNREACHABLE)
+      costs.push_back({portal, cost});
+  }
+  return costs;
+}
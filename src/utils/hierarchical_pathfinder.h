@@ -0,0 +1,130 @@
+#ifndef SRC_UTILS_HIERARCHICAL_PATHFINDER_H_
+#define SRC_UTILS_HIERARCHICAL_PATHFINDER_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "utils/graph.h"
+#include "utils/pathfinder.h"
+
+/**
+ * Hierarchical pathfinder (HPA*): the grid is split into rectangular clusters
+ * (f.e. the eight sections of the field, each split further into smaller
+ * clusters). Portals are placed in the middle of each passable stretch of the
+ * border between two neighboring clusters, and the costs of ways between
+ * portals of the same cluster are precalculated.
+ * Queries between different clusters search the graph of portals and then
+ * refine it into a way of neighboring positions; ways between portals are
+ * calculated on first use and cached.
+ * Ways are near-optimal. If start and target are in the same cluster, or the
+ * portal graph does not connect them, the way is searched on the full grid.
+ */
+class HierarchicalPathfinder {
+  public:
+    /**
+     * Constructor precalculating portals and costs between portals.
+     * @param[in] graph (not owned, must outlive pathfinder).
+     * @param[in] line_borders first line of each line of clusters (ascending, starting with 0).
+     * @param[in] col_borders first column of each column of clusters (ascending, starting with 0).
+     */
+    HierarchicalPathfinder(const Graph* graph, std::vector<int> line_borders, std::vector<int> col_borders);
+
+    /**
+     * Splits [0, size) into equally sized sections, then splits each section
+     * into parts of at most max_size.
+     * @param[in] size
+     * @param[in] sections
+     * @param[in] max_size
+     * @return first index of each part.
+     */
+    static std::vector<int> Borders(int size, int sections, int max_size);
+
+    // getter:
+    size_t num_clusters() const;
+    size_t num_portals() const;
+
+    /**
+     * Gets cluster of position.
+     * @param[in] pos
+     * @return index of cluster (line by line).
+     */
+    int Cluster(position_t pos) const;
+
+    /**
+     * Finds way between two positions.
+     * @param[in] start
+     * @param[in] target
+     * @return way including start and target (each step to a neighbor).
+     * @throws std::logic_error if no way exists.
+     */
+    std::vector<position_t> FindWay(position_t start, position_t target);
+
+  private:
+    struct ClusterArea {
+      int first_line_;
+      int first_col_;
+      Graph graph_;  ///< passable positions of cluster (local coordinates).
+      std::vector<uint32_t> portals_;
+    };
+
+    struct Edge {
+      uint32_t to_;
+      uint32_t cost_;
+      int cluster_;  ///< cluster of way between portals, -1 for step across border.
+    };
+
+    const Graph* graph_;
+    Pathfinder pathfinder_;
+    std::vector<int> line_borders_;
+    std::vector<int> col_borders_;
+    std::vector<int> cluster_line_;  ///< line of clusters for each line.
+    std::vector<int> cluster_col_;  ///< column of clusters for each column.
+    std::vector<ClusterArea> clusters_;
+    std::vector<position_t> portals_;
+    std::map<position_t, uint32_t> portal_index_;
+    std::vector<std::vector<Edge>> edges_;
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<position_t>> refined_;
+    std::mutex mutex_refined_;
+
+    /**
+     * Adds portal (if not existing) and returns its index.
+     */
+    uint32_t AddPortal(position_t pos);
+
+    /**
+     * Adds portals in the middle of every passable stretch between two
+     * neighboring clusters.
+     * @param[in] side_a positions on one side of the border.
+     * @param[in] side_b neighboring positions on other side of the border.
+     */
+    void AddPortals(const std::vector<position_t>& side_a, const std::vector<position_t>& side_b);
+
+    /**
+     * Gets costs of ways inside cluster from given position to all portals
+     * of the cluster.
+     * @param[in] cluster
+     * @param[in] pos
+     * @return (portal, cost) for all reachable portals.
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> CostsToPortals(int cluster, position_t pos) const;
+
+    /**
+     * Finds way inside one cluster.
+     * @param[in] cluster
+     * @param[in] start
+     * @param[in] target
+     * @return way (in global coordinates).
+     * @throws std::logic_error if no way inside cluster exists.
+     */
+    std::vector<position_t> LocalWay(int cluster, position_t start, position_t target) const;
+
+    /**
+     * Gets (cached) way between two portals of the same cluster.
+     */
+    std::vector<position_t> RefinedWay(uint32_t from, uint32_t to, int cluster);
+};
+
+#endif
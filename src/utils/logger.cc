@@ -0,0 +1,87 @@
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+
+#include "utils/logger.h"
+
+namespace {
+  const std::array<std::string, NUM_LOG_CATEGORIES> category_names = {
+    "game", "field", "player", "ki", "audio", "simulation"
+  };
+
+  /**
+   * Gets category by name.
+   * @param[in] name
+   * @return category or -1 if name is not a category.
+   */
+  int Category(const std::string& name) {
+    for (int i=0; i<NUM_LOG_CATEGORIES; i++)
+      if (category_names[i] == name)
+        return i;
+    return -1;
+  }
+
+  /**
+   * Gets level by name.
+   * @param[in] name
+   * @param[out] level
+   * @return whether name is a level.
+   */
+  bool Level(const std::string& name, spdlog::level::level_enum& level) {
+    level = spdlog::level::from_str(name);
+    // from_str returns off for unknown names.
+    return level != spdlog::level::off || name == "off";
+  }
+}
+
+void utils::InitLogging(const std::string& path, spdlog::level::level_enum level, bool async) {
+  auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path);
+  if (async) {
+    spdlog::init_thread_pool(8192, 1);
+    // Flush queued messages on exit.
+    std::atexit([]() { spdlog::shutdown(); });
+  }
+  for (int i=0; i<NUM_LOG_CATEGORIES; i++) {
+    std::shared_ptr<spdlog::logger> logger;
+    if (async) {
+      logger = std::make_shared<spdlog::async_logger>(category_names[i], sink, spdlog::thread_pool(),
+          spdlog::async_overflow_policy::block);
+    }
+    else
+      logger = std::make_shared<spdlog::logger>(category_names[i], sink);
+    logger->set_level(level);
+    logger->flush_on(spdlog::level::warn);
+    spdlog::drop(category_names[i]);
+    spdlog::register_logger(logger);
+    log_handles[i] = logger.get();
+  }
+  // Messages logged without category (spdlog::info etc.) go to log-file too, never to stdout.
+  spdlog::set_default_logger(spdlog::get(category_names[LOG_GAME]));
+}
+
+bool utils::SetLogLevels(const std::string& levels) {
+  bool valid = true;
+  std::stringstream stream(levels);
+  std::string entry;
+  while (std::getline(stream, entry, ',')) {
+    size_t sep = entry.find('=');
+    spdlog::level::level_enum level;
+    if (!Level((sep == std::string::npos) ? entry : entry.substr(sep+1), level)) {
+      valid = false;
+      continue;
+    }
+    if (sep == std::string::npos) {
+      for (auto* logger : log_handles)
+        logger->set_level(level);
+    }
+    else if (int category = Category(entry.substr(0, sep)); category != -1)
+      log_handles[category]->set_level(level);
+    else
+      valid = false;
+  }
+  return valid;
+}
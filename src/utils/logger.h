@@ -0,0 +1,97 @@
+#ifndef SRC_UTILS_LOGGER_H_
+#define SRC_UTILS_LOGGER_H_
+
+#include <array>
+#include <string>
+#include <spdlog/spdlog.h>
+
+/**
+ * Categories of log-messages. Each category is logged by its own logger (with
+ * its own level), all loggers write to the same file.
+ */
+enum LogCategory {
+  LOG_GAME = 0,  ///< game, match, tournament, main and utils.
+  LOG_FIELD,
+  LOG_PLAYER,  ///< player, neurons, potentials and resources.
+  LOG_KI,
+  LOG_AUDIO,
+  LOG_SIMULATION,
+  NUM_LOG_CATEGORIES,
+};
+
+namespace utils {
+
+  /// Loggers by category (set by InitLogging, cached, as spdlog::get locks the logger registry).
+  inline std::array<spdlog::logger*, NUM_LOG_CATEGORIES> log_handles = {};
+
+  /**
+   * Gets logger of given category (InitLogging must be called before first
+   * call).
+   * @param[in] category
+   * @return logger.
+   */
+  inline spdlog::logger* Logger(int category=LOG_GAME) {
+    return log_handles[category];
+  }
+
+  /**
+   * Creates loggers of all categories, writing to given file.
+   * @param[in] path of log-file.
+   * @param[in] level initial level of all categories.
+   * @param[in] async if set, messages are written by a background thread.
+   */
+  void InitLogging(const std::string& path, spdlog::level::level_enum level, bool async);
+
+  /**
+   * Sets levels of categories.
+   * @param[in] levels either a level for all categories (f.e. "warn") or a
+   * comma-separated list of category=level (f.e. "warn,player=debug,ki=info").
+   * Levels: trace, debug, info, warn, error, critical, off. Categories: game,
+   * field, player, ki, audio, simulation.
+   * @return whether all levels were valid (invalid entries are skipped).
+   */
+  bool SetLogLevels(const std::string& levels);
+}
+
+/**
+ * Logs message of given category, if level is enabled. Arguments are only
+ * evaluated (and formatted) if message is logged. Levels below
+ * SPDLOG_ACTIVE_LEVEL (cmake option LOG_LEVEL) are removed at compile time.
+ */
+#define LOG_AT(category, level, ...) do { \
+    spdlog::logger* logger_at_ = utils::Logger(category); \
+    if (logger_at_->should_log(level)) \
+      logger_at_->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__); \
+  } while (0)
+
+/**
+ * Removed log-message: never executed (and removed by the compiler), but
+ * still compiled, so that variables only used for logging stay used.
+ */
+#define LOG_STRIPPED(category, level, ...) do { if (false) LOG_AT(category, level, __VA_ARGS__); } while (0)
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define LOG_DEBUG(category, ...) LOG_AT(category, spdlog::level::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) LOG_STRIPPED(category, spdlog::level::debug, __VA_ARGS__)
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define LOG_INFO(category, ...) LOG_AT(category, spdlog::level::info, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) LOG_STRIPPED(category, spdlog::level::info, __VA_ARGS__)
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define LOG_WARN(category, ...) LOG_AT(category, spdlog::level::warn, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) LOG_STRIPPED(category, spdlog::level::warn, __VA_ARGS__)
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define LOG_ERROR(category, ...) LOG_AT(category, spdlog::level::err, __VA_ARGS__)
+#else
+#define LOG_ERROR(category, ...) LOG_STRIPPED(category, spdlog::level::err, __VA_ARGS__)
+#endif
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef SRC_UTILS_MPSC_QUEUE_H_
+#define SRC_UTILS_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+/**
+ * Lock-free unbounded queue for multiple producers and a single consumer
+ * (linked list with a stub node: producers only swap the head, the consumer
+ * owns the tail). Elements of each producer are popped in the order pushed.
+ * A pop might miss an element whose push has not completed yet; it is
+ * returned by a later pop.
+ */
+template<class T>
+class MpscQueue {
+  public:
+    MpscQueue() : head_(new Node()), tail_(head_.load()) {}
+
+    ~MpscQueue() {
+      while (tail_) {
+        Node* next = tail_->next_.load(std::memory_order_acquire);
+        delete tail_;
+        tail_ = next;
+      }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * Adds element (any thread).
+     * @param[in] value
+     */
+    void Push(T value) {
+      Node* node = new Node(std::move(value));
+      Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+      prev->next_.store(node, std::memory_order_release);
+    }
+
+    /**
+     * Removes oldest element (consumer thread only).
+     * @return element or nothing, if queue is empty.
+     */
+    std::optional<T> Pop() {
+      Node* next = tail_->next_.load(std::memory_order_acquire);
+      if (!next)
+        return std::nullopt;
+      std::optional<T> value = std::move(next->value_);
+      next->value_.reset();
+      // Next becomes the new stub.
+      delete tail_;
+      tail_ = next;
+      return value;
+    }
+
+  private:
+    struct Node {
+      std::atomic<Node*> next_;
+      std::optional<T> value_;  ///< empty for stub.
+
+      Node() : next_(nullptr) {}
+      Node(T value) : next_(nullptr), value_(std::move(value)) {}
+    };
+
+    std::atomic<Node*> head_;  ///< last pushed node (producers).
+    Node* tail_;  ///< stub, followed by oldest element (consumer).
+};
+
+#endif
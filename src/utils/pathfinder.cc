@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "utils/pathfinder.h"
+
+#define COST_STRAIGHT 10
+#define COST_DIAGONAL 14
+
+namespace {
+  /**
+   * Per-thread search state. Entries of g_ and parent_ are only valid if stamp_
+   * matches current generation, thus buffers never need to be cleared.
+   */
+  struct Scratch {
+    std::vector<uint32_t> stamp_;
+    std::vector<uint32_t> closed_;
+    std::vector<uint32_t> g_;
+    std::vector<uint32_t> parent_;
+    std::vector<std::pair<uint32_t, uint32_t>> open_;  ///< min-heap of (f, index)
+    uint32_t generation_ = 0;
+
+    void Reset(size_t size) {
+      if (stamp_.size() < size || generation_ == UINT32_MAX) {
+        stamp_.assign(size, 0);
+        closed_.assign(size, 0);
+        g_.resize(size);
+        parent_.resize(size);
+        generation_ = 0;
+      }
+      generation_++;
+      open_.clear();
+    }
+  };
+
+  thread_local Scratch scratch;
+
+  int Sign(int x) {
+    return (x > 0) - (x < 0);
+  }
+
+  uint32_t Octile(position_t a, position_t b) {
+    int dl = std::abs(a.first - b.first);
+    int dc = std::abs(a.second - b.second);
+    return COST_STRAIGHT*std::max(dl, dc) + (COST_DIAGONAL-COST_STRAIGHT)*std::min(dl, dc);
+  }
+}
+
+Pathfinder::Pathfinder(const Graph* graph) : graph_(graph) {}
+
+std::vector<position_t> Pathfinder::FindWay(position_t start, position_t target) const {
+  if (!graph_->InGraph(start) || !graph_->InGraph(target))
+    throw std::logic_error("Could not find way: start or target not in graph.");
+  if (start == target)
+    return {target};
+
+  Scratch& s = scratch;
+  s.Reset(graph_->lines()*graph_->cols());
+  const uint32_t gen = s.generation_;
+  const uint32_t start_index = graph_->Index(start);
+  const uint32_t target_index = graph_->Index(target);
+  auto heap_cmp = std::greater<std::pair<uint32_t, uint32_t>>();
+
+  s.stamp_[start_index] = gen;
+  s.g_[start_index] = 0;
+  s.parent_[start_index] = start_index;
+  s.open_.push_back({Octile(start, target), start_index});
+
+  bool found = false;
+  while (!s.open_.empty()) {
+    std::pop_heap(s.open_.begin(), s.open_.end(), heap_cmp);
+    uint32_t cur_index = s.open_.back().second;
+    s.open_.pop_back();
+    if (s.closed_[cur_index] == gen)
+      continue;
+    s.closed_[cur_index] = gen;
+    if (cur_index == target_index) {
+      found = true;
+      break;
+    }
+    position_t cur = graph_->Position(cur_index);
+    int l = cur.first;
+    int c = cur.second;
+
+    // Get (pruned) directions to search from current position.
+    int dirs[8][2];
+    int num_dirs = 0;
+    auto add_dir = [&](int dl, int dc) { dirs[num_dirs][0] = dl; dirs[num_dirs][1] = dc; num_dirs++; };
+    if (cur_index == start_index) {
+      for (int dl=-1; dl<=1; dl++)
+        for (int dc=-1; dc<=1; dc++)
+          if (dl != 0 || dc != 0)
+            add_dir(dl, dc);
+    }
+    else {
+      position_t parent = graph_->Position(s.parent_[cur_index]);
+      int dl = Sign(l - parent.first);
+      int dc = Sign(c - parent.second);
+      if (dl != 0 && dc != 0) {
+        add_dir(dl, 0);
+        add_dir(0, dc);
+        add_dir(dl, dc);
+        if (!Passable(l-dl, c))
+          add_dir(-dl, dc);
+        if (!Passable(l, c-dc))
+          add_dir(dl, -dc);
+      }
+      else if (dl != 0) {
+        add_dir(dl, 0);
+        if (!Passable(l, c+1))
+          add_dir(dl, 1);
+        if (!Passable(l, c-1))
+          add_dir(dl, -1);
+      }
+      else {
+        add_dir(0, dc);
+        if (!Passable(l+1, c))
+          add_dir(1, dc);
+        if (!Passable(l-1, c))
+          add_dir(-1, dc);
+      }
+    }
+
+    // Jump into each direction and add found jump points to open list.
+    for (int i=0; i<num_dirs; i++) {
+      position_t jump_point;
+      if (!Jump(l, c, dirs[i][0], dirs[i][1], target, jump_point))
+        continue;
+      uint32_t jump_index = graph_->Index(jump_point);
+      if (s.closed_[jump_index] == gen)
+        continue;
+      uint32_t g = s.g_[cur_index] + Octile(cur, jump_point);
+      if (s.stamp_[jump_index] != gen || g < s.g_[jump_index]) {
+        s.stamp_[jump_index] = gen;
+        s.g_[jump_index] = g;
+        s.parent_[jump_index] = cur_index;
+        s.open_.push_back({g + Octile(jump_point, target), jump_index});
+        std::push_heap(s.open_.begin(), s.open_.end(), heap_cmp);
+      }
+    }
+  }
+  if (!found)
+    throw std::logic_error("Could not find way.");
+
+  // Reconstruct way, filling straight or diagonal segments between jump points.
+  std::vector<position_t> way = {target};
+  for (uint32_t cur_index = target_index; cur_index != start_index; cur_index = s.parent_[cur_index]) {
+    position_t parent = graph_->Position(s.parent_[cur_index]);
+    position_t cur = graph_->Position(cur_index);
+    int dl = Sign(parent.first - cur.first);
+    int dc = Sign(parent.second - cur.second);
+    while (cur != parent) {
+      cur = {cur.first + dl, cur.second + dc};
+      way.push_back(cur);
+    }
+  }
+  std::reverse(way.begin(), way.end());
+  return way;
+}
+
+bool Pathfinder::Passable(int line, int col) const {
+  return graph_->InGraph({line, col});
+}
+
+bool Pathfinder::Jump(int line, int col, int dl, int dc, position_t target, position_t& jump_point) const {
+  while (true) {
+    line += dl;
+    col += dc;
+    if (!Passable(line, col))
+      return false;
+    if (line == target.first && col == target.second) {
+      jump_point = target;
+      return true;
+    }
+    if (dl != 0 && dc != 0) {
+      // Diagonal: check forced neighbors, then straight jumps.
+      if ((!Passable(line-dl, col) && Passable(line-dl, col+dc))
+          || (!Passable(line, col-dc) && Passable(line+dl, col-dc))) {
+        jump_point = {line, col};
+        return true;
+      }
+      position_t unused;
+      if (Jump(line, col, dl, 0, target, unused) || Jump(line, col, 0, dc, target, unused)) {
+        jump_point = {line, col};
+        return true;
+      }
+    }
+    else if (dl != 0) {
+      if ((!Passable(line, col+1) && Passable(line+dl, col+1))
+          || (!Passable(line, col-1) && Passable(line+dl, col-1))) {
+        jump_point = {line, col};
+        return true;
+      }
+    }
+    else {
+      if ((!Passable(line+1, col) && Passable(line+1, col+dc))
+          || (!Passable(line-1, col) && Passable(line-1, col+dc))) {
+        jump_point = {line, col};
+        return true;
+      }
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef SRC_UTILS_PATHFINDER_H_
+#define SRC_UTILS_PATHFINDER_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "utils/graph.h"
+
+/**
+ * Immutable way, shared by all units following it.
+ */
+typedef std::shared_ptr<const std::vector<position_t>> path_t;
+
+/**
+ * Finds shortest ways on a grid-graph using A* with octile heuristic and jump
+ * point search (straight steps cost 10, diagonal steps 14; diagonal steps may
+ * pass blocked corners, as in the graph's 8-neighborhood).
+ * Scratch buffers are thread-local and reset in O(1) by a generation counter,
+ * so queries don't allocate once buffers have grown to the size of the map.
+ */
+class Pathfinder {
+  public:
+    /**
+     * Constructor.
+     * @param[in] graph (not owned, must outlive pathfinder).
+     */
+    Pathfinder(const Graph* graph);
+
+    /**
+     * Finds shortest way between two positions.
+     * @param[in] start
+     * @param[in] target
+     * @return way including start and target (each step to a neighbor).
+     * @throws std::logic_error if no way exists.
+     */
+    std::vector<position_t> FindWay(position_t start, position_t target) const;
+
+  private:
+    const Graph* graph_;
+
+    bool Passable(int line, int col) const;
+
+    /**
+     * Jumps from given position into given direction until a jump point (target,
+     * position with forced neighbors or, for diagonal directions, position from
+     * which a straight jump finds a jump point) is found.
+     * @param[in] line
+     * @param[in] col
+     * @param[in] dl line-direction (-1, 0, 1)
+     * @param[in] dc column-direction (-1, 0, 1)
+     * @param[in] target
+     * @param[out] jump_point found jump point.
+     * @return whether a jump point was found.
+     */
+    bool Jump(int line, int col, int dl, int dc, position_t target, position_t& jump_point) const;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef SRC_UTILS_SLOT_MAP_H_
+#define SRC_UTILS_SLOT_MAP_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Handle to an element of a slot-map. A handle stays valid until its element
+ * is erased; handles of erased elements are detected by their generation.
+ * A default constructed handle is invalid.
+ */
+struct SlotHandle {
+  uint32_t index_;
+  uint32_t generation_;
+
+  SlotHandle() : index_(UINT32_MAX), generation_(0) {}
+  SlotHandle(uint32_t index, uint32_t generation) : index_(index), generation_(generation) {}
+
+  bool valid() const { return generation_ != 0; }
+  bool operator==(const SlotHandle& other) const {
+    return index_ == other.index_ && generation_ == other.generation_;
+  }
+  bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * Slot-map with generational handles: elements are stored densely (erasing
+ * moves the last element into the gap), slots map handles to positions in the
+ * dense array. Insert, Erase and lookup are O(1), iteration is a linear scan
+ * over the dense array (in no particular order).
+ */
+template<class T>
+class SlotMap {
+  public:
+    // getter:
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+    const std::vector<T>& values() const { return values_; }
+
+    /**
+     * Gets handle of element at given position in dense array.
+     * @param[in] dense_index
+     * @return handle.
+     */
+    SlotHandle handle(size_t dense_index) const {
+      uint32_t index = slot_of_[dense_index];
+      return SlotHandle(index, slots_[index].generation_);
+    }
+
+    typename std::vector<T>::iterator begin() { return values_.begin(); }
+    typename std::vector<T>::iterator end() { return values_.end(); }
+    typename std::vector<T>::const_iterator begin() const { return values_.begin(); }
+    typename std::vector<T>::const_iterator end() const { return values_.end(); }
+
+    /**
+     * Adds element (reusing free slots).
+     * @param[in] value
+     * @return handle of new element.
+     */
+    SlotHandle Insert(T value) {
+      uint32_t index;
+      if (free_.size() > 0) {
+        index = free_.back();
+        free_.pop_back();
+      }
+      else {
+        index = slots_.size();
+        slots_.push_back({0, 1});
+      }
+      slots_[index].dense_index_ = values_.size();
+      values_.push_back(std::move(value));
+      slot_of_.push_back(index);
+      return SlotHandle(index, slots_[index].generation_);
+    }
+
+    /**
+     * Removes element. Invalidates handle (and all copies of it).
+     * @param[in] handle
+     * @return whether element existed.
+     */
+    bool Erase(SlotHandle handle) {
+      if (!Contains(handle))
+        return false;
+      uint32_t dense_index = slots_[handle.index_].dense_index_;
+      // Move last element into gap.
+      if (dense_index != values_.size()-1) {
+        values_[dense_index] = std::move(values_.back());
+        slot_of_[dense_index] = slot_of_.back();
+        slots_[slot_of_[dense_index]].dense_index_ = dense_index;
+      }
+      values_.pop_back();
+      slot_of_.pop_back();
+      // Skip generation 0, as it marks invalid handles.
+      if (++slots_[handle.index_].generation_ == 0)
+        slots_[handle.index_].generation_ = 1;
+      free_.push_back(handle.index_);
+      return true;
+    }
+
+    bool Contains(SlotHandle handle) const {
+      return handle.index_ < slots_.size() && handle.valid()
+        && slots_[handle.index_].generation_ == handle.generation_;
+    }
+
+    /**
+     * Gets element.
+     * @param[in] handle
+     * @return element.
+     * @throws std::out_of_range if handle is invalid or element was erased.
+     */
+    T& at(SlotHandle handle) {
+      if (!Contains(handle))
+        throw std::out_of_range("SlotMap::at: invalid handle.");
+      return values_[slots_[handle.index_].dense_index_];
+    }
+    const T& at(SlotHandle handle) const {
+      if (!Contains(handle))
+        throw std::out_of_range("SlotMap::at: invalid handle.");
+      return values_[slots_[handle.index_].dense_index_];
+    }
+
+    /**
+     * Calls func(handle, element) for each element.
+     * @param[in] func
+     */
+    template<class F>
+    void ForEach(F func) {
+      for (size_t i=0; i<values_.size(); i++)
+        func(handle(i), values_[i]);
+    }
+
+  private:
+    struct Slot {
+      uint32_t dense_index_;
+      uint32_t generation_;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_;  ///< indices of unused slots.
+    std::vector<T> values_;  ///< dense array of elements.
+    std::vector<uint32_t> slot_of_;  ///< slot of each element in dense array.
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef SRC_UTILS_SPATIAL_HASH_H_
+#define SRC_UTILS_SPATIAL_HASH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "utils/geometry.h"
+
+/**
+ * Uniform grid over the field, bucketing indices of positions by cell
+ * (compressed: one offset per cell into a single array of indices). Built
+ * once from a list of positions, a range query then only inspects the cells
+ * overlapping the range.
+ */
+class SpatialHash {
+  public:
+    /**
+     * Constructor.
+     * @param[in] lines of field.
+     * @param[in] cols of field.
+     * @param[in] cell_size lines and columns of one cell (best chosen as
+     * typical query range).
+     */
+    SpatialHash(int lines=0, int cols=0, int cell_size=1) : cell_size_(std::max(cell_size, 1)),
+      cell_lines_(std::max((lines+cell_size_-1)/cell_size_, 1)),
+      cell_cols_(std::max((cols+cell_size_-1)/cell_size_, 1)),
+      offsets_(cell_lines_*cell_cols_+1, 0) {}
+
+    // getter:
+    size_t size() const { return positions_.size(); }
+
+    /**
+     * Replaces all positions.
+     * @param[in] positions (indices passed to queries are indices into this vector).
+     */
+    void Build(const std::vector<geometry::position_t>& positions) {
+      positions_ = positions;
+      std::fill(offsets_.begin(), offsets_.end(), 0);
+      for (const auto& pos : positions_)
+        offsets_[Cell(pos)+1]++;
+      for (size_t i=1; i<offsets_.size(); i++)
+        offsets_[i] += offsets_[i-1];
+      indices_.resize(positions_.size());
+      std::vector<uint32_t> next(offsets_.begin(), offsets_.end()-1);
+      for (uint32_t i=0; i<positions_.size(); i++)
+        indices_[next[Cell(positions_[i])]++] = i;
+    }
+
+    /**
+     * Calls func(index) for every position closer than range to given
+     * position, until func returns false.
+     * @param[in] pos
+     * @param[in] range
+     * @param[in] func
+     */
+    template<class F>
+    void ForEachInRange(geometry::position_t pos, int range, F func) const {
+      int first_line = std::max((pos.first-range)/cell_size_, 0);
+      int last_line = std::min((pos.first+range)/cell_size_, cell_lines_-1);
+      int first_col = std::max((pos.second-range)/cell_size_, 0);
+      int last_col = std::min((pos.second+range)/cell_size_, cell_cols_-1);
+      for (int l=first_line; l<=last_line; l++) {
+        for (int c=first_col; c<=last_col; c++) {
+          int cell = l*cell_cols_+c;
+          for (uint32_t i=offsets_[cell]; i<offsets_[cell+1]; i++) {
+            if (geometry::DistSq(pos, positions_[indices_[i]]) < range*range && !func(indices_[i]))
+              return;
+          }
+        }
+      }
+    }
+
+  private:
+    int cell_size_;
+    int cell_lines_;
+    int cell_cols_;
+    std::vector<uint32_t> offsets_;  ///< first index of each cell in indices_ (plus end).
+    std::vector<uint32_t> indices_;  ///< indices of positions, ordered by cell.
+    std::vector<geometry::position_t> positions_;
+
+    int Cell(geometry::position_t pos) const {
+      int l = std::clamp(pos.first/cell_size_, 0, cell_lines_-1);
+      int c = std::clamp(pos.second/cell_size_, 0, cell_cols_-1);
+      return l*cell_cols_+c;
+    }
+};
+
+#endif
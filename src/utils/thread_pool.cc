@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils/thread_pool.h"
+
+namespace {
+  // Pool and queue of current thread (if it is a worker).
+  thread_local const ThreadPool* current_pool = nullptr;
+  thread_local size_t current_worker = 0;
+}
+
+ThreadPool::ThreadPool(size_t num_threads) : next_queue_(0), queued_(0), pending_(0), stop_(false) {
+  if (num_threads == 0)
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  for (size_t i=0; i<num_threads; i++)
+    queues_.push_back(std::make_unique<WorkQueue>());
+  for (size_t i=0; i<num_threads; i++)
+    workers_.emplace_back([this, i]() { Run(i); });
+}
+
+ThreadPool::~ThreadPool() {
+  std::unique_lock ul(mutex_);
+  stop_ = true;
+  ul.unlock();
+  cv_work_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+size_t ThreadPool::size() const {
+  return workers_.size();
+}
+
+void ThreadPool::Submit(job_t job) {
+  pending_++;
+  size_t queue = (current_pool == this) ? current_worker : next_queue_++ % queues_.size();
+  std::unique_lock ul_queue(queues_[queue]->mutex_);
+  queues_[queue]->jobs_.push_back(std::move(job));
+  ul_queue.unlock();
+  // Count under mutex, so no worker misses the job while going to sleep.
+  std::unique_lock ul(mutex_);
+  queued_++;
+  ul.unlock();
+  cv_work_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock ul(mutex_);
+  cv_done_.wait(ul, [this]() { return pending_ == 0; });
+}
+
+void ThreadPool::Run(size_t worker) {
+  current_pool = this;
+  current_worker = worker;
+  job_t job;
+  while (true) {
+    if (Pop(worker, job)) {
+      job();
+      job = nullptr;
+      if (--pending_ == 0) {
+        std::unique_lock ul(mutex_);
+        cv_done_.notify_all();
+      }
+      continue;
+    }
+    std::unique_lock ul(mutex_);
+    cv_work_.wait(ul, [this]() { return stop_ || queued_ > 0; });
+    if (stop_ && queued_ == 0)
+      return;
+  }
+}
+
+bool ThreadPool::Pop(size_t worker, job_t& job) {
+  // Own queue first (newest job), then steal (oldest job) from others.
+  for (size_t i=0; i<queues_.size(); i++) {
+    WorkQueue& queue = *queues_[(worker+i)%queues_.size()];
+    std::unique_lock ul(queue.mutex_);
+    if (queue.jobs_.empty())
+      continue;
+    if (i == 0) {
+      job = std::move(queue.jobs_.back());
+      queue.jobs_.pop_back();
+    }
+    else {
+      job = std::move(queue.jobs_.front());
+      queue.jobs_.pop_front();
+    }
+    queued_--;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,78 @@
+#ifndef SRC_UTILS_THREAD_POOL_H_
+#define SRC_UTILS_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work-stealing thread pool: each worker has its own queue (jobs submitted
+ * by a worker go to its own queue, others are distributed round-robin).
+ * Workers take jobs from the back of their own queue and, once it is empty,
+ * steal from the front of other workers' queues. So workers only contend
+ * when stealing, not on one shared queue.
+ * Jobs must not throw.
+ */
+class ThreadPool {
+  public:
+    typedef std::function<void()> job_t;
+
+    /**
+     * Constructor starting workers.
+     * @param[in] num_threads number of workers (0: number of cores).
+     */
+    ThreadPool(size_t num_threads=0);
+
+    /**
+     * Destructor: runs all remaining jobs and stops workers.
+     */
+    ~ThreadPool();
+
+    // getter:
+    size_t size() const;
+
+    /**
+     * Adds job.
+     * @param[in] job
+     */
+    void Submit(job_t job);
+
+    /**
+     * Blocks until all submitted jobs (including jobs submitted by jobs) are
+     * done.
+     */
+    void Wait();
+
+  private:
+    struct WorkQueue {
+      std::mutex mutex_;
+      std::deque<job_t> jobs_;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_;
+    std::atomic<size_t> queued_;  ///< jobs in all queues.
+    std::atomic<size_t> pending_;  ///< jobs submitted, but not done.
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable cv_work_;
+    std::condition_variable cv_done_;
+
+    void Run(size_t worker);
+
+    /**
+     * Takes job from worker's own queue or steals one from other queues.
+     * @param[in] worker
+     * @param[out] job
+     * @return whether a job was found.
+     */
+    bool Pop(size_t worker, job_t& job);
+};
+
+#endif
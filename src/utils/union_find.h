@@ -0,0 +1,71 @@
+#ifndef SRC_UTILS_UNION_FIND_H_
+#define SRC_UTILS_UNION_FIND_H_
+
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * Disjoint-set forest over dense indices (union by size, path halving), so
+ * Find, Union and Connected are amortized O(α(n)).
+ */
+class UnionFind {
+  public:
+    UnionFind(size_t size = 0) : parent_(size), size_(size, 1) {
+      std::iota(parent_.begin(), parent_.end(), 0);
+    }
+
+    // getter:
+    size_t size() const { return parent_.size(); }
+
+    /**
+     * Gets representative of set containing given element.
+     * @param[in] a
+     * @return representative.
+     */
+    uint32_t Find(uint32_t a) {
+      while (parent_[a] != a) {
+        parent_[a] = parent_[parent_[a]];
+        a = parent_[a];
+      }
+      return a;
+    }
+
+    /**
+     * Merges sets containing given elements.
+     * @param[in] a
+     * @param[in] b
+     * @return whether sets were disjoint before.
+     */
+    bool Union(uint32_t a, uint32_t b) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b)
+        return false;
+      if (size_[a] < size_[b])
+        std::swap(a, b);
+      parent_[b] = a;
+      size_[a] += size_[b];
+      return true;
+    }
+
+    bool Connected(uint32_t a, uint32_t b) {
+      return Find(a) == Find(b);
+    }
+
+    /**
+     * Gets size of set containing given element.
+     * @param[in] a
+     * @return size of set.
+     */
+    uint32_t SizeOfSet(uint32_t a) {
+      return size_[Find(a)];
+    }
+
+  private:
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> size_;
+};
+
+#endif
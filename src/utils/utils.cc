@@ -12,8 +12,9 @@
 #include <vector>
 #include <sstream>
 #include "spdlog/spdlog.h"
+#include "utils/logger.h"
+#include "utils/geometry.h"
 
-#define LOGGER "logger"
 
 
 bool utils::IsDown(char choice) {
@@ -42,8 +43,7 @@ double utils::Dist(position_t pos1, position_t pos2) {
 }
 
 bool utils::InRange(position_t pos1, position_t pos2, double min_dist, double max_dist) {
-  double dist = utils::Dist(pos1, pos2);
-  return dist >= min_dist && dist <= max_dist;
+  return geometry::InRange(pos1, pos2, min_dist, max_dist);
 }
 
 std::vector<std::string> utils::Split(std::string str, std::string delimiter) {
@@ -88,28 +88,18 @@ std::string utils::Dtos(double value, unsigned int precision) {
   return stream.str();
 }
 
-std::string utils::CreateId(std::string type) {
-  std::string id = type;
-  for (int i=0; i<32; i++) {
-    int ran = rand() % 9;
-    id += std::to_string(ran);
-  }
-  return id;
-
-}
-
 nlohmann::json utils::LoadJsonFromDisc(std::string path) {
   nlohmann::json json;
   std::ifstream read(path.c_str());
   if (!read) {
-    spdlog::get(LOGGER)->error("Audio::Safe: Could not open file at {}", path);
+    LOG_ERROR(LOG_GAME, "Audio::Safe: Could not open file at {}", path);
     return json;
   }
   try {
     read >> json;
   } 
   catch (std::exception& e) {
-    spdlog::get(LOGGER)->error("Audio::Safe: Could not read json.");
+    LOG_ERROR(LOG_GAME, "Audio::Safe: Could not read json.");
     read.close();
     return json;
   }
@@ -121,9 +111,9 @@ nlohmann::json utils::LoadJsonFromDisc(std::string path) {
 void utils::WriteJsonFromDisc(std::string path, nlohmann::json& json) {
   std::ofstream write(path.c_str());
   if (!write)
-    spdlog::get(LOGGER)->error("Audio::Safe: Could not safe at {}", path);
+    LOG_ERROR(LOG_GAME, "Audio::Safe: Could not safe at {}", path);
   else {
-    spdlog::get(LOGGER)->info("Audio::Safe: safeing at {}", path);
+    LOG_INFO(LOG_GAME, "Audio::Safe: safeing at {}", path);
     write << json;
   }
   write.close();
@@ -136,6 +126,5 @@ std::string utils::GetFormatedDatetime() {
   std::time(&rawtime);
   timeinfo = std::localtime(&rawtime);
   std::strftime(buffer, 80, "%Y-%m-%d-%H-%M-%S",timeinfo);
-  std::puts(buffer);
   return buffer;
 }
@@ -108,13 +108,6 @@ namespace utils {
     return out_vec;
   }
   
-  /**
-   * Creates id in format: [type][random(0, 9) x 39].
-   * @param[in] type
-   * @return id in format: [type][random(0, 9) x 39].
-   */
-  std::string CreateId(std::string type);
-
   /** 
    * @brief Loads json from disc
    * @param[in] path path to json.
@@ -136,10 +129,10 @@ namespace utils {
    */
   std::string GetFormatedDatetime();
 
-  template<class T>
-  int Index(std::list<T> list, T elem) {
-    auto it = std::find(list.begin(), list.end(), elem);
-    return std::distance(list.begin(), it);
+  template<class Container, class T>
+  int Index(const Container& container, T elem) {
+    auto it = std::find(container.begin(), container.end(), elem);
+    return std::distance(container.begin(), it);
   }
 }
 
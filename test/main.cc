@@ -3,20 +3,21 @@
 #define CATCH_CONFIG_RUNNER
 #include <catch2/catch.hpp>
 #include <spdlog/spdlog.h>
-#include "spdlog/sinks/basic_file_sink.h"
 #include "audio/audio.h"
+#include "utils/logger.h"
 
-#define LOGGER "logger"
+#ifndef TEST_LOG_FILE
+#define TEST_LOG_FILE "test/logs/test-log.txt"
+#endif
 
 int main( int argc, char* argv[] ) {
   // global setup...
-  std::filesystem::remove("test/logs/test-log.txt");
+  std::filesystem::remove(TEST_LOG_FILE);
 
   srand (time(NULL));
 
-  auto logger = spdlog::basic_logger_mt("logger", "test/logs/test-log.txt");
+  utils::InitLogging(TEST_LOG_FILE, spdlog::level::debug, false);
   spdlog::flush_on(spdlog::level::debug);
-  spdlog::set_level(spdlog::level::debug);
 
   int result = Catch::Session().run( argc, argv );
 
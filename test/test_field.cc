@@ -32,7 +32,7 @@ TEST_CASE("test_field", "[main]") {
 
         // Create way
         way_points.push_back(target_pos);
-        auto way = field->GetWayForSoldier(start_pos, way_points);
+        auto way = *field->GetWayForSoldier(start_pos, way_points);
 
         // Way was created with length of min number of way-points and make sure order is correct.
         REQUIRE(way.size() > 4);
@@ -44,26 +44,98 @@ TEST_CASE("test_field", "[main]") {
     }
   }
 
+  SECTION("test GetWayForSoldier uses cached ways") {
+    position_t start_pos = field->AddNucleus(8);
+    position_t target_pos = field->AddNucleus(1);
+    field->BuildGraph(start_pos, target_pos);
+    auto way = field->GetWayForSoldier(start_pos, {{50, 50}, target_pos});
+    size_t misses = field->path_cache().misses();
+    size_t hits = field->path_cache().hits();
+    // Same way is shared, not copied.
+    REQUIRE(field->GetWayForSoldier(start_pos, {{50, 50}, target_pos}) == way);
+    REQUIRE(field->path_cache().hits() == hits+1);
+    REQUIRE(field->path_cache().misses() == misses);
+  }
+
+  SECTION("test GetFlowField drops least recently used flow-field") {
+    position_t start_pos = field->AddNucleus(8);
+    position_t target_pos = field->AddNucleus(1);
+    field->BuildGraph(start_pos, target_pos);
+    auto nucleus_flow = field->GetFlowField(target_pos);
+    REQUIRE(nucleus_flow != nullptr);
+    // Request more other targets than flow-fields are kept, using nucleus' flow-field in between.
+    std::shared_ptr<const FlowField> first_flow = nullptr;
+    position_t first_pos = {-1, -1};
+    int added = 0;
+    for (const auto& pos : field->GetAllPositionsOfSection(5)) {
+      if (added == 40)
+        break;
+      auto flow = field->GetFlowField(pos);
+      if (pos == target_pos || !flow)
+        continue;
+      if (added++ == 0) {
+        first_flow = flow;
+        first_pos = pos;
+      }
+      REQUIRE(field->GetFlowField(target_pos) == nucleus_flow);
+    }
+    REQUIRE(added == 40);
+    // Flow-field of first other target was not used since and was dropped.
+    REQUIRE(field->GetFlowField(first_pos) != first_flow);
+  }
+
+  SECTION("test AddNuclei places connected nuclei on map with hills") {
+    field->AddHills(ran_gen, ran_gen, 0);
+    auto [pos_1, pos_2] = field->AddNuclei(1, 8);
+    REQUIRE(field->GetSymbolAtPos(pos_1) == SYMBOL_DEN);
+    REQUIRE(field->GetSymbolAtPos(pos_2) == SYMBOL_DEN);
+    REQUIRE_NOTHROW(field->BuildGraph(pos_1, pos_2));
+    auto way = field->GetWayForSoldier(pos_1, {pos_2});
+    REQUIRE(way->front() == pos_1);
+    REQUIRE(way->back() == pos_2);
+  }
+
   SECTION("Test BuildGraph with all positions free.") {
-    Graph graph;
+    Graph graph(field->lines(), field->cols());
     // Add all nodes.
     for (int l=0; l<field->lines(); l++)
       for (int c=0; c<field->cols(); c++)
         graph.AddNode(l, c);
-    // For each node, add edges.
-    for (auto node : graph.nodes()) {
-      auto neighbors = field->GetAllInRange({node.second->line_, node.second->col_}, 1.5, 1);
-      if (node.second->line_ > 0 && node.second->line_ < field->lines() && node.second->col_ > 0 
-          && node.second->col_ < field->cols())
-        REQUIRE(neighbors.size() == 8);
-      for (const auto& pos : neighbors) {
-        if (graph.InGraph(pos))
-          graph.AddEdge(node.second, graph.nodes().at(pos));
+    REQUIRE(graph.size() == (size_t)(field->lines()*field->cols()));
+    // Check implicit edges.
+    for (int l=0; l<field->lines(); l++) {
+      for (int c=0; c<field->cols(); c++) {
+        std::vector<position_t> neighbors;
+        graph.ForEachNeighbor(graph.Index({l, c}), [&](uint32_t index) { 
+            neighbors.push_back(graph.Position(index)); 
+          });
+        if (l > 0 && l < field->lines()-1 && c > 0 && c < field->cols()-1)
+          REQUIRE(neighbors == field->GetAllInRange({l, c}, 1.5, 1));
+        else if ((l == 0 || l == field->lines()-1) && (c == 0 || c == field->cols()-1))
+          REQUIRE(neighbors.size() == 3);
+        else
+          REQUIRE(neighbors.size() == 5);
       }
     }
     REQUIRE(graph.RemoveInvalid({50, 50}) == 0);
   }
 
+  SECTION("Test RemoveInvalid removes unreachable nodes.") {
+    Graph graph(10, 10);
+    // Add all nodes except wall at column 4.
+    for (int l=0; l<10; l++)
+      for (int c=0; c<10; c++)
+        if (c != 4)
+          graph.AddNode(l, c);
+    Pathfinder pathfinder(&graph);
+    REQUIRE(pathfinder.FindWay({0, 0}, {0, 3}).size() == 4);
+    REQUIRE_THROWS(pathfinder.FindWay({0, 0}, {0, 5}));
+    REQUIRE(graph.RemoveInvalid({0, 0}) == 50);
+    REQUIRE(graph.InGraph({9, 3}));
+    REQUIRE(!graph.InGraph({0, 5}));
+    REQUIRE(graph.size() == 40);
+  }
+
   SECTION("test GetAllInRange") {
     SECTION("Don't check free, range=1") {
       auto positions = field->GetAllInRange({50, 50}, 1, 1);
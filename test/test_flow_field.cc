@@ -0,0 +1,68 @@
+#include <catch2/catch.hpp>
+#include <vector>
+#include "objects/units.h"
+#include "random/random.h"
+#include "utils/flow_field.h"
+#include "utils/graph.h"
+#include "utils/pathfinder.h"
+
+TEST_CASE("test_flow_field", "[flow_field]") {
+  RandomGenerator ran_gen;
+  Graph graph(30, 40);
+  for (int l=0; l<30; l++)
+    for (int c=0; c<40; c++)
+      if (ran_gen.RandomInt(0, 9) < 7)
+        graph.AddNode(l, c);
+  graph.AddNode(0, 0);
+  graph.AddNode(29, 39);
+  graph.RemoveInvalid({29, 39});
+  graph.AddNode(15, 20);  // might be unconnected to other source.
+  Pathfinder pathfinder(&graph);
+
+  SECTION("test following flow-field gives shortest way") {
+    FlowField flow_field(&graph);
+    flow_field.AddSource({29, 39});
+    REQUIRE(flow_field.Distance({29, 39}) == 0);
+    for (int l=0; l<30; l++) {
+      for (int c=0; c<40; c++) {
+        if (!graph.InGraph({l, c})) {
+          REQUIRE(flow_field.Distance({l, c}) == FLOW_FIELD_UNREACHABLE);
+          continue;
+        }
+        // Each step decreases distance by cost of step.
+        position_t next = flow_field.NextStep({l, c});
+        if (flow_field.Distance({l, c}) > 0 && flow_field.Distance({l, c}) != FLOW_FIELD_UNREACHABLE) {
+          bool diagonal = next.first != l && next.second != c;
+          REQUIRE(flow_field.Distance(next) + ((diagonal) ? 14 : 10) == flow_field.Distance({l, c}));
+        }
+      }
+    }
+    // Number of steps matches way found by pathfinder.
+    if (graph.InGraph({0, 0})) {
+      Epsp epsp({0, 0}, nullptr, 0, 0);
+      epsp.FollowFlowField(std::make_shared<FlowField>(flow_field), {29, 39});
+      auto way = pathfinder.FindWay({0, 0}, {29, 39});
+      REQUIRE(epsp.Way().size() == way.size()-1);
+      while (!epsp.AtTarget())
+        epsp.Step();
+      REQUIRE(epsp.pos_ == position_t{29, 39});
+    }
+  }
+
+  SECTION("test adding and removing sources") {
+    FlowField incremental(&graph);
+    incremental.AddSource({29, 39});
+    incremental.AddSource({15, 20});
+    FlowField single(&graph);
+    single.AddSource({15, 20});
+    for (int l=0; l<30; l++)
+      for (int c=0; c<40; c++)
+        REQUIRE(incremental.Distance({l, c}) <= single.Distance({l, c}));
+    REQUIRE(incremental.Distance({15, 20}) == 0);
+    incremental.RemoveSource({29, 39});
+    REQUIRE(incremental.sources().size() == 1);
+    for (int l=0; l<30; l++)
+      for (int c=0; c<40; c++)
+        REQUIRE(incremental.Distance({l, c}) == single.Distance({l, c}));
+  }
+}
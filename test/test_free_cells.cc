@@ -0,0 +1,71 @@
+#include <catch2/catch.hpp>
+#include <vector>
+#include "game/free_cells.h"
+#include "random/random.h"
+#include "utils/geometry.h"
+
+TEST_CASE("test_free_cells", "[free_cells]") {
+  RandomGenerator ran_gen;
+  int lines = 30;
+  int cols = 40;
+  // Two sections: left and right half.
+  std::vector<unsigned char> sections;
+  for (int l=0; l<lines; l++)
+    for (int c=0; c<cols; c++)
+      sections.push_back((c < cols/2) ? 1 : 2);
+  FreeCells free_cells(lines, cols, sections, 2);
+  for (int l=0; l<lines; l++)
+    for (int c=0; c<cols; c++)
+      free_cells.Add({l, c});
+
+  SECTION("test adding and removing cells") {
+    REQUIRE(free_cells.size() == (size_t)(lines*cols));
+    REQUIRE(free_cells.SizeOfSection(1) == (size_t)(lines*cols/2));
+    free_cells.Remove({3, 4});
+    free_cells.Remove({3, 4});
+    REQUIRE(!free_cells.Contains({3, 4}));
+    REQUIRE(free_cells.Contains({3, 5}));
+    REQUIRE(free_cells.size() == (size_t)(lines*cols-1));
+    REQUIRE(free_cells.SizeOfSection(1) == (size_t)(lines*cols/2-1));
+    free_cells.Add({3, 4});
+    REQUIRE(free_cells.Contains({3, 4}));
+    REQUIRE(free_cells.size() == (size_t)(lines*cols));
+    // Positions outside are ignored.
+    free_cells.Add({-1, 4});
+    REQUIRE(!free_cells.Contains({-1, 4}));
+    REQUIRE(free_cells.size() == (size_t)(lines*cols));
+  }
+
+  SECTION("test random cell of section") {
+    for (int c=0; c<cols/2; c++)
+      for (int l=0; l<lines; l++)
+        if (c != 7 || l != 9)
+          free_cells.Remove({l, c});
+    for (int i=0; i<10; i++)
+      REQUIRE(free_cells.RandomInSection(1, &ran_gen) == position_t{9, 7});
+    free_cells.Remove({9, 7});
+    REQUIRE(free_cells.RandomInSection(1, &ran_gen) == position_t{-1, -1});
+    REQUIRE(free_cells.RandomInSection(2, &ran_gen).second >= cols/2);
+  }
+
+  SECTION("test random cell in range") {
+    position_t center = {15, 20};
+    for (int i=0; i<100; i++) {
+      position_t pos = free_cells.RandomInRange(center, 2, 4, &ran_gen);
+      REQUIRE(geometry::InRange(center, pos, 2, 4));
+      REQUIRE(free_cells.Contains(pos));
+    }
+    // Only one free cell in range left: it must be found.
+    geometry::ForEachInRange(center, 4, 2, [&](position_t pos) {
+        if (pos != position_t{12, 18})
+          free_cells.Remove(pos);
+      });
+    for (int i=0; i<10; i++)
+      REQUIRE(free_cells.RandomInRange(center, 2, 4, &ran_gen) == position_t{12, 18});
+    free_cells.Remove({12, 18});
+    REQUIRE(free_cells.RandomInRange(center, 2, 4, &ran_gen) == position_t{-1, -1});
+    // Range at the border of the field.
+    position_t pos = free_cells.RandomInRange({0, 0}, 1, 3, &ran_gen);
+    REQUIRE(geometry::InRange({0, 0}, pos, 1, 3));
+  }
+}
@@ -0,0 +1,49 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+#include "utils/geometry.h"
+#include "utils/utils.h"
+
+std::vector<geometry::position_t> BruteForceInRange(geometry::position_t center, double max_dist, double min_dist) {
+  std::vector<geometry::position_t> positions;
+  int reach = max_dist+1;
+  for (int l=center.first-reach; l<=center.first+reach; l++) {
+    for (int c=center.second-reach; c<=center.second+reach; c++) {
+      double dist = std::sqrt(pow(l-center.first, 2) + pow(c-center.second, 2));
+      if (dist >= min_dist && dist <= max_dist)
+        positions.push_back({l, c});
+    }
+  }
+  return positions;
+}
+
+TEST_CASE("test_geometry", "[utils]") {
+
+  SECTION("test stencils") {
+    // Each stencil contains all offsets of the smaller stencils.
+    for (int reach=1; reach<=MAX_STENCIL_REACH; reach++)
+      REQUIRE(geometry::StencilSize(reach) > geometry::StencilSize(reach-1));
+    REQUIRE(geometry::StencilSize(0) == 1);
+    REQUIRE(geometry::StencilSize(1) == 9);
+    REQUIRE(geometry::STENCILS.begin_[MAX_STENCIL_REACH+1] == geometry::AllStencilsSize());
+  }
+
+  SECTION("test ForEachInRange matches euclidean distance in row-major order") {
+    geometry::position_t center = {20, 30};
+    for (double max_dist : {0.0, 1.0, 1.5, 2.0, 2.5, 3.0, 4.0, 7.3, 16.0, 16.9, 21.0}) {
+      for (double min_dist : {0.0, 1.0, 2.0, 3.0}) {
+        std::vector<geometry::position_t> positions;
+        geometry::ForEachInRange(center, max_dist, min_dist, [&](geometry::position_t pos) { positions.push_back(pos); });
+        REQUIRE(positions == BruteForceInRange(center, max_dist, min_dist));
+      }
+    }
+  }
+
+  SECTION("test squared distance") {
+    REQUIRE(geometry::DistSq({0, 0}, {3, 4}) == 25);
+    REQUIRE(geometry::InRange({0, 0}, {3, 4}, 5, 5));
+    REQUIRE(geometry::InRange({0, 0}, {1, 1}, 1, 1.5));
+    REQUIRE(!geometry::InRange({0, 0}, {2, 1}, 1, 2));
+    REQUIRE(utils::InRange({0, 0}, {2, 1}, 1, 2.5));
+  }
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <vector>
+#include "random/random.h"
+#include "utils/graph.h"
+#include "utils/hierarchical_pathfinder.h"
+#include "utils/pathfinder.h"
+
+namespace {
+  int WayCost(const std::vector<position_t>& way) {
+    int cost = 0;
+    for (size_t i=1; i<way.size(); i++) {
+      int dl = std::abs(way[i].first - way[i-1].first);
+      int dc = std::abs(way[i].second - way[i-1].second);
+      REQUIRE(std::max(dl, dc) == 1);
+      cost += (dl == 1 && dc == 1) ? 14 : 10;
+    }
+    return cost;
+  }
+}
+
+TEST_CASE("test_hierarchical_pathfinder", "[pathfinder]") {
+  RandomGenerator ran_gen;
+  Graph graph(60, 120);
+  for (int l=0; l<60; l++)
+    for (int c=0; c<120; c++)
+      if (ran_gen.RandomInt(0, 9) < 8)
+        graph.AddNode(l, c);
+  // Keep main area connected to an open center.
+  for (int l=28; l<=32; l++)
+    for (int c=58; c<=62; c++)
+      graph.AddNode(l, c);
+  graph.RemoveInvalid({30, 60});
+  // Eight sections, each split into clusters of at most 16x16.
+  HierarchicalPathfinder hierarchical_pathfinder(&graph, HierarchicalPathfinder::Borders(60, 2, 16),
+      HierarchicalPathfinder::Borders(120, 4, 16));
+  REQUIRE(HierarchicalPathfinder::Borders(60, 2, 16) == std::vector<int>({0, 15, 30, 45}));
+  REQUIRE(HierarchicalPathfinder::Borders(120, 4, 16) == std::vector<int>({0, 15, 30, 45, 60, 75, 90, 105}));
+  REQUIRE(hierarchical_pathfinder.num_clusters() == 32);
+  Pathfinder pathfinder(&graph);
+  REQUIRE(hierarchical_pathfinder.num_portals() > 0);
+  REQUIRE(hierarchical_pathfinder.Cluster({0, 0}) == 0);
+  REQUIRE(hierarchical_pathfinder.Cluster({59, 119}) == 31);
+  REQUIRE(hierarchical_pathfinder.Cluster({15, 14}) == 8);
+
+  SECTION("test ways across clusters are valid and near-optimal") {
+    for (int i=0; i<30; i++) {
+      position_t start = {ran_gen.RandomInt(0, 59), ran_gen.RandomInt(0, 119)};
+      position_t target = {ran_gen.RandomInt(0, 59), ran_gen.RandomInt(0, 119)};
+      if (!graph.InGraph(start) || !graph.InGraph(target))
+        continue;
+      auto way = hierarchical_pathfinder.FindWay(start, target);
+      REQUIRE(way.front() == start);
+      REQUIRE(way.back() == target);
+      for (const auto& pos : way)
+        REQUIRE(graph.InGraph(pos));
+      int optimal = WayCost(pathfinder.FindWay(start, target));
+      REQUIRE(WayCost(way) >= optimal);
+      REQUIRE(WayCost(way) <= optimal*3/2 + 40);
+    }
+  }
+
+  SECTION("test unreachable target throws") {
+    REQUIRE_THROWS(hierarchical_pathfinder.FindWay({30, 60}, {-1, 5}));
+  }
+}
@@ -0,0 +1,59 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "utils/mpsc_queue.h"
+
+TEST_CASE("test_mpsc_queue", "[mpsc_queue]") {
+  MpscQueue<std::string> queue;
+  REQUIRE(!queue.Pop());
+
+  SECTION("elements are popped in order pushed") {
+    queue.Push("a");
+    queue.Push("b");
+    REQUIRE(*queue.Pop() == "a");
+    queue.Push("c");
+    REQUIRE(*queue.Pop() == "b");
+    REQUIRE(*queue.Pop() == "c");
+    REQUIRE(!queue.Pop());
+  }
+
+  SECTION("remaining elements are freed") {
+    queue.Push("a");
+    queue.Push("b");
+  }
+}
+
+TEST_CASE("test_mpsc_queue_multiple_producers", "[mpsc_queue]") {
+  MpscQueue<std::pair<int, int>> queue;
+  const int num_producers = 4;
+  const int num_elements = 10000;
+
+  std::vector<std::thread> producers;
+  for (int p=0; p<num_producers; p++) {
+    producers.emplace_back([&queue, p]() {
+      for (int i=0; i<num_elements; i++)
+        queue.Push({p, i});
+    });
+  }
+
+  // Consume while producing: every element arrives once, in order per producer.
+  std::vector<int> next(num_producers, 0);
+  int received = 0;
+  while (received < num_producers*num_elements) {
+    auto element = queue.Pop();
+    if (!element) {
+      std::this_thread::yield();
+      continue;
+    }
+    REQUIRE(element->second == next[element->first]);
+    next[element->first]++;
+    received++;
+  }
+  for (auto& producer : producers)
+    producer.join();
+  REQUIRE(!queue.Pop());
+  for (const auto& it : next)
+    REQUIRE(it == num_elements);
+}
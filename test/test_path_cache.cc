@@ -0,0 +1,39 @@
+#include <catch2/catch.hpp>
+#include <vector>
+#include "game/path_cache.h"
+
+TEST_CASE("test_path_cache", "[path_cache]") {
+  PathCache cache(2);
+  path_t way = std::make_shared<const std::vector<position_t>>(std::vector<position_t>{{0, 0}, {0, 1}, {1, 2}});
+
+  SECTION("test hits and misses") {
+    REQUIRE(!cache.Get({0, 0}, {{1, 2}}, 1));
+    cache.Put({0, 0}, {{1, 2}}, 1, way);
+    // Cached way is shared, not copied.
+    REQUIRE(cache.Get({0, 0}, {{1, 2}}, 1) == way);
+    // Different way-points are a different key.
+    REQUIRE(!cache.Get({0, 0}, {{0, 1}, {1, 2}}, 1));
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 2);
+  }
+
+  SECTION("test least recently used way is dropped") {
+    cache.Put({0, 0}, {{1, 2}}, 1, way);
+    cache.Put({5, 5}, {{1, 2}}, 1, way);
+    REQUIRE(cache.Get({0, 0}, {{1, 2}}, 1));
+    cache.Put({6, 6}, {{1, 2}}, 1, way);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.Get({0, 0}, {{1, 2}}, 1));
+    REQUIRE(!cache.Get({5, 5}, {{1, 2}}, 1));
+    REQUIRE(cache.Get({6, 6}, {{1, 2}}, 1));
+  }
+
+  SECTION("test newer map-version drops all ways") {
+    cache.Put({0, 0}, {{1, 2}}, 1, way);
+    REQUIRE(!cache.Get({0, 0}, {{1, 2}}, 2));
+    REQUIRE(cache.size() == 0);
+    // Ways of old version are not added anymore.
+    cache.Put({0, 0}, {{1, 2}}, 1, way);
+    REQUIRE(cache.size() == 0);
+  }
+}
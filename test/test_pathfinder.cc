@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <queue>
+#include <vector>
+#include "random/random.h"
+#include "utils/graph.h"
+#include "utils/pathfinder.h"
+
+namespace {
+  /**
+   * Dijkstra over all eight neighbors (10 straight, 14 diagonal) for comparison.
+   */
+  int ReferenceCost(const Graph& graph, position_t start, position_t target) {
+    std::vector<int> dist(graph.lines()*graph.cols(), -1);
+    std::priority_queue<std::pair<int, uint32_t>, std::vector<std::pair<int, uint32_t>>, 
+      std::greater<std::pair<int, uint32_t>>> queue;
+    queue.push({0, graph.Index(start)});
+    while (!queue.empty()) {
+      auto [d, index] = queue.top();
+      queue.pop();
+      if (dist[index] != -1)
+        continue;
+      dist[index] = d;
+      position_t cur = graph.Position(index);
+      graph.ForEachNeighbor(index, [&](uint32_t neighbor) {
+          position_t pos = graph.Position(neighbor);
+          bool diagonal = pos.first != cur.first && pos.second != cur.second;
+          if (dist[neighbor] == -1)
+            queue.push({d + ((diagonal) ? 14 : 10), neighbor});
+        });
+    }
+    return dist[graph.Index(target)];
+  }
+
+  int Cost(const std::vector<position_t>& way) {
+    int cost = 0;
+    for (size_t i=1; i<way.size(); i++) {
+      int dl = std::abs(way[i].first - way[i-1].first);
+      int dc = std::abs(way[i].second - way[i-1].second);
+      REQUIRE(std::max(dl, dc) == 1);
+      cost += (dl == 1 && dc == 1) ? 14 : 10;
+    }
+    return cost;
+  }
+}
+
+TEST_CASE("test_pathfinder", "[pathfinder]") {
+  RandomGenerator ran_gen;
+
+  SECTION("test way on open grid") {
+    Graph graph(50, 50);
+    for (int l=0; l<50; l++)
+      for (int c=0; c<50; c++)
+        graph.AddNode(l, c);
+    Pathfinder pathfinder(&graph);
+    auto way = pathfinder.FindWay({0, 0}, {10, 40});
+    REQUIRE(way.front() == position_t{0, 0});
+    REQUIRE(way.back() == position_t{10, 40});
+    REQUIRE(way.size() == 41);
+    REQUIRE(Cost(way) == 10*14 + 30*10);
+    REQUIRE(pathfinder.FindWay({3, 3}, {3, 3}) == std::vector<position_t>{{3, 3}});
+  }
+
+  SECTION("test ways are shortest on random grids") {
+    for (int i=0; i<20; i++) {
+      Graph graph(30, 40);
+      for (int l=0; l<30; l++)
+        for (int c=0; c<40; c++)
+          if (ran_gen.RandomInt(0, 9) < 7)
+            graph.AddNode(l, c);
+      graph.AddNode(0, 0);
+      graph.AddNode(29, 39);
+      Pathfinder pathfinder(&graph);
+      int reference = ReferenceCost(graph, {0, 0}, {29, 39});
+      if (reference == -1) {
+        REQUIRE_THROWS(pathfinder.FindWay({0, 0}, {29, 39}));
+        continue;
+      }
+      auto way = pathfinder.FindWay({0, 0}, {29, 39});
+      REQUIRE(way.front() == position_t{0, 0});
+      REQUIRE(way.back() == position_t{29, 39});
+      for (const auto& pos : way)
+        REQUIRE(graph.InGraph(pos));
+      REQUIRE(Cost(way) == reference);
+    }
+  }
+}
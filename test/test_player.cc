@@ -9,16 +9,8 @@
 
 std::pair<Player*, Field*> SetUpPlayer(bool resources) {
   RandomGenerator* ran_gen = new RandomGenerator();
-  Field* field = new Field(ran_gen->RandomInt(50, 150), ran_gen->RandomInt(50, 150), ran_gen);
-  position_t nucleus_pos_1 = field->AddNucleus(8);
-  position_t nucleus_pos_2 = field->AddNucleus(1);
-  field->BuildGraph(nucleus_pos_1, nucleus_pos_2);
-  auto resource_positions_1 = field->AddResources(nucleus_pos_1);
-  auto resource_positions_2 = field->AddResources(nucleus_pos_2);
-  Player* player_one_ = new Player(nucleus_pos_1, field, ran_gen, resource_positions_1);
-  Player* player_two_ = new Player(nucleus_pos_2, field, ran_gen, resource_positions_2);
-  player_one_->set_enemy(player_two_);
-  player_two_->set_enemy(player_one_);
+  Field* field = nullptr;
+  Player* player_one_ = t_utils::SetUpPlayers(&field, ran_gen).first;
 
   if (resources) {
     // Increase resources 20 times for iron gain.
@@ -88,6 +80,20 @@ TEST_CASE("test_ipsp_takes_epsp_potential", "[test_player]") {
 
     // All synapses and all activated neurons +6 (nucleus & resource-neurons) should equal the number of all neurons.
     REQUIRE(all_activated_neurons.size() + all_synapse_position.size() + 6 == player->GetAllPositionsOfNeurons().size());
+    REQUIRE(player->GetNumNeurons(ACTIVATEDNEURON) == all_activated_neurons.size());
+    REQUIRE(player->GetNumNeurons() == player->GetAllPositionsOfNeurons().size());
+  }
+
+  SECTION("test GetRandomNeuron honours type") {
+    // Without activated neurons, any neuron is returned.
+    REQUIRE(player->GetRandomNeuron() != position_t{-1, -1});
+    REQUIRE(player->AddNeuron(t_utils::GetRandomPositionInField(field, ran_gen), SYNAPSE));
+    CreateRandomNeurons(player, field, 5, ran_gen); 
+    for (int i=0; i<10; i++) {
+      REQUIRE(player->GetNeuronTypeAtPosition(player->GetRandomNeuron({SYNAPSE})) == SYNAPSE);
+      int type = player->GetNeuronTypeAtPosition(player->GetRandomNeuron({SYNAPSE, NUCLEUS}));
+      REQUIRE((type == SYNAPSE || type == NUCLEUS));
+    }
   }
   
   SECTION ("test ResetWayForSynapse") {
@@ -103,5 +109,68 @@ TEST_CASE("test_ipsp_takes_epsp_potential", "[test_player]") {
     REQUIRE(player->AddWayPosForSynapse(pos, {pos.first+1, pos.second+1}) == 3);  // Adding third way-point returns 3
     REQUIRE(player->ResetWayForSynapse(pos, {pos.first+1, pos.second+1}) == 1);  // Reseting returns 1
   }
+
+  SECTION ("test swarm creates one stack of potentials") {
+    REQUIRE(player->AddTechnology(UnitsTech::SWARM));
+    auto pos = field->FindFree(player->GetOneNucleus(), 1, 3);
+    player->AddNeuron(pos, SYNAPSE);
+    player->SwitchSwarmAttack(pos);
+    for (int i=0; i<4; i++)
+      REQUIRE(player->AddPotential(pos, UnitsTech::EPSP));
+    REQUIRE(player->potential().size() == 1);
+    auto stack = *player->potential().begin();
+    REQUIRE(stack.count_ == 4);
+
+    // Neutralizing splits one potential from stack.
+    player->NeutralizePotential(player->potential().handle(0), 1);
+    REQUIRE(player->potential().size() == 2);
+    int count = 0;
+    for (const auto& it : player->potential()) {
+      count += it.count_;
+      REQUIRE(it.pos_ == stack.pos_);
+      if (it.count_ == 1)
+        REQUIRE(it.potential_ == stack.potential_-1);
+      else 
+        REQUIRE(it.potential_ == stack.potential_);
+    }
+    REQUIRE(count == 4);
+  }
+
+  SECTION ("test snapshot only changes when published") {
+    auto pos = field->FindFree(player->GetOneNucleus(), 1, 3);
+    player->AddNeuron(pos, SYNAPSE);
+    auto snapshot = player->snapshot();
+    REQUIRE(player->AddPotential(pos, UnitsTech::EPSP));
+    REQUIRE(player->snapshot() == snapshot);
+    REQUIRE(player->snapshot()->potential_.size() == 0);
+    player->PublishSnapshot();
+    REQUIRE(player->snapshot()->potential_.size() == 1);
+    // Old snapshot stays unchanged for readers still holding it.
+    REQUIRE(snapshot->potential_.size() == 0);
+  }
+
+  SECTION ("test snapshots share neurons and technologies until changed") {
+    player->PublishSnapshot();
+    auto snapshot = player->snapshot();
+    player->PublishSnapshot();
+    REQUIRE(player->snapshot() != snapshot);
+    REQUIRE(player->snapshot()->neurons_ == snapshot->neurons_);
+    REQUIRE(player->snapshot()->technologies_ == snapshot->technologies_);
+    // Adding a neuron only replaces neurons.
+    auto pos = field->FindFree(player->GetOneNucleus(), 1, 3);
+    player->AddNeuron(pos, SYNAPSE);
+    player->PublishSnapshot();
+    REQUIRE(player->snapshot()->neurons_ != snapshot->neurons_);
+    REQUIRE(player->snapshot()->GetNeuronTypeAtPosition(pos) == SYNAPSE);
+    REQUIRE(player->snapshot()->technologies_ == snapshot->technologies_);
+    // Old snapshot stays unchanged for readers still holding it.
+    REQUIRE(snapshot->GetNeuronTypeAtPosition(pos) == -1);
+    // Changing a neuron replaces neurons.
+    auto neurons = player->snapshot()->neurons_;
+    player->SetBlockForNeuron(pos, true);
+    player->PublishSnapshot();
+    REQUIRE(player->snapshot()->neurons_ != neurons);
+    REQUIRE(player->snapshot()->IsNeuronBlocked(pos));
+  }
 }
 
@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include "constants/codes.h"
+#include "game/field.h"
+#include "game/game.h"
+#include "player/player.h"
+#include "random/random.h"
+#include "render/renderer.h"
+
+TEST_CASE("test_renderer", "[renderer]") {
+
+  SECTION("test FramebufferRenderer") {
+    FramebufferRenderer renderer(10, 20);
+    REQUIRE(renderer.lines() == 10);
+    REQUIRE(renderer.cols() == 20);
+
+    SECTION("test utf-8 symbols take one cell each") {
+      renderer.SetColor(COLOR_ERROR);
+      renderer.AddStr(2, 3, SYMBOL_DEN + std::string("ab") + SYMBOL_HILL);
+      REQUIRE(renderer.At(2, 3) == SYMBOL_DEN);
+      REQUIRE(renderer.At(2, 4) == "a");
+      REQUIRE(renderer.At(2, 5) == "b");
+      REQUIRE(renderer.At(2, 6) == SYMBOL_HILL);
+      REQUIRE(renderer.ColorAt(2, 3) == COLOR_ERROR);
+      REQUIRE(renderer.ColorAt(2, 7) == 0);
+    }
+
+    SECTION("test output outside of framebuffer is ignored") {
+      renderer.AddStr(10, 0, "x");
+      renderer.AddStr(0, 18, "xyz");
+      REQUIRE(renderer.At(10, 0) == "");
+      REQUIRE(renderer.At(0, 19) == "y");
+      renderer.Clear();
+      REQUIRE(renderer.Line(0) == std::string(20, ' '));
+    }
+
+    SECTION("test input queue") {
+      renderer.PushInput('a');
+      renderer.PushInput('b');
+      REQUIRE(renderer.GetCh() == 'a');
+      REQUIRE(renderer.GetCh() == 'b');
+      REQUIRE(renderer.GetCh() == -1);
+    }
+  }
+
+  SECTION("test PrintField to framebuffer") {
+    RandomGenerator* ran_gen = new RandomGenerator();
+    Field* field = new Field(30, 40, ran_gen);
+    position_t nucleus_pos_1 = field->AddNucleus(8);
+    position_t nucleus_pos_2 = field->AddNucleus(1);
+    field->BuildGraph(nucleus_pos_1, nucleus_pos_2);
+    Player* player_one = new Player(nucleus_pos_1, field, ran_gen, field->AddResources(nucleus_pos_1));
+    Player* player_two = new Player(nucleus_pos_2, field, ran_gen, field->AddResources(nucleus_pos_2));
+    player_one->set_enemy(player_two);
+    player_two->set_enemy(player_one);
+
+    FramebufferRenderer renderer(50, 100);
+    field->PrintField(*player_one->snapshot(), *player_two->snapshot(), &renderer);
+    for (const auto& pos : {nucleus_pos_1, nucleus_pos_2}) {
+      REQUIRE(renderer.At(15+pos.first, 2*pos.second) == SYMBOL_DEN);
+      REQUIRE(renderer.At(15+pos.first, 2*pos.second+1) == " ");
+    }
+    // Every field position is printed.
+    for (int l=0; l<field->lines(); l++)
+      for (int c=0; c<field->cols(); c++)
+        REQUIRE(renderer.At(15+l, 2*c) == field->GetSymbolAtPos({l, c}));
+    delete player_one;
+    delete player_two;
+  }
+
+  SECTION("test game without input ends") {
+    std::filesystem::create_directories("test/game_base/settings");
+    std::ofstream("test/game_base/settings/music_paths.json") << "[]";
+    std::ofstream("test/game_base/settings/recently_played.json") << "[]";
+    // Terminal too small: game is quit.
+    NullRenderer null_renderer(10, 20);
+    Game(40, 74, 0, "test/game_base", &null_renderer).play();
+    // Welcome text is skipped, no song is selected.
+    FramebufferRenderer renderer(80, 200);
+    Game(40, 74, 0, "test/game_base", &renderer).play();
+    std::filesystem::remove_all("test/game_base");
+  }
+}
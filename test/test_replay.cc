@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include "audio/audio.h"
+#include "game/match.h"
+#include "game/replay.h"
+#include "game/simulation.h"
+#include "objects/units.h"
+#include "testing_utils.h"
+
+TEST_CASE("test_replay", "[replay]") {
+  Audio audio("");
+  t_utils::SetUpSong(audio);
+
+  SECTION("analysis hash detects changed analysis") {
+    auto hash = Replay::HashAnalysis(audio.analysed_data());
+    REQUIRE(hash == Replay::HashAnalysis(audio.analysed_data()));
+    audio.analysed_data().data_per_beat_.back().level_++;
+    REQUIRE(hash != Replay::HashAnalysis(audio.analysed_data()));
+  }
+
+  SECTION("replay is stored and loaded") {
+    Replay replay = {"song.mp3", Replay::HashAnalysis(audio.analysed_data()), 42, 40, 74, 
+      {{0, Command(DISTRIBUTE_IRON, {-1, -1}, Resources::OXYGEN)}, {17, Command(RESET_WAY, {1, 2}, -1, {3, 4})}}};
+    replay.Save("test/replays/test_replay.json");
+    Replay loaded = Replay::Load("test/replays/test_replay.json");
+    REQUIRE(loaded.song_ == replay.song_);
+    REQUIRE(loaded.analysis_hash_ == replay.analysis_hash_);
+    REQUIRE(loaded.seed_ == 42);
+    REQUIRE(loaded.commands_.size() == 2);
+    REQUIRE(loaded.commands_[1].first == 17);
+    REQUIRE(loaded.commands_[1].second.pos_ == position_t{1, 2});
+    REQUIRE(loaded.commands_[1].second.target_ == position_t{3, 4});
+    std::filesystem::remove_all("test/replays");
+  }
+
+  SECTION("re-running commands leads to same match") {
+    // Record: commands executed between ticks.
+    Match match = CreateMatch(&audio, 40, 74, 0, 42);
+    match.simulation_->Execute(Command(INCREASE_RESOURCES, {-1, -1}, 50));
+    match.simulation_->Execute(Command(DISTRIBUTE_IRON, {-1, -1}, Resources::OXYGEN));
+    for (int i=0; i<300; i++)
+      match.simulation_->Tick();
+    auto pos = match.field_->FindFree(match.player_one_->GetOneNucleus(), 1, 3);
+    match.simulation_->Execute(Command(ADD_NEURON, pos, UnitsTech::ACTIVATEDNEURON));
+    match.simulation_->RunToEnd();
+
+    // Replay: commands scheduled before their ticks.
+    Match replayed = CreateMatch(&audio, 40, 74, 0, 42);
+    replayed.simulation_->ScheduleCommands(match.simulation_->commands());
+    replayed.simulation_->RunToEnd();
+
+    REQUIRE(replayed.simulation_->tick() == match.simulation_->tick());
+    REQUIRE(replayed.player_one_->GetCurrentResources() == match.player_one_->GetCurrentResources());
+    REQUIRE(replayed.player_two_->GetCurrentResources() == match.player_two_->GetCurrentResources());
+    REQUIRE(replayed.player_one_->GetAllPositionsOfNeurons() == match.player_one_->GetAllPositionsOfNeurons());
+    REQUIRE(replayed.player_two_->GetAllPositionsOfNeurons() == match.player_two_->GetAllPositionsOfNeurons());
+    REQUIRE(replayed.player_two_->GetNucleusLive() == match.player_two_->GetNucleusLive());
+  }
+
+  SECTION("resigned match ends at same tick when replayed") {
+    Match match = CreateMatch(&audio, 40, 74, 0, 42);
+    for (int i=0; i<300; i++)
+      match.simulation_->Tick();
+    REQUIRE(match.simulation_->Execute(Command(RESIGN)));
+    REQUIRE(match.simulation_->Finished());
+    // No further ticks are played.
+    match.simulation_->Tick();
+    match.simulation_->RunToEnd();
+    REQUIRE(match.simulation_->tick() == 300);
+    REQUIRE(GetMatchResult(match)["winner"] == "player_two");
+
+    Match replayed = CreateMatch(&audio, 40, 74, 0, 42);
+    replayed.simulation_->ScheduleCommands(match.simulation_->commands());
+    replayed.simulation_->RunToEnd();
+    REQUIRE(replayed.simulation_->resigned());
+    REQUIRE(replayed.simulation_->tick() == match.simulation_->tick());
+    REQUIRE(GetMatchResult(replayed)["winner"] == GetMatchResult(match)["winner"]);
+    REQUIRE(replayed.player_two_->GetCurrentResources() == match.player_two_->GetCurrentResources());
+  }
+}
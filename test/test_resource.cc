@@ -0,0 +1,74 @@
+#include <array>
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "constants/codes.h"
+#include "constants/costs.h"
+#include "objects/resource.h"
+
+TEST_CASE("test_resource_table", "[resource]") {
+  ResourceTable resources;
+  resources.Set(Resources::IRON, 3, 22, 2, true, {-1, -1});
+  resources.Set(Resources::OXYGEN, 5.5, 100, 2, false, {1, 2});
+  resources.Set(Resources::POTASSIUM, 0, 100, 3, false, {3, 4});
+  resources.Set(Resources::CHLORIDE, 0, 100, 0, false, {5, 6});
+
+  SECTION("views write through to table") {
+    Resource oxygen = resources.at(Resources::OXYGEN);
+    oxygen.set_bound(4);
+    REQUIRE(resources.at(Resources::OXYGEN).bound() == 4);
+    REQUIRE(resources.at(Resources::OXYGEN).pos() == position_t{1, 2});
+    REQUIRE(resources.at(Resources::OXYGEN).Active());
+    REQUIRE(!resources.at(Resources::CHLORIDE).Active());
+    REQUIRE_THROWS_AS(resources.at(NUM_RESOURCES), std::out_of_range);
+  }
+
+  SECTION("const tables only give read-only views") {
+    static_assert(std::is_same_v<decltype(std::declval<const ResourceTable&>().at(0)), ConstResource>);
+    const ResourceTable& snapshot = resources;
+    ConstResource oxygen = snapshot.at(Resources::OXYGEN);
+    resources.at(Resources::OXYGEN).set_cur(7);
+    REQUIRE(oxygen.cur() == 7);
+    REQUIRE(snapshot.at(Resources::IRON).Print() == resources.at(Resources::IRON).Print());
+    REQUIRE_THROWS_AS(snapshot.at(NUM_RESOURCES), std::out_of_range);
+  }
+
+  SECTION("increase matches formular and skips inactive or blocked resources") {
+    resources.at(Resources::OXYGEN).set_bound(10);
+    resources.at(Resources::POTASSIUM).set_blocked(true);
+    double gain = 1.5;
+    double slowdown = 3;
+    double expected = ((1+2.0/10) * gain * (1-(5.5+10)/100))/slowdown;
+    resources.Increase(gain, slowdown, false);
+    REQUIRE(resources.at(Resources::OXYGEN).cur() == Approx(5.5 + expected));
+    REQUIRE(resources.at(Resources::POTASSIUM).cur() == 0);
+    REQUIRE(resources.at(Resources::CHLORIDE).cur() == 0);
+    REQUIRE(resources.at(Resources::IRON).cur() == 3);  // iron only increased if requested.
+    resources.Increase(10, slowdown, true);  // iron only availible as whole numbers.
+    REQUIRE(resources.at(Resources::IRON).cur() > 3);
+  }
+
+  SECTION("missing resources as bitmask") {
+    std::array<double, NUM_RESOURCES> costs = {};
+    costs[Resources::OXYGEN] = 5;
+    REQUIRE(resources.Missing(costs) == 0);
+    REQUIRE(resources.Missing(costs, 2) == (1u << Resources::OXYGEN));
+    costs[Resources::IRON] = 3.5;  // iron only counts whole numbers.
+    costs[Resources::CHLORIDE] = 1;
+    REQUIRE(resources.Missing(costs) == ((1u << Resources::IRON) | (1u << Resources::CHLORIDE)));
+  }
+
+  SECTION("taking costs of unit") {
+    resources.Set(Resources::DOPAMINE, 40, 70, 0, false, {7, 8});
+    const auto& costs = costs::CostsOf<UnitsTech::WAY>();
+    REQUIRE(resources.Missing(costs) == 0);
+    resources.Take(costs, 2, false);
+    REQUIRE(resources.at(Resources::IRON).cur() == 1);
+    REQUIRE(resources.at(Resources::DOPAMINE).cur() == Approx(40 - 2*costs::Cost<UnitsTech::WAY, Resources::DOPAMINE>()));
+    REQUIRE(resources.at(Resources::DOPAMINE).bound() == 0);
+    resources.Take(costs::CostsOf(UnitsTech::SYNAPSE), 1, true);
+    REQUIRE(resources.at(Resources::OXYGEN).bound() == Approx(costs::Cost<UnitsTech::SYNAPSE, Resources::OXYGEN>()));
+    REQUIRE_THROWS_AS(costs::CostsOf(NUM_UNITS_TECH), std::out_of_range);
+  }
+}
@@ -0,0 +1,41 @@
+#include <catch2/catch.hpp>
+#include <thread>
+#include "game/scheduler.h"
+
+TEST_CASE("test_scheduler", "[scheduler]") {
+  Scheduler scheduler;
+  scheduler.Start();
+
+  SECTION("test due timers are returned in one wake-up") {
+    scheduler.Schedule(0, 10);
+    scheduler.Schedule(1, 10);
+    scheduler.Schedule(2, 10000);
+    auto due = scheduler.WaitForDue({0, 1, 2});
+    REQUIRE(due.size() == 2);
+    REQUIRE(scheduler.GameTime() >= 10);
+    // Already returned timers are removed.
+    scheduler.Schedule(3, 20);
+    due = scheduler.WaitForDue({0, 1, 3});
+    REQUIRE(due == std::vector<int>({3}));
+  }
+
+  SECTION("test game-time does not advance while paused") {
+    scheduler.set_pause(true);
+    double game_time = scheduler.GameTime();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(scheduler.GameTime() == game_time);
+    scheduler.set_pause(false);
+    REQUIRE(scheduler.GameTime() < game_time + 20);
+  }
+
+  SECTION("test stop wakes up waiting threads") {
+    scheduler.Schedule(0, 100000);
+    std::thread stopper([&scheduler]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        scheduler.Stop();
+      });
+    REQUIRE(scheduler.WaitForDue({0}).size() == 0);
+    REQUIRE(scheduler.SleepFor(100000) == false);
+    stopper.join();
+  }
+}
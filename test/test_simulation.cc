@@ -0,0 +1,167 @@
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include "audio/audio.h"
+#include "game/field.h"
+#include "game/match.h"
+#include "game/simulation.h"
+#include "game/tournament.h"
+#include "objects/units.h"
+#include "player/player.h"
+#include "random/random.h"
+#include "testing_utils.h"
+
+TEST_CASE("test_simulation", "[simulation]") {
+  RandomGenerator* ran_gen = new RandomGenerator();
+  Field* field = nullptr;
+  auto [player_one, player_two] = t_utils::SetUpPlayers(&field, ran_gen);
+
+  // Song of four beats (every 500ms, 120bpm).
+  Audio audio("");
+  for (int i=0; i<4; i++)
+    audio.analysed_data().data_per_beat_.push_back({i*500.0, 120, 50, {}, 0});
+  Simulation simulation(&audio, field, player_one, player_two, {});
+
+  SECTION("game-time is derived from ticks only") {
+    REQUIRE(simulation.tick() == 0);
+    REQUIRE(simulation.GameTime() == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(simulation.GameTime() == 0);
+    for (int i=0; i<10; i++)
+      simulation.Tick();
+    REQUIRE(simulation.tick() == 10);
+    REQUIRE(simulation.GameTime() == 10*TICK_MS);
+    REQUIRE(player_one->game_time() == 9*TICK_MS);
+  }
+
+  SECTION("simulation ends with last beat") {
+    simulation.RunToEnd();
+    REQUIRE(simulation.Finished());
+    REQUIRE(simulation.played_levels().size() == 4);
+    REQUIRE(simulation.tick() == 1500/TICK_MS+1);
+  }
+
+  SECTION("potentials move by ticks, not by real time") {
+    // Gain iron, activate each resource and gain resources.
+    REQUIRE(simulation.Execute(Command(INCREASE_RESOURCES, {-1, -1}, 100)));
+    for (int i=Resources::IRON; i<Resources::SEROTONIN; i++)
+      for (int counter=0; counter<3; counter++)
+        simulation.Execute(Command(DISTRIBUTE_IRON, {-1, -1}, i));
+    REQUIRE(simulation.Execute(Command(INCREASE_RESOURCES, {-1, -1}, 100)));
+    auto pos = field->FindFree(player_one->GetOneNucleus(), 1, 3);
+    REQUIRE(simulation.Execute(Command(ADD_NEURON, pos, UnitsTech::SYNAPSE)));
+    REQUIRE(simulation.Execute(Command(ADD_POTENTIAL, pos, UnitsTech::EPSP)));
+    auto start = player_one->potential().begin()->pos_;
+
+    // Epsp needs more than 370ms (game-time) for one step.
+    for (int i=0; i<30; i++)
+      simulation.Tick();
+    REQUIRE(player_one->potential().begin()->pos_ == start);
+    for (int i=0; i<20; i++)
+      simulation.Tick();
+    REQUIRE(player_one->potential().begin()->pos_ != start);
+  }
+
+  SECTION("submitted commands are applied with next tick") {
+    // Commands of several threads are applied in order submitted per thread.
+    std::vector<std::thread> threads;
+    for (int i=0; i<4; i++)
+      threads.emplace_back([&simulation]() { simulation.Submit(Command(INCREASE_RESOURCES, {-1, -1}, 1)); });
+    for (auto& thread : threads)
+      thread.join();
+    REQUIRE(simulation.commands().size() == 0);
+    auto iron = player_one->resources().at(Resources::IRON).cur();
+    simulation.Tick();
+    REQUIRE(simulation.commands().size() == 4);
+    REQUIRE(simulation.commands().front().first == 0);
+    REQUIRE(player_one->resources().at(Resources::IRON).cur() > iron);
+  }
+
+  SECTION("snapshot shows neurons built") {
+    REQUIRE(simulation.Execute(Command(INCREASE_RESOURCES, {-1, -1}, 100)));
+    for (int i=Resources::IRON; i<Resources::SEROTONIN; i++)
+      for (int counter=0; counter<3; counter++)
+        simulation.Execute(Command(DISTRIBUTE_IRON, {-1, -1}, i));
+    REQUIRE(simulation.Execute(Command(INCREASE_RESOURCES, {-1, -1}, 100)));
+    auto pos = field->FindFree(player_one->GetOneNucleus(), 1, 3);
+    REQUIRE(simulation.Execute(Command(ADD_NEURON, pos, UnitsTech::SYNAPSE)));
+    REQUIRE(player_one->snapshot()->GetNeuronTypeAtPosition(pos) == -1);
+    player_one->PublishSnapshot();
+    auto snapshot = player_one->snapshot();
+    REQUIRE(snapshot->GetNeuronTypeAtPosition(pos) == UnitsTech::SYNAPSE);
+    REQUIRE(snapshot->GetAllPositionsOfNeurons(UnitsTech::SYNAPSE) == std::vector<position_t>{pos});
+    REQUIRE(snapshot->GetOneNucleus() == player_one->GetOneNucleus());
+    REQUIRE(snapshot->GetNucleusLive() == player_one->GetNucleusLive());
+    REQUIRE(snapshot->GetOptionsForSynapes(pos).size() == 5);
+    REQUIRE(snapshot->GetMissingResources(UnitsTech::EPSP) == player_one->GetMissingResources(UnitsTech::EPSP));
+  }
+
+  SECTION("invalid commands fail") {
+    REQUIRE(!simulation.Execute(Command(ADD_POTENTIAL, {-1, -1}, UnitsTech::EPSP)));
+    REQUIRE(!simulation.Execute(Command(RESET_WAY, {-1, -1}, -1, {0, 0})));
+  }
+}
+
+TEST_CASE("test_ki_against_ki", "[simulation]") {
+  Audio audio("");
+  t_utils::SetUpSong(audio, 360);
+  Match match = CreateMatch(&audio, 40, 74, 0, 42, true);
+  match.simulation_->RunToEnd();
+  auto result = GetMatchResult(match);
+  REQUIRE(result["ticks"] == match.simulation_->tick());
+  REQUIRE(result["winner"].is_string());
+  REQUIRE(result["units_built"]["player_one"].size() > 0);
+  REQUIRE(result["units_built"]["player_two"].size() > 0);
+  REQUIRE(result["phases_ms"].contains("move"));
+
+  // Songs without beats can't be played.
+  Audio empty_audio("");
+  REQUIRE_THROWS_AS(CreateMatch(&empty_audio, 40, 74, 0, 42, true), std::invalid_argument);
+}
+
+TEST_CASE("test_tournament", "[simulation]") {
+  Audio audio("");
+  t_utils::SetUpSong(audio, 120);
+  std::map<std::string, Audio*> songs = {{"song", &audio}};
+  std::vector<unsigned int> seeds = {1, 2, 3, 4};
+  auto result = RunTournament(songs, seeds, 4);
+  REQUIRE(result["matches"] == 4);
+  REQUIRE(result["errors"] == 0);
+  REQUIRE(result["results"].size() == 4);
+  REQUIRE(result["songs"]["song"]["matches"] == 4);
+  REQUIRE(result["ticks"]["min"] <= result["ticks"]["median"]);
+  REQUIRE(result["ticks"]["median"] <= result["ticks"]["max"]);
+
+  // Matches are independent: results don't depend on number of threads.
+  auto serial_result = RunTournament(songs, seeds, 1);
+  for (size_t i=0; i<seeds.size(); i++) {
+    REQUIRE(result["results"][i]["seed"] == serial_result["results"][i]["seed"]);
+    REQUIRE(result["results"][i]["ticks"] == serial_result["results"][i]["ticks"]);
+    REQUIRE(result["results"][i]["winner"] == serial_result["results"][i]["winner"]);
+    REQUIRE(result["results"][i]["units_built"] == serial_result["results"][i]["units_built"]);
+  }
+
+  // Songs which could not be analysed are recorded as failed matches.
+  auto with_errors = RunTournament(songs, {1, 2}, 2, {{"missing.mp3", "Could not load audio-source"}});
+  REQUIRE(with_errors["matches"] == 2);
+  REQUIRE(with_errors["errors"] == 2);
+  REQUIRE(with_errors["results"].size() == 4);
+  REQUIRE(with_errors["results"][3]["song"] == "missing.mp3");
+  REQUIRE(with_errors["results"][3]["error"] == "Could not load audio-source");
+
+  // Matches only log to log-file: nothing is mixed into stdout (where json of tournament is printed).
+  std::fflush(stdout);
+  int stdout_fd = dup(fileno(stdout));
+  FILE* captured = std::tmpfile();
+  dup2(fileno(captured), fileno(stdout));
+  RunTournament(songs, seeds, 4);
+  std::fflush(stdout);
+  dup2(stdout_fd, fileno(stdout));
+  close(stdout_fd);
+  std::fseek(captured, 0, SEEK_END);
+  REQUIRE(std::ftell(captured) == 0);
+  std::fclose(captured);
+}
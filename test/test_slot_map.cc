@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "utils/slot_map.h"
+
+TEST_CASE("test_slot_map", "[slot_map]") {
+  SlotMap<int> slot_map;
+  SlotHandle a = slot_map.Insert(1);
+  SlotHandle b = slot_map.Insert(2);
+  SlotHandle c = slot_map.Insert(3);
+  REQUIRE(slot_map.size() == 3);
+  REQUIRE(slot_map.at(b) == 2);
+  REQUIRE(!SlotHandle().valid());
+  REQUIRE(!slot_map.Contains(SlotHandle()));
+
+  SECTION("test erase keeps other handles valid") {
+    REQUIRE(slot_map.Erase(a));
+    REQUIRE(!slot_map.Erase(a));
+    REQUIRE(slot_map.size() == 2);
+    REQUIRE(!slot_map.Contains(a));
+    REQUIRE_THROWS_AS(slot_map.at(a), std::out_of_range);
+    REQUIRE(slot_map.at(b) == 2);
+    REQUIRE(slot_map.at(c) == 3);
+    // Elements are stored densely.
+    std::vector<int> values(slot_map.begin(), slot_map.end());
+    std::sort(values.begin(), values.end());
+    REQUIRE(values == std::vector<int>{2, 3});
+  }
+
+  SECTION("test reused slot does not revive old handle") {
+    slot_map.Erase(b);
+    SlotHandle d = slot_map.Insert(4);
+    REQUIRE(d.index_ == b.index_);
+    REQUIRE(d != b);
+    REQUIRE(!slot_map.Contains(b));
+    REQUIRE(slot_map.at(d) == 4);
+  }
+
+  SECTION("test handle of dense index") {
+    slot_map.Erase(a);
+    for (size_t i=0; i<slot_map.size(); i++)
+      REQUIRE(slot_map.at(slot_map.handle(i)) == slot_map.values()[i]);
+    int sum = 0;
+    slot_map.ForEach([&](SlotHandle handle, int& value) { 
+        REQUIRE(slot_map.Contains(handle));
+        sum += value; 
+      });
+    REQUIRE(sum == 5);
+  }
+}
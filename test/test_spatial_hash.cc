@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+#include <set>
+#include <vector>
+#include "random/random.h"
+#include "utils/geometry.h"
+#include "utils/spatial_hash.h"
+
+using geometry::position_t;
+
+TEST_CASE("test_spatial_hash", "[spatial_hash]") {
+  RandomGenerator ran_gen;
+  int lines = ran_gen.RandomInt(10, 60);
+  int cols = ran_gen.RandomInt(10, 60);
+  std::vector<position_t> positions;
+  for (int i=0; i<200; i++)
+    positions.push_back({ran_gen.RandomInt(0, lines-1), ran_gen.RandomInt(0, cols-1)});
+  SpatialHash spatial_hash(lines, cols, 3);
+  spatial_hash.Build(positions);
+  REQUIRE(spatial_hash.size() == positions.size());
+
+  SECTION("test range query matches brute force") {
+    for (int i=0; i<50; i++) {
+      position_t pos = {ran_gen.RandomInt(0, lines-1), ran_gen.RandomInt(0, cols-1)};
+      int range = ran_gen.RandomInt(1, 7);
+      std::set<uint32_t> expected;
+      for (uint32_t j=0; j<positions.size(); j++)
+        if (geometry::DistSq(pos, positions[j]) < range*range)
+          expected.insert(j);
+      std::set<uint32_t> found;
+      spatial_hash.ForEachInRange(pos, range, [&](uint32_t index) { 
+          found.insert(index); 
+          return true; 
+        });
+      REQUIRE(found == expected);
+    }
+  }
+
+  SECTION("test query stops when function returns false") {
+    int calls = 0;
+    spatial_hash.ForEachInRange({lines/2, cols/2}, 100, [&](uint32_t) { return ++calls < 5; });
+    REQUIRE(calls == 5);
+  }
+}
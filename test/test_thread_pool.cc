@@ -0,0 +1,50 @@
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <vector>
+#include "utils/thread_pool.h"
+
+TEST_CASE("test_thread_pool", "[thread_pool]") {
+  ThreadPool pool(4);
+  REQUIRE(pool.size() == 4);
+
+  SECTION("all jobs are run") {
+    std::vector<int> results(1000, 0);
+    for (size_t i=0; i<results.size(); i++)
+      pool.Submit([&results, i]() { results[i] = i*2; });
+    pool.Wait();
+    for (size_t i=0; i<results.size(); i++)
+      REQUIRE(results[i] == (int)i*2);
+  }
+
+  SECTION("wait includes jobs submitted by jobs") {
+    std::atomic<int> counter = 0;
+    for (int i=0; i<10; i++) {
+      pool.Submit([&pool, &counter]() {
+        for (int j=0; j<10; j++)
+          pool.Submit([&counter]() { counter++; });
+        counter++;
+      });
+    }
+    pool.Wait();
+    REQUIRE(counter == 110);
+  }
+
+  SECTION("pool can be reused after wait") {
+    std::atomic<int> counter = 0;
+    pool.Submit([&counter]() { counter++; });
+    pool.Wait();
+    pool.Submit([&counter]() { counter++; });
+    pool.Wait();
+    REQUIRE(counter == 2);
+  }
+}
+
+TEST_CASE("test_thread_pool_destructor_runs_remaining_jobs", "[thread_pool]") {
+  std::atomic<int> counter = 0;
+  {
+    ThreadPool pool(2);
+    for (int i=0; i<100; i++)
+      pool.Submit([&counter]() { counter++; });
+  }
+  REQUIRE(counter == 100);
+}
@@ -0,0 +1,26 @@
+#include <catch2/catch.hpp>
+#include "utils/union_find.h"
+
+TEST_CASE("test_union_find", "[union_find]") {
+  UnionFind union_find(10);
+  REQUIRE(union_find.size() == 10);
+  REQUIRE(!union_find.Connected(1, 2));
+
+  SECTION("test union merges sets") {
+    REQUIRE(union_find.Union(1, 2));
+    REQUIRE(union_find.Union(3, 4));
+    REQUIRE(!union_find.Connected(2, 3));
+    REQUIRE(union_find.Union(2, 4));
+    REQUIRE(!union_find.Union(1, 3));
+    REQUIRE(union_find.Connected(1, 3));
+    REQUIRE(union_find.SizeOfSet(4) == 4);
+    REQUIRE(union_find.SizeOfSet(5) == 1);
+  }
+
+  SECTION("test chain") {
+    for (uint32_t i=1; i<10; i++)
+      union_find.Union(i-1, i);
+    REQUIRE(union_find.Connected(0, 9));
+    REQUIRE(union_find.SizeOfSet(0) == 10);
+  }
+}
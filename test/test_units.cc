@@ -1,20 +1,90 @@
 #include <iostream>
 #include <catch2/catch.hpp>
 #include <memory>
+#include <set>
+#include <stdexcept>
+#include "objects/neuron_store.h"
 #include "objects/units.h"
 #include "constants/codes.h"
 
 TEST_CASE("calling getting way has target included", "[units]") {
-  std::map<position_t, std::shared_ptr<Neuron>> neurons;
   position_t pos = {1, 1};
   position_t epsp_target = {2,2};
   position_t ipsp_target = {2,2};
-  neurons[pos] = std::make_shared<Synapse>(pos, 0, 0, epsp_target, ipsp_target);
+  Synapse synapse(pos, 0, 0, epsp_target, ipsp_target);
 
-  auto way_to_epsp_target = neurons[pos]->GetWayPoints(UnitsTech::EPSP);
+  auto way_to_epsp_target = synapse.GetWayPoints(UnitsTech::EPSP);
   REQUIRE(way_to_epsp_target.size() == 1);
   REQUIRE(way_to_epsp_target.front() == epsp_target);
-  auto way_to_ipsp_target = neurons[pos]->GetWayPoints(UnitsTech::IPSP);
+  auto way_to_ipsp_target = synapse.GetWayPoints(UnitsTech::IPSP);
   REQUIRE(way_to_ipsp_target.size() == 1);
   REQUIRE(way_to_ipsp_target.front() == ipsp_target);
 }
+
+TEST_CASE("neurons are stored per type and found by position", "[units]") {
+  NeuronStore neurons;
+  neurons.Add(Nucleus({1, 1}));
+  neurons.Add(Synapse({2, 2}, 1, 0, {-1, -1}, {-1, -1}));
+  neurons.Add(ActivatedNeuron({3, 3}, 0, 0, 0));
+  neurons.Add(ActivatedNeuron({4, 4}, 0, 0, 0));
+  REQUIRE(neurons.size() == 4);
+  REQUIRE(neurons.activated_neurons().size() == 2);
+  REQUIRE(neurons.TypeAt({2, 2}) == UnitsTech::SYNAPSE);
+  REQUIRE(neurons.TypeAt({5, 5}) == -1);
+  REQUIRE(neurons.Get<Synapse>({2, 2}) != nullptr);
+  REQUIRE(neurons.Get<Synapse>({3, 3}) == nullptr);
+  REQUIRE_THROWS_AS(neurons.at({5, 5}), std::out_of_range);
+
+  SECTION("components are changed in place") {
+    neurons.at({4, 4}).set_blocked(true);
+    REQUIRE(neurons.Get<ActivatedNeuron>({4, 4})->blocked());
+    REQUIRE(!neurons.Get<ActivatedNeuron>({3, 3})->blocked());
+  }
+
+  SECTION("erasing keeps other neurons of same type") {
+    neurons.at({4, 4}).IncreaseVoltage(1);
+    REQUIRE(neurons.Erase({3, 3}));
+    REQUIRE(!neurons.Erase({3, 3}));
+    REQUIRE(neurons.activated_neurons().size() == 1);
+    REQUIRE(neurons.at({4, 4}).voltage() == 1);
+    REQUIRE(neurons.Get<ActivatedNeuron>({4, 4})->pos_ == position_t{4, 4});
+  }
+
+  SECTION("adding at same position replaces neuron") {
+    neurons.Add(Nucleus({2, 2}));
+    REQUIRE(neurons.size() == 4);
+    REQUIRE(neurons.synapses().size() == 0);
+    REQUIRE(neurons.nuclei().size() == 2);
+    REQUIRE(neurons.Count(UnitsTech::SYNAPSE) == 0);
+    REQUIRE(neurons.positions(UnitsTech::NUCLEUS) == std::set<position_t>{{1, 1}, {2, 2}});
+  }
+
+  SECTION("positions per type are kept up to date") {
+    REQUIRE(neurons.Count() == 4);
+    REQUIRE(neurons.Count(UnitsTech::ACTIVATEDNEURON) == 2);
+    neurons.Erase({3, 3});
+    REQUIRE(neurons.positions(UnitsTech::ACTIVATEDNEURON) == std::set<position_t>{{4, 4}});
+    REQUIRE(neurons.PositionByIndex({UnitsTech::NUCLEUS, UnitsTech::ACTIVATEDNEURON}, 1) == position_t{4, 4});
+    REQUIRE_THROWS_AS(neurons.PositionByIndex({UnitsTech::NUCLEUS}, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(neurons.positions(UnitsTech::EPSP), std::out_of_range);
+  }
+}
+
+TEST_CASE("potentials share way but keep own position on way", "[units]") {
+  path_t way = std::make_shared<const std::vector<position_t>>(std::vector<position_t>{{1, 1}, {1, 2}, {1, 3}});
+  Epsp epsp_1({1, 1}, way, 0, 0);
+  Epsp epsp_2({1, 1}, way, 0, 0);
+  REQUIRE(way.use_count() == 3);
+
+  epsp_1.Step();
+  epsp_1.Step();
+  REQUIRE(epsp_1.pos_ == position_t{1, 2});
+  REQUIRE(epsp_1.Way().size() == 1);
+  REQUIRE(epsp_2.Way().size() == 3);
+  epsp_1.Step();
+  REQUIRE(epsp_1.AtTarget());
+  REQUIRE(epsp_1.pos_ == position_t{1, 3});
+  REQUIRE_FALSE(epsp_2.AtTarget());
+  // Shared way is not modified.
+  REQUIRE(way->size() == 3);
+}
@@ -4,6 +4,7 @@
 #include <map>
 #include <list>
 #include <vector>
+#include "utils/logger.h"
 #include "utils/utils.h"
 
 TEST_CASE ("test_dist", "[utils]") {
@@ -80,3 +81,28 @@ TEST_CASE("erase from vector", "") {
   REQUIRE(vec.size() == size-1);
   REQUIRE(vec.front() == 2);
 }
+
+TEST_CASE("log levels per category", "[utils]") {
+  REQUIRE(utils::SetLogLevels("warn,player=debug"));
+  REQUIRE(utils::Logger(LOG_FIELD)->level() == spdlog::level::warn);
+  REQUIRE(utils::Logger(LOG_PLAYER)->level() == spdlog::level::debug);
+  REQUIRE(!utils::Logger(LOG_FIELD)->should_log(spdlog::level::info));
+
+  // Invalid entries are skipped.
+  REQUIRE(!utils::SetLogLevels("unknown=info,ki=loud,ki=info"));
+  REQUIRE(utils::Logger(LOG_KI)->level() == spdlog::level::info);
+
+  // Arguments are not evaluated, if level is disabled.
+  int evaluated = 0;
+  LOG_INFO(LOG_FIELD, "{}", ++evaluated);
+  REQUIRE(evaluated == 0);
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+  LOG_DEBUG(LOG_PLAYER, "{}", ++evaluated);
+  REQUIRE(evaluated == 1);
+#endif
+
+  // Messages without category are logged by game's logger (to log-file).
+  REQUIRE(spdlog::default_logger_raw() == utils::Logger(LOG_GAME));
+
+  REQUIRE(utils::SetLogLevels("debug"));  // as set up for tests.
+}
@@ -4,3 +4,32 @@ position_t t_utils::GetRandomPositionInField(Field* field, RandomGenerator* ran_
   return {ran_gen->RandomInt(5, field->cols()-5), ran_gen->RandomInt(5, field->lines()-5)};
 }
 
+std::pair<Player*, Player*> t_utils::SetUpPlayers(Field** field, RandomGenerator* ran_gen) {
+  *field = new Field(ran_gen->RandomInt(50, 150), ran_gen->RandomInt(50, 150), ran_gen);
+  position_t nucleus_pos_1 = (*field)->AddNucleus(8);
+  position_t nucleus_pos_2 = (*field)->AddNucleus(1);
+  (*field)->BuildGraph(nucleus_pos_1, nucleus_pos_2);
+  auto resource_positions_1 = (*field)->AddResources(nucleus_pos_1);
+  auto resource_positions_2 = (*field)->AddResources(nucleus_pos_2);
+  Player* player_one = new Player(nucleus_pos_1, *field, ran_gen, resource_positions_1);
+  Player* player_two = new Player(nucleus_pos_2, *field, ran_gen, resource_positions_2);
+  player_one->set_enemy(player_two);
+  player_two->set_enemy(player_one);
+  return {player_one, player_two};
+}
+
+void t_utils::SetUpSong(Audio& audio, int beats) {
+  Audio::Initialize();
+  auto& data = audio.analysed_data();
+  data.average_bpm_ = 120;
+  data.average_level_ = 50;
+  data.intervals_[0] = {0, "CMajor", 0, 0, true, 7, 0, 0};
+  std::vector<std::string> note_names = {"C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B"};
+  for (int i=0; i<beats; i++) {
+    int midi = 60 + (i*7)%12;
+    Note note = {static_cast<size_t>(midi), note_names[midi%12], static_cast<size_t>(midi%12), 
+      static_cast<size_t>(midi/12)};
+    data.data_per_beat_.push_back({i*500.0, 120, 30 + (i*13)%40, {note}, 0});
+  }
+}
+
@@ -1,6 +1,9 @@
 #ifndef TEST_TESTING_UTILS_H_
 #define TEST_TESTING_UTILS_H_
 
+#include <utility>
+
+#include "audio/audio.h"
 #include "game/field.h"
 #include "objects/units.h"
 #include "player/player.h"
@@ -8,6 +11,22 @@
 
 namespace t_utils {
   position_t GetRandomPositionInField(Field* field, RandomGenerator* ran_gen);
+
+  /**
+   * Creates field of random size (with graph and resources) and two players
+   * set as each others enemy.
+   * @param[out] field
+   * @param[in] ran_gen
+   * @return player one and player two.
+   */
+  std::pair<Player*, Player*> SetUpPlayers(Field** field, RandomGenerator* ran_gen);
+
+  /**
+   * Fills audio with analysed data of a song (120bpm).
+   * @param[out] audio
+   * @param[in] beats length of song.
+   */
+  void SetUpSong(Audio& audio, int beats=40);
 }
 
 #endif